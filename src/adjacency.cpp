@@ -0,0 +1,178 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <utility>
+#include "adjacency.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * Keeps the lists of an adjacency that built them itself.
+ */
+struct OwnedLists
+{
+  std::vector<std::uint32_t> starts;
+  std::vector<TileGrid::tile_id_t> neighbors;
+};
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Finds every pair of different tiles that touch on a grid.
+ *
+ * @param {TileGrid} grid Which tile is where.
+ * @returns {std::vector<Adjacency::border_t>} The pairs, some more than once.
+ */
+std::vector<Adjacency::border_t> find_borders(const TileGrid& grid);
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Adjacency::Adjacency(const TileGrid& grid, size_t num_tiles)
+  : Adjacency(num_tiles, find_borders(grid))
+{ }
+
+
+Adjacency::Adjacency(size_t num_tiles, std::vector<border_t> borders)
+  : num_tiles_(num_tiles)
+{
+  // Every border in both directions, once
+  size_t num_borders = borders.size();
+  for (size_t i = 0; i < num_borders; ++i)
+  {
+    borders.push_back(std::make_pair(borders[i].second, borders[i].first));
+  }
+  std::sort(std::begin(borders), std::end(borders));
+  borders.erase(
+    std::unique(std::begin(borders), std::end(borders))
+    , std::end(borders));
+
+  std::shared_ptr<OwnedLists> owned = std::make_shared<OwnedLists>();
+  owned->starts.assign(num_tiles + 1, 0);
+  owned->neighbors.reserve(borders.size());
+  for (const border_t& border : borders)
+  {
+    ++owned->starts[border.first + 1];
+    owned->neighbors.push_back(border.second);
+  }
+  for (size_t id = 0; id < num_tiles; ++id)
+  {
+    owned->starts[id + 1] += owned->starts[id];
+  }
+
+  starts_ = owned->starts.data();
+  neighbors_ = owned->neighbors.data();
+  owner_ = std::move(owned);
+}
+
+
+Adjacency::Adjacency(
+  size_t num_tiles
+  , const std::uint32_t* starts
+  , const tile_id_t* neighbors
+  , std::shared_ptr<const void> owner)
+  : num_tiles_(num_tiles)
+  , starts_(starts)
+  , neighbors_(neighbors)
+  , owner_(std::move(owner))
+{ }
+
+
+bool Adjacency::areAdjacent(size_t id1, size_t id2) const
+{
+  const tile_id_t* first = getNeighbors(id1);
+  const tile_id_t* last = first + getDegree(id1);
+
+  return std::binary_search(first, last, static_cast<tile_id_t> (id2));
+}
+
+
+bool Adjacency::isValid(size_t max_neighbors) const
+{
+  if (starts_[0] != 0 || starts_[num_tiles_] > max_neighbors) { return false; }
+
+  for (size_t id = 0; id < num_tiles_; ++id)
+  {
+    if (starts_[id + 1] < starts_[id]) { return false; }
+
+    for (std::uint32_t i = starts_[id]; i < starts_[id + 1]; ++i)
+    {
+      if (neighbors_[i] >= num_tiles_ || neighbors_[i] == id) { return false; }
+      if (i > starts_[id] && neighbors_[i] <= neighbors_[i - 1]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+
+Adjacency Adjacency::renumber(const std::vector<tile_id_t>& new_ids) const
+{
+  // Each border once, since the constructor adds the other direction
+  std::vector<border_t> borders;
+  borders.reserve(getNumNeighbors() / 2);
+  for (size_t id = 0; id < num_tiles_; ++id)
+  {
+    const tile_id_t* neighbors = getNeighbors(id);
+    for (size_t i = 0; i < getDegree(id); ++i)
+    {
+      if (neighbors[i] > id) {
+        borders.push_back(std::make_pair(new_ids[id], new_ids[neighbors[i]]));
+      }
+    }
+  }
+
+  return Adjacency(num_tiles_, std::move(borders));
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+std::vector<Adjacency::border_t> find_borders(const TileGrid& grid)
+{
+  size_t width = grid.getWidth();
+  size_t height = grid.getHeight();
+
+  std::vector<Adjacency::border_t> borders;
+  for (size_t y = 0; y < height; ++y)
+  {
+    for (size_t x = 0; x < width; ++x)
+    {
+      Tile::coord_t coord = y * width + x;
+      Adjacency::tile_id_t cur = grid.at(coord);
+      if (cur == TileGrid::NO_TILE) { continue; }
+
+      // Since we start in the upper left-hand corner, we only have to look
+      // down and to the right to see unchecked spaces
+      if (x + 1 < width) {
+        Adjacency::tile_id_t right = grid.at(coord + 1);
+        if (right != TileGrid::NO_TILE && right != cur) {
+          borders.push_back(std::make_pair(cur, right));
+        }
+      }
+      if (y + 1 < height) {
+        Adjacency::tile_id_t down = grid.at(coord + width);
+        if (down != TileGrid::NO_TILE && down != cur) {
+          borders.push_back(std::make_pair(cur, down));
+        }
+      }
+    }
+  }
+
+  return borders;
+}
@@ -0,0 +1,172 @@
+#ifndef ADJACENCY_H
+#define ADJACENCY_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+#include "tile_grid.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Which tiles border each other, stored as one sorted list of neighbors per
+ * tile, all packed into a single array. Finding a tile's neighbors costs as
+ * much as there are neighbors, rather than as much as there are tiles. Like
+ * the grid, it never changes once a board has been generated.
+ */
+class Adjacency
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    using tile_id_t = TileGrid::tile_id_t;
+    using border_t = std::pair<tile_id_t, tile_id_t>;
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    Adjacency() = default;
+
+    /**
+     * Finds which tiles touch on a grid.
+     *
+     * @param {TileGrid} grid Which tile is where.
+     * @param {size_t} num_tiles How many tiles there are.
+     */
+    Adjacency(const TileGrid& grid, size_t num_tiles);
+
+    /**
+     * Builds the neighbor lists from the borders between tiles, such as ones
+     * found while generating a board.
+     *
+     * @param {size_t} num_tiles How many tiles there are.
+     * @param {std::vector<border_t>} borders Pairs of tiles that touch, in
+     * either order. Repeats are ignored.
+     */
+    Adjacency(size_t num_tiles, std::vector<border_t> borders);
+
+    /**
+     * Uses neighbor lists that live somewhere else, such as in a mapped file,
+     * without copying them.
+     *
+     * @param {size_t} num_tiles How many tiles there are.
+     * @param {const std::uint32_t*} starts Where each tile's neighbors start,
+     * with one more entry at the end for where the last tile's neighbors end.
+     * @param {const tile_id_t*} neighbors Every tile's neighbors, in order.
+     * @param {std::shared_ptr<const void>} owner Keeps the lists alive for as
+     * long as this is.
+     */
+    Adjacency(
+      size_t num_tiles
+      , const std::uint32_t* starts
+      , const tile_id_t* neighbors
+      , std::shared_ptr<const void> owner);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    size_t getNumTiles() const { return num_tiles_; }
+
+    /**
+     * Returns how many neighbors there are over all tiles.
+     *
+     * @returns {size_t} The total number of neighbors, counting each border
+     * twice.
+     */
+    size_t getNumNeighbors() const { return starts_ ? starts_[num_tiles_] : 0; }
+
+    /**
+     * Returns the tiles bordering a tile, sorted by id.
+     *
+     * @param {size_t} id The tile.
+     * @returns {const tile_id_t*} The first neighbor. There are
+     * getDegree(id) of them.
+     */
+    const tile_id_t* getNeighbors(size_t id) const
+    {
+      return neighbors_ + starts_[id];
+    }
+
+    /**
+     * Returns how many tiles border a tile.
+     *
+     * @param {size_t} id The tile.
+     * @returns {size_t} The number of neighbors.
+     */
+    size_t getDegree(size_t id) const { return starts_[id + 1] - starts_[id]; }
+
+    /**
+     * Returns the raw lists, such as for saving them.
+     *
+     * @returns {const std::uint32_t*|const tile_id_t*} The starts or the
+     * neighbors, as given to the constructor.
+     */
+    const std::uint32_t* getStarts() const { return starts_; }
+    const tile_id_t* getAllNeighbors() const { return neighbors_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Checks if two tiles border each other.
+     *
+     * @param {size_t} id1 The first tile.
+     * @param {size_t} id2 The second tile.
+     * @returns {bool} True if they are adjacent.
+     */
+    bool areAdjacent(size_t id1, size_t id2) const;
+
+    /**
+     * Checks that the lists make sense, for lists that were loaded from a
+     * file.
+     *
+     * @param {size_t} max_neighbors How many neighbors the lists may hold.
+     * @returns {bool} True if every list is in order and only refers to tiles
+     * that exist.
+     */
+    bool isValid(size_t max_neighbors) const;
+
+    /**
+     * Gives every tile a new id.
+     *
+     * @param {std::vector<tile_id_t>} new_ids The new id of every tile,
+     * indexed by its old one. Every id must be used once.
+     * @returns {Adjacency} The same borders between the new ids.
+     */
+    Adjacency renumber(const std::vector<tile_id_t>& new_ids) const;
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    size_t num_tiles_ = 0;
+    const std::uint32_t* starts_ = nullptr;
+    const tile_id_t* neighbors_ = nullptr;
+
+    // Whatever the lists are stored in
+    std::shared_ptr<const void> owner_;
+
+};
+
+#endif
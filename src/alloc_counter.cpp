@@ -0,0 +1,26 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include "alloc_counter.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+bool AllocCounter::enabled_ = false;
+thread_local std::uint64_t AllocCounter::thread_count_ = 0;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+bool AllocCounter::enable()
+{
+  enabled_ = true;
+
+  return true;
+}
@@ -0,0 +1,106 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Counts how many times each thread allocates, so code that should not
+ * allocate can be checked. Counting only happens in programs built with
+ * alloc_hooks.cpp, which replaces operator new; everywhere else every count
+ * stays at zero and isEnabled says so.
+ */
+class AllocCounter
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * Counts the allocations made on its thread while it is in scope.
+     */
+    class Probe
+    {
+
+      public:
+
+        Probe() : start_(AllocCounter::getThreadCount()) { }
+
+        /**
+         * Returns how many allocations this thread has made since the probe
+         * was made.
+         *
+         * @returns {std::uint64_t} The number of allocations.
+         */
+        std::uint64_t getCount() const
+        {
+          return AllocCounter::getThreadCount() - start_;
+        }
+
+      private:
+
+        std::uint64_t start_;
+
+    };
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    /**
+     * Returns whether allocations are being counted at all.
+     *
+     * @returns {bool} True if operator new has been replaced.
+     */
+    static bool isEnabled() { return enabled_; }
+
+    /**
+     * Returns how many allocations the calling thread has made.
+     *
+     * @returns {std::uint64_t} The number of allocations.
+     */
+    static std::uint64_t getThreadCount() { return thread_count_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Counts an allocation on the calling thread. Only operator new should
+     * call this.
+     */
+    static void count() { ++thread_count_; }
+
+    /**
+     * Marks allocations as being counted.
+     *
+     * @returns {bool} True, so that it can initialize a constant.
+     */
+    static bool enable();
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static bool enabled_;
+    static thread_local std::uint64_t thread_count_;
+
+};
+
+#endif
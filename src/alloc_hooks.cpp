@@ -0,0 +1,39 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdlib>
+#include <new>
+#include "alloc_counter.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+// Set before main runs, so every count is known to be real
+const bool ALLOCATIONS_COUNTED = AllocCounter::enable();
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+// The array and nothrow forms all end up here, so these two are enough
+
+void* operator new(std::size_t size)
+{
+  AllocCounter::count();
+
+  void* memory = std::malloc(size == 0 ? 1 : size);
+  if (memory == nullptr) { throw std::bad_alloc(); }
+
+  return memory;
+}
+
+
+void operator delete(void* memory) noexcept
+{
+  std::free(memory);
+}
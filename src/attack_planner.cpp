@@ -0,0 +1,245 @@
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include "adjacency.h"
+#include "attack_planner.h"
+#include "board.h"
+#include "fight_odds.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t AttackPlanner::MAX_CHAIN_LENGTH;
+const size_t AttackPlanner::MAX_BRANCHES;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+bool AttackPlanner::plan(const Board& b, size_t from, Chain& chain)
+{
+  start(b, from);
+  if (num_dice_ == 0) { return false; }
+
+  // Every enemy is tried first, and each one's chains are skipped if even
+  // the best they could be would not beat the best so far
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(from);
+  for (size_t i = 0; i < adjacency.getDegree(from); ++i)
+  {
+    if ((b.getTiles() + neighbors[i])->getOwner() != owner_) {
+      searchFrom(b, neighbors[i]);
+    }
+  }
+
+  if (best_.length == 0) { return false; }
+
+  chain = best_;
+
+  return true;
+}
+
+
+void AttackPlanner::getChains(
+  const Board& b
+  , size_t from
+  , std::vector<Chain>& chains)
+{
+  chains.clear();
+
+  start(b, from);
+  if (num_dice_ == 0) { return; }
+
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(from);
+  for (size_t i = 0; i < adjacency.getDegree(from); ++i)
+  {
+    if ((b.getTiles() + neighbors[i])->getOwner() == owner_) { continue; }
+
+    best_.length = 0;
+    best_value_ = -1;
+    searchFrom(b, neighbors[i]);
+    chains.push_back(best_);
+  }
+
+  std::sort(
+    std::begin(chains)
+    , std::end(chains)
+    , [](const Chain& a, const Chain& c)
+    {
+      if (a.expected_captures != c.expected_captures) {
+        return a.expected_captures > c.expected_captures;
+      }
+      return a.targets[0] < c.targets[0];
+    });
+}
+
+
+void AttackPlanner::reserve(size_t num_tiles)
+{
+  bounds_.reserve(num_tiles * (GameRules::MAX_DICE_PER_TILE + 1));
+  bound_plans_.reserve(num_tiles * (GameRules::MAX_DICE_PER_TILE + 1));
+}
+
+
+void AttackPlanner::start(const Board& b, size_t from)
+{
+  const Tile& tile = *(b.getTiles() + from);
+  owner_ = tile.getOwner();
+  num_dice_ = owner_ == Tile::NO_OWNER ? 0 : tile.getNumDice();
+
+  // Bounds from earlier plans are for a board that has since changed
+  size_t num_bounds = b.getAdjacency().getNumTiles()
+    * (GameRules::MAX_DICE_PER_TILE + 1);
+  if (bound_plans_.size() != num_bounds) {
+    bounds_.assign(num_bounds, 0);
+    bound_plans_.assign(num_bounds, 0);
+    plan_ = 0;
+  }
+  if (++plan_ == 0) {
+    std::fill(std::begin(bound_plans_), std::end(bound_plans_), 0);
+    plan_ = 1;
+  }
+
+  path_.from = static_cast<tile_id_t> (from);
+  path_.length = 0;
+  best_ = path_;
+  best_.expected_captures = 0;
+  best_.success_chance = 1;
+  best_value_ = -1;
+}
+
+
+size_t AttackPlanner::getBranches(
+  const Board& b
+  , size_t id
+  , tile_id_t* ids) const
+{
+  Board::tile_iterator tiles = b.getTiles();
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(id);
+
+  // Kept sorted by dice, so ties go to the lower id
+  size_t num_branches = 0;
+  for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+  {
+    const Tile& neighbor = *(tiles + neighbors[i]);
+    if (neighbor.getOwner() == owner_) { continue; }
+
+    size_t j = num_branches;
+    if (j == MAX_BRANCHES) {
+      if ((tiles + ids[j - 1])->getNumDice() <= neighbor.getNumDice()) {
+        continue;
+      }
+      --j;
+    }
+    else {
+      ++num_branches;
+    }
+
+    for (; j > 0 && (tiles + ids[j - 1])->getNumDice() > neighbor.getNumDice()
+        ; --j)
+    {
+      ids[j] = ids[j - 1];
+    }
+    ids[j] = neighbors[i];
+  }
+
+  return num_branches;
+}
+
+
+double AttackPlanner::getBound(const Board& b, size_t id, size_t num_dice)
+{
+  if (num_dice == 0) { return 0; }
+
+  size_t index = id * (GameRules::MAX_DICE_PER_TILE + 1) + num_dice;
+  if (bound_plans_[index] == plan_) { return bounds_[index]; }
+
+  const FightOdds<GameRules>& odds = FightOdds<GameRules>::get();
+  Board::tile_iterator tiles = b.getTiles();
+
+  tile_id_t branches[MAX_BRANCHES];
+  size_t num_branches = getBranches(b, id, branches);
+
+  double bound = 0;
+  for (size_t i = 0; i < num_branches; ++i)
+  {
+    double win_chance =
+      odds.getWinChance(num_dice, (tiles + branches[i])->getNumDice());
+    bound = std::max(
+      bound
+      , win_chance * (1 + getBound(b, branches[i], num_dice - 1)));
+  }
+
+  bound_plans_[index] = plan_;
+  bounds_[index] = bound;
+
+  return bound;
+}
+
+
+void AttackPlanner::search(
+  const Board& b
+  , size_t num_dice
+  , double chance
+  , double value)
+{
+  if (value > best_value_) {
+    best_ = path_;
+    best_.expected_captures = value;
+    best_.success_chance = chance;
+    best_value_ = value;
+  }
+
+  size_t length = path_.length;
+  if (num_dice == 0 || length == MAX_CHAIN_LENGTH) { return; }
+
+  const FightOdds<GameRules>& odds = FightOdds<GameRules>::get();
+  Board::tile_iterator tiles = b.getTiles();
+
+  tile_id_t branches[MAX_BRANCHES];
+  size_t num_branches = getBranches(b, path_.targets[length - 1], branches);
+  for (size_t i = 0; i < num_branches; ++i)
+  {
+    // Tiles already taken in this chain are no longer the enemy's
+    tile_id_t target = branches[i];
+    if (std::find(path_.targets, path_.targets + length, target)
+        != path_.targets + length) {
+      continue;
+    }
+
+    double win_chance =
+      chance * odds.getWinChance(num_dice, (tiles + target)->getNumDice());
+    if (value + win_chance * (1 + getBound(b, target, num_dice - 1))
+        <= best_value_) {
+      continue;
+    }
+
+    path_.targets[length] = target;
+    path_.length = length + 1;
+    search(b, num_dice - 1, win_chance, value + win_chance);
+    path_.length = length;
+  }
+}
+
+
+void AttackPlanner::searchFrom(const Board& b, size_t target)
+{
+  double win_chance = FightOdds<GameRules>::get().getWinChance(
+    num_dice_
+    , (b.getTiles() + target)->getNumDice());
+  if (win_chance * (1 + getBound(b, target, num_dice_ - 1)) <= best_value_) {
+    return;
+  }
+
+  path_.targets[0] = static_cast<tile_id_t> (target);
+  path_.length = 1;
+  search(b, num_dice_ - 1, win_chance, win_chance);
+  path_.length = 0;
+}
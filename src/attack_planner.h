@@ -0,0 +1,192 @@
+#ifndef ATTACK_PLANNER_H
+#define ATTACK_PLANNER_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "rules.h"
+#include "tile.h"
+#include "tile_grid.h"
+
+class Board;
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Plans chains of attacks out of a tile: it attacks an enemy, and if it
+ * wins, the tile it took attacks on with one die fewer, and so on until the
+ * dice run out. As in Board::fight, a tile with a single die may attack too,
+ * though a tile it takes is left with none and cannot go on. A chain is
+ * worth the number of tiles it is expected to take, going by the exact
+ * chance of each fight and stopping at the first loss.
+ *
+ * The best a chain can do from a tile with some dice is worked out once per
+ * plan and remembered, and bounds the search, so branches that cannot beat
+ * the best chain found so far are never followed. Past the first attack, only
+ * the weakest few enemies of each tile are tried, which keeps plans fast
+ * however many neighbors tiles have.
+ */
+class AttackPlanner
+{
+
+  public:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // The most attacks in a chain, since every capture leaves one die behind
+    static const size_t MAX_CHAIN_LENGTH = GameRules::MAX_DICE_PER_TILE;
+
+    // How many enemies of each tile past the first are tried
+    static const size_t MAX_BRANCHES = 4;
+
+
+    /*********
+     * TYPES *
+     *********/
+
+    using tile_id_t = TileGrid::tile_id_t;
+
+    /**
+     * A chain of attacks, and what it is worth.
+     */
+    struct Chain
+    {
+      tile_id_t from;
+
+      // The tiles attacked, in order
+      size_t length;
+      tile_id_t targets[MAX_CHAIN_LENGTH];
+
+      // How many tiles it is expected to take
+      double expected_captures;
+
+      // The chance of every attack in it winning
+      double success_chance;
+    };
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** UTILITY ***/
+
+    /**
+     * Finds the best chain out of a tile.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} from The attacking tile's id.
+     * @param {Chain&} chain Where the chain is stored.
+     * @returns {bool} False if the tile cannot attack, so there is no chain.
+     */
+    bool plan(const Board& b, size_t from, Chain& chain);
+
+    /**
+     * Finds the best chain out of a tile starting with each enemy next to
+     * it. Fills a vector instead of returning one, so that a vector kept
+     * between turns never allocates.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} from The attacking tile's id.
+     * @param {std::vector<Chain>&} chains Where the chains are stored, best
+     * first, with ties in the order of the first tile attacked. Empty if the
+     * tile cannot attack.
+     */
+    void getChains(const Board& b, size_t from, std::vector<Chain>& chains);
+
+    /**
+     * Makes room for boards of a size, so the first plans do not have to.
+     *
+     * @param {size_t} num_tiles How many tiles the boards have.
+     */
+    void reserve(size_t num_tiles);
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Gets ready to plan for a tile's owner on a board as it is now.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} from The attacking tile's id.
+     */
+    void start(const Board& b, size_t from);
+
+    /**
+     * Finds the enemies a tile tries in a chain, which are the ones with the
+     * fewest dice, and so the likeliest to fall.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} id The tile's id.
+     * @param {tile_id_t*} ids Where the ids are stored, at least
+     * MAX_BRANCHES of them.
+     * @returns {size_t} How many there are.
+     */
+    size_t getBranches(const Board& b, size_t id, tile_id_t* ids) const;
+
+    /**
+     * Returns the most tiles a chain out of a tile can be expected to take,
+     * as if every tile around it were still the enemy's. Remembered until the
+     * next plan.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} id The tile's id.
+     * @param {size_t} num_dice The dice it attacks with.
+     * @returns {double} The expected captures.
+     */
+    double getBound(const Board& b, size_t id, size_t num_dice);
+
+    /**
+     * Extends the chain being searched, keeping the best one found.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} num_dice The dice its last tile attacks with.
+     * @param {double} chance The chance of every attack so far winning.
+     * @param {double} value What the chain so far is worth.
+     */
+    void search(const Board& b, size_t num_dice, double chance, double value);
+
+    /**
+     * Finds the best chain that starts by attacking a tile, if it is better
+     * than the best one so far.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} target The first tile attacked.
+     */
+    void searchFrom(const Board& b, size_t target);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // Whose chain is being planned, and with how many dice it starts
+    Tile::owner_t owner_ = Tile::NO_OWNER;
+    size_t num_dice_ = 0;
+
+    // The chain being searched, and the best one found
+    Chain path_, best_;
+    double best_value_ = 0;
+
+    // The best a chain can do out of each tile with each number of dice, and
+    // the plan it was worked out for, indexed by tile id and then dice
+    std::vector<double> bounds_;
+    std::vector<std::uint32_t> bound_plans_;
+    std::uint32_t plan_ = 0;
+
+};
+
+#endif
@@ -3,17 +3,28 @@
 
 #include "../player.h"
 #include "../display.h"
+#include "policies.h"
+#include "policy_ai.h"
 
 class AIEasy : public Player
 {
 
   public:
 
+    /*********
+     * TYPES *
+     *********/
+
+    // How it plays, for batch code that can call it without going through
+    // Player
+    using Policy = PolicyAI<RandomChoice, RandomChoice>;
+
+
     /****************
      * CONSTRUCTORS *
      ****************/
 
-    AIEasy(Color c) : Player(c) { }
+    AIEasy(Tile::owner_t id) : Player(id), policy_(id) { }
 
 
     /***********
@@ -22,6 +33,15 @@ class AIEasy : public Player
 
     virtual bool takeTurn(std::mt19937& rng, Display& d, Board& b) override;
 
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    Policy policy_;
+
 };
 
 #endif
@@ -3,17 +3,28 @@
 
 #include "../player.h"
 #include "../display.h"
+#include "evaluating_ai.h"
+#include "policies.h"
 
 class AIMedium : public Player
 {
 
   public:
 
+    /*********
+     * TYPES *
+     *********/
+
+    // How it plays, for batch code that can call it without going through
+    // Player
+    using Policy = EvaluatingAI<TerritoryScore>;
+
+
     /****************
      * CONSTRUCTORS *
      ****************/
 
-    AIMedium(Color c) : Player(c) { }
+    AIMedium(Tile::owner_t id) : Player(id), policy_(id) { }
 
 
     /***********
@@ -22,6 +33,15 @@ class AIMedium : public Player
 
     virtual bool takeTurn(std::mt19937& rng, Display& d, Board& b) override;
 
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    Policy policy_;
+
 };
 
 #endif
@@ -0,0 +1,142 @@
+#ifndef EVALUATING_AI_H
+#define EVALUATING_AI_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "../board.h"
+#include "../endgame_solver.h"
+#include "../fight_odds.h"
+#include "../rules.h"
+#include "../tile.h"
+#include "../tile_grid.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * An AI that weighs every attack it can make by how it would stand after
+ * winning and after losing, as judged by a score of the board's features,
+ * and makes the attack that leaves it best off on average. The features are
+ * kept by the board, so weighing an attack costs about the same however big
+ * the board is. Once so little is left that the board can work out exactly
+ * how likely each attack is to win or lose the game, only the attacks that
+ * do best by that are weighed. It fits in wherever a PolicyAI does.
+ *
+ * @param {Score} Score Judges features, with a static double
+ * score(const Evaluation::Features&), such as those in policies.h.
+ */
+template <typename Score>
+class EvaluatingAI
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {Tile::owner_t} id The id of the player it plays for.
+     */
+    explicit EvaluatingAI(Tile::owner_t id) : id_(id) { }
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    Tile::owner_t getId() const { return id_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Makes the best attack it can find, if there is anywhere to attack
+     * from. Ties go to the attack found first, in id order.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {Board&} b The board to play on.
+     * @returns {bool} False if the player has lost the game.
+     */
+    bool takeTurn(std::mt19937& rng, Board& b)
+    {
+      b.getFrontlineIds(id_, frontline_);
+      if (frontline_.empty()) { return false; }
+
+      // The attacks come in the same order as they are weighed below
+      bool solved = b.solveEndgame(id_, moves_);
+      double best_score = -1;
+      for (const EndgameSolver::Move& move : moves_)
+      {
+        best_score = std::max(best_score, EndgameSolver::getScore(move));
+      }
+      size_t next_move = 0;
+
+      const FightOdds<GameRules>& odds = FightOdds<GameRules>::get();
+      Board::tile_iterator tiles = b.getTiles();
+
+      bool found = false;
+      double best_value = 0;
+      Board::tile_id_t attacker = 0, defender = 0;
+      for (Board::tile_id_t from : frontline_)
+      {
+        b.getEnemyNeighborIds(from, targets_);
+        for (Board::tile_id_t to : targets_)
+        {
+          if (solved
+              && EndgameSolver::getScore(moves_[next_move++])
+                < best_score - SCORE_TOLERANCE) {
+            continue;
+          }
+
+          double win_chance = odds.getWinChance(
+            (tiles + from)->getNumDice()
+            , (tiles + to)->getNumDice());
+          double value =
+            win_chance * Score::score(b.getFeaturesAfterFight(from, to, true))
+            + (1 - win_chance)
+              * Score::score(b.getFeaturesAfterFight(from, to, false));
+
+          if (!found || value > best_value) {
+            found = true;
+            best_value = value;
+            attacker = from;
+            defender = to;
+          }
+        }
+      }
+
+      b.fight(rng, attacker, defender);
+
+      return true;
+    }
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    Tile::owner_t id_;
+
+    // How far apart exact scores can be and still count as the same, since
+    // they are added up in different orders
+    static constexpr double SCORE_TOLERANCE = 1e-9;
+
+    // Kept between turns so that a turn does not allocate
+    std::vector<TileGrid::tile_id_t> frontline_, targets_;
+    std::vector<EndgameSolver::Move> moves_;
+
+};
+
+#endif
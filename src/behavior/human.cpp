@@ -1,162 +1,292 @@
-#include <stdexcept>
-#include <list>
-#include <sstream>
-#include "human.h"
-#include "../board.h"
-#include "../display.h"
-
-/******************************
- * HELPER FUNCTION PROTOTYPES *
- ******************************/
-
-/**
- * Lets the user make a selection of the provided options.
- *
- * @param {Display&} A display object, used to communicate with the player.
- * @param {std::vector<Board::tile_iterator>} options The available tiles to
- * select from.
- * @returns {Board::tile_iterator} The selected tile.
- */
-Board::tile_iterator make_selection(
-  Display& d
-  , Board& b
-  , std::list<Board::tile_iterator>& options);
-
-
-/*******************
- * IMPLEMENTATIONS *
- *******************/
-
-bool Human::takeTurn(std::mt19937&rng, Display& d, Board& b)
-{
-  // Get possible attacking tiles
-  std::list<Board::tile_iterator> my_tiles =
-    b.filterForFrontlineTiles(b.getTilesByColor(getColor()));
-
-  // Player has lost the game.
-  if (my_tiles.size() == 0) { return false; }
-
-  my_tiles = b.filterForMultipleDice(my_tiles);
-
-  // Player cannot take turn.
-  if (my_tiles.size() == 0) { return true; }
-
-
-  // Select attacking tile
-  d.printMessage("Select your tile.");
-  Board::tile_iterator cur_selection = make_selection(d, b, my_tiles);
-
-  // Get possible defending tiles
-  d.printMessage("Select enemy tile.");
-  std::list<Board::tile_iterator> enemy_tiles =
-    Board::filterColoredTiles(
-      (*cur_selection).getColor()
-      , b.getAdjacentTiles(*cur_selection));
-
-  // Select defending tile
-  Board::tile_iterator enemy_selection = make_selection(d, b, enemy_tiles);
-
-  d.clearMessageBar();
-
-  // Fight
-  b.fight(rng, (*cur_selection).getId(), (*enemy_selection).getId());
-
-  return true;
-}
-
-
-/***********************************
- * HELPER FUNCTION IMPLEMENTATIONS *
- ***********************************/
-
-Board::tile_iterator make_selection(
-  Display& d
-  , Board& b
-  , std::list<Board::tile_iterator>& options)
-{
-  if (options.size() < 1) {
-    throw std::invalid_argument("Cannot select from empty list.");
-  }
-
-  int input = 0;
-  std::list<Board::tile_iterator>::iterator beginning = std::begin(options);
-  std::list<Board::tile_iterator>::iterator last = std::prev(std::end(options));
-  std::list<Board::tile_iterator>::iterator cur_selection = beginning;
-
-  // Until enter
-  while (input != static_cast<int> ('\n'))
-  {
-    input = d.blinkUntilKeypress((**cur_selection).getCoordinates());
-
-    // Used in some debug commands
-    std::ostringstream debug;
-
-    // Process non-enter input
-    switch (input)
-    {
-      // Previous
-      case Display::UP:
-      case Display::LEFT:
-        if (cur_selection == beginning) {
-          //Wrap
-          cur_selection = last;
-        }
-        else {
-          --cur_selection;
-        }
-        break;
-
-      // Next
-      case Display::DOWN:
-      case Display::RIGHT:
-        if (cur_selection == last) {
-          // Wrap
-          cur_selection = beginning;
-        }
-        else {
-          ++cur_selection;
-        }
-        break;
-
-        /* Debug commands */
-
-      case '#':
-        d.clearMessageBar();
-        debug << "Num dice on tile: " << (**cur_selection).getNumDice();
-        d.printMessage(debug.str());
-        break;
-
-      case '$':
-        d.clearMessageBar();
-        debug << "Num tiles with color: "
-          << b.getTilesByColor((**cur_selection).getColor()).size();
-        d.printMessage(debug.str());
-        break;
-
-      case '=':
-        b.draw();
-        d.clearMessageBar();
-        break;
-
-      case '@':
-        d.clearMessageBar();
-        debug << "Color ID: "
-          << static_cast<size_t> ((**cur_selection).getColor());
-        d.printMessage(debug.str());
-        break;
-
-      case '*':
-        std::list<Board::tile_iterator> all_tiles;
-        for (Board::tile_iterator tile = b.getTiles()
-          ; tile != b.getTilesEnd()
-          ; ++tile)
-        {
-          all_tiles.push_back(tile);
-        }
-        return make_selection(d, b, all_tiles);
-    }
-  }
-
-  return *cur_selection;
-}
-
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <float.h>
+#include <iterator>
+#include <stdexcept>
+#include <list>
+#include <sstream>
+#include <vector>
+#include "human.h"
+#include "../board.h"
+#include "../display.h"
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Lets the user make a selection of the provided options.
+ *
+ * @param {Display&} A display object, used to communicate with the player.
+ * @param {std::vector<Board::tile_iterator>} options The available tiles to
+ * select from.
+ * @returns {Board::tile_iterator} The selected tile, or the end of the
+ * board's tiles if the user wants to quit.
+ */
+Board::tile_iterator make_selection(
+  Display& d
+  , Board& b
+  , std::list<Board::tile_iterator>& options);
+
+
+/**
+ * Finds the nearest other option in one of the four screen directions,
+ * judged by the centers of the tiles. If nothing lies in that direction, the
+ * selection wraps around to the farthest option on the other side. Only the
+ * direction pressed is looked for, so a keypress costs one pass over the
+ * options however many there are.
+ *
+ * @param {std::vector<double>} xs The column of each option's center.
+ * @param {std::vector<double>} ys The row of each option's center.
+ * @param {size_t} from The index of the selected option.
+ * @param {size_t} dir 0, 1, 2 or 3 for UP, DOWN, LEFT and RIGHT.
+ * @returns {size_t} The index of the option reached, which is the selected
+ * one if it is the only option.
+ */
+size_t find_directional_neighbor(
+  const std::vector<double>& xs
+  , const std::vector<double>& ys
+  , size_t from
+  , size_t dir);
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+bool Human::takeTurn(std::mt19937&rng, Display& d, Board& b)
+{
+  // Get possible attacking tiles
+  std::list<Board::tile_iterator> my_tiles =
+    b.filterForFrontlineTiles(b.getTilesByOwner(getId()));
+
+  // Player has lost the game.
+  if (my_tiles.size() == 0) { return false; }
+
+  my_tiles = b.filterForMultipleDice(my_tiles);
+
+  // Player cannot take turn.
+  if (my_tiles.size() == 0) { return true; }
+
+
+  // Select attacking tile
+  d.printMessage("Select your tile.");
+  Board::tile_iterator cur_selection = make_selection(d, b, my_tiles);
+  quit_ = cur_selection == b.getTilesEnd();
+  if (quit_) { return true; }
+
+  // Get possible defending tiles
+  d.printMessage("Select enemy tile.");
+  std::list<Board::tile_iterator> enemy_tiles =
+    Board::filterOwnedTiles(
+      (*cur_selection).getOwner()
+      , b.getAdjacentTiles(*cur_selection));
+
+  // Select defending tile
+  Board::tile_iterator enemy_selection = make_selection(d, b, enemy_tiles);
+  quit_ = enemy_selection == b.getTilesEnd();
+  if (quit_) { return true; }
+
+  d.clearMessageBar();
+
+  // Fight
+  b.fight(rng, (*cur_selection).getId(), (*enemy_selection).getId());
+
+  return true;
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+Board::tile_iterator make_selection(
+  Display& d
+  , Board& b
+  , std::list<Board::tile_iterator>& options)
+{
+  if (options.size() < 1) {
+    throw std::invalid_argument("Cannot select from empty list.");
+  }
+
+  int input = 0;
+  std::vector<Board::tile_iterator> choices (
+    std::begin(options)
+    , std::end(options));
+  size_t cur_selection = 0;
+
+  // The centers are looked up once, and searched on each arrow key
+  std::vector<double> xs (choices.size()), ys (choices.size());
+  for (size_t i = 0; i < choices.size(); ++i)
+  {
+    b.getCentroid(*choices[i], xs[i], ys[i]);
+  }
+
+  // Until enter
+  while (input != static_cast<int> ('\n'))
+  {
+    // Make sure the selection can be seen before blinking it
+    d.scrollTo((*choices[cur_selection]).getCoordinates());
+
+    input = d.blinkUntilKeypress(*choices[cur_selection]);
+
+    // Used in some debug commands
+    std::ostringstream debug;
+
+    // Pan a quarter of the screen at a time
+    long pan_cols = std::max<long>(1, d.getViewport().getWidth() / 4);
+    long pan_rows = std::max<long>(1, d.getViewport().getHeight() / 4);
+
+    // Process non-enter input
+    switch (input)
+    {
+      // Move to the nearest option in that direction
+      case Display::UP:
+        cur_selection = find_directional_neighbor(xs, ys, cur_selection, 0);
+        break;
+
+      case Display::DOWN:
+        cur_selection = find_directional_neighbor(xs, ys, cur_selection, 1);
+        break;
+
+      case Display::LEFT:
+        cur_selection = find_directional_neighbor(xs, ys, cur_selection, 2);
+        break;
+
+      case Display::RIGHT:
+        cur_selection = find_directional_neighbor(xs, ys, cur_selection, 3);
+        break;
+
+      // Select whatever was clicked, if it is one of the options
+      case Display::MOUSE:
+        {
+          Tile::coord_t coord;
+          if (!d.getMouseCoordinate(coord)) { break; }
+
+          Board::tile_iterator clicked = b.getTileAt(coord);
+          if (clicked == b.getTilesEnd()) { break; }
+
+          std::vector<Board::tile_iterator>::iterator found =
+            std::find(std::begin(choices), std::end(choices), clicked);
+          if (found != std::end(choices)) {
+            cur_selection = std::distance(std::begin(choices), found);
+            input = '\n';
+          }
+          break;
+        }
+
+      // Camera
+      case Display::PAN_UP:
+        d.pan(0, -pan_rows);
+        break;
+
+      case Display::PAN_DOWN:
+        d.pan(0, pan_rows);
+        break;
+
+      case Display::PAN_LEFT:
+        d.pan(-pan_cols, 0);
+        break;
+
+      case Display::PAN_RIGHT:
+        d.pan(pan_cols, 0);
+        break;
+
+      case Display::ZOOM_IN:
+        d.zoomIn();
+        break;
+
+      case Display::ZOOM_OUT:
+        d.zoomOut();
+        break;
+
+      case Display::QUIT:
+        return b.getTilesEnd();
+
+        /* Debug commands */
+
+      case '#':
+        d.clearMessageBar();
+        debug << "Num dice on tile: " << (*choices[cur_selection]).getNumDice();
+        d.printMessage(debug.str());
+        break;
+
+      case '$':
+        d.clearMessageBar();
+        debug << "Num tiles with owner: "
+          << b.getNumTiles((*choices[cur_selection]).getOwner());
+        d.printMessage(debug.str());
+        break;
+
+      case '=':
+        b.draw();
+        d.clearMessageBar();
+        break;
+
+      case '%':
+        d.togglePerfHud();
+        break;
+
+      case '@':
+        d.clearMessageBar();
+        debug << "Owner ID: "
+          << static_cast<size_t> ((*choices[cur_selection]).getOwner());
+        d.printMessage(debug.str());
+        break;
+
+      case '*':
+        std::list<Board::tile_iterator> all_tiles;
+        for (Board::tile_iterator tile = b.getTiles()
+          ; tile != b.getTilesEnd()
+          ; ++tile)
+        {
+          all_tiles.push_back(tile);
+        }
+        return make_selection(d, b, all_tiles);
+    }
+  }
+
+  return choices[cur_selection];
+}
+
+
+size_t find_directional_neighbor(
+  const std::vector<double>& xs
+  , const std::vector<double>& ys
+  , size_t from
+  , size_t dir)
+{
+  double best_score = DBL_MAX;
+  double wrap_score = -1;
+  size_t best = from, wrap = from;
+
+  for (size_t j = 0; j < xs.size(); ++j)
+  {
+    if (j == from) { continue; }
+
+    double dx = xs[j] - xs[from];
+    double dy = ys[j] - ys[from];
+
+    // Distance along the direction (UP, DOWN, LEFT, RIGHT) and how far off
+    // to the side of it the other tile is
+    std::array<double, 4> along = { { -dy, dy, -dx, dx } };
+    double aside = dir < 2 ? std::fabs(dx) : std::fabs(dy);
+
+    if (along[dir] > 0) {
+      // Prefer tiles that are straight ahead over ones off to the side
+      double score = along[dir] + 2 * aside;
+      if (score < best_score) {
+        best_score = score;
+        best = j;
+      }
+    }
+    else if (-along[dir] - aside > wrap_score) {
+      // Farthest back the other way, in case we need to wrap around
+      wrap_score = -along[dir] - aside;
+      wrap = j;
+    }
+  }
+
+  return best_score == DBL_MAX ? wrap : best;
+}
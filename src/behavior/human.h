@@ -15,8 +15,8 @@ class Human : public Player
      * CONSTRUCTORS *
      ****************/
 
-    Human(Color c)
-      : Player(c)
+    Human(Tile::owner_t id)
+      : Player(id)
     { }
 
 
@@ -26,6 +26,17 @@ class Human : public Player
 
     virtual bool takeTurn(std::mt19937& rng, Display& d, Board& b) override;
 
+    virtual bool hasQuit() const override { return quit_; }
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    bool quit_ = false;
+
 };
 
 #endif
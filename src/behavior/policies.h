@@ -0,0 +1,131 @@
+#ifndef POLICIES_H
+#define POLICIES_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <random>
+#include <vector>
+#include "../board.h"
+
+
+/************
+ * POLICIES *
+ ************/
+
+// The ways an AI can choose, for PolicyAI to put together: which of the tiles
+// that can attack does, and which of its neighbors it attacks. Each is a type
+// with a static choose method, so a whole turn can be compiled as one function.
+
+/**
+ * Picks any of the options, each as likely as the others.
+ */
+struct RandomChoice
+{
+  /**
+   * @param {std::mt19937&} rng Used for randomness.
+   * @param {Board} b The board the options are on.
+   * @param {std::vector<Board::tile_id_t>} options The tiles to pick from,
+   * at least one.
+   * @returns {Board::tile_id_t} The tile picked.
+   */
+  static Board::tile_id_t choose(
+    std::mt19937& rng
+    , const Board&
+    , const std::vector<Board::tile_id_t>& options)
+  {
+    return options[
+      std::uniform_int_distribution<size_t>(0, options.size() - 1)(rng)];
+  }
+};
+
+/**
+ * Picks the option with the most dice, or the first of them if several have
+ * as many. Suits choosing the tile to attack from.
+ */
+struct MostDiceChoice
+{
+  static Board::tile_id_t choose(
+    std::mt19937&
+    , const Board& b
+    , const std::vector<Board::tile_id_t>& options)
+  {
+    Board::tile_iterator tiles = b.getTiles();
+    Board::tile_id_t best = options.front();
+    for (Board::tile_id_t id : options)
+    {
+      if ((tiles + id)->getNumDice() > (tiles + best)->getNumDice()) {
+        best = id;
+      }
+    }
+
+    return best;
+  }
+};
+
+/**
+ * Picks the option with the fewest dice, or the first of them if several have
+ * as few. Suits choosing the tile to attack.
+ */
+struct FewestDiceChoice
+{
+  static Board::tile_id_t choose(
+    std::mt19937&
+    , const Board& b
+    , const std::vector<Board::tile_id_t>& options)
+  {
+    Board::tile_iterator tiles = b.getTiles();
+    Board::tile_id_t best = options.front();
+    for (Board::tile_id_t id : options)
+    {
+      if ((tiles + id)->getNumDice() < (tiles + best)->getNumDice()) {
+        best = id;
+      }
+    }
+
+    return best;
+  }
+};
+
+
+/**********
+ * SCORES *
+ **********/
+
+// Ways to judge how a player stands, for EvaluatingAI. Each is a type with a
+// static score method, where more is better.
+
+/**
+ * Counts tiles, and a little the dice on the frontline, so an attack is
+ * mostly judged by its chance of winning.
+ */
+struct TerritoryScore
+{
+  /**
+   * @param {Evaluation::Features} f How the player stands.
+   * @returns {double} The score.
+   */
+  static double score(const Evaluation::Features& f)
+  {
+    return f.num_tiles + 0.1 * f.frontline_dice;
+  }
+};
+
+/**
+ * Weighs holding tiles and keeping them together against spending dice and
+ * leaving tiles next to stronger enemies. Since dice are never given back, a
+ * loss that throws away a big stack costs more than most wins bring in.
+ */
+struct PositionScore
+{
+  static double score(const Evaluation::Features& f)
+  {
+    return f.num_tiles
+      + 0.3 * f.largest_region
+      + 0.3 * f.frontline_dice
+      - 0.3 * f.exposure / Evaluation::EXPOSURE_SCALE;
+  }
+};
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef POLICY_AI_H
+#define POLICY_AI_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <random>
+#include <vector>
+#include "../board.h"
+#include "../tile.h"
+#include "../tile_grid.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * An AI put together from a way of choosing the tile to attack from and a way
+ * of choosing the tile to attack, such as those in policies.h. Turns are not
+ * virtual, so code that knows which AI it has can have a whole turn inlined;
+ * the Player classes wrap one of these for the game itself.
+ *
+ * @param {TilePolicy} TilePolicy Chooses which frontline tile attacks.
+ * @param {TargetPolicy} TargetPolicy Chooses which neighbor it attacks.
+ */
+template <typename TilePolicy, typename TargetPolicy>
+class PolicyAI
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {Tile::owner_t} id The id of the player it plays for.
+     */
+    explicit PolicyAI(Tile::owner_t id) : id_(id) { }
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    Tile::owner_t getId() const { return id_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Makes one attack, if there is anywhere to attack from.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {Board&} b The board to play on.
+     * @returns {bool} False if the player has lost the game.
+     */
+    bool takeTurn(std::mt19937& rng, Board& b)
+    {
+      b.getFrontlineIds(id_, frontline_);
+      if (frontline_.empty()) { return false; }
+
+      Board::tile_id_t attacker = TilePolicy::choose(rng, b, frontline_);
+
+      b.getEnemyNeighborIds(attacker, targets_);
+      Board::tile_id_t defender = TargetPolicy::choose(rng, b, targets_);
+
+      b.fight(rng, attacker, defender);
+
+      return true;
+    }
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    Tile::owner_t id_;
+
+    // Kept between turns so that a turn does not allocate
+    std::vector<TileGrid::tile_id_t> frontline_, targets_;
+
+};
+
+#endif
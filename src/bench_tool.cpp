@@ -0,0 +1,857 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "adjacency.h"
+#include "ai_easy.h"
+#include "ai_hard.h"
+#include "ai_medium.h"
+#include "alloc_counter.h"
+#include "attack_planner.h"
+#include "board.h"
+#include "fair_start.h"
+#include "fight_odds.h"
+#include "fixture.h"
+#include "frame.h"
+#include "headless_display.h"
+#include "map_generator.h"
+#include "playout.h"
+#include "rules.h"
+#include "simulation.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * How long one benchmark took per operation over every sample.
+ */
+struct BenchResult
+{
+  std::string name;
+  size_t num_samples;
+  size_t ops_per_sample;
+
+  // Over the samples' averages, in nanoseconds
+  double mean_ns, deviation_ns, fastest_ns;
+
+  double allocations_per_op;
+};
+
+/**
+ * What every benchmark is run with.
+ */
+struct BenchSettings
+{
+  std::uint64_t seed;
+  size_t num_samples;
+
+  // Only benchmarks whose names contain this are run
+  std::string filter;
+};
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Times an operation over several samples, each running it enough times to
+ * take about SAMPLE_NS, and counts what it allocates.
+ *
+ * @param {std::string} name What the operation is called.
+ * @param {BenchSettings} settings How many samples to take.
+ * @param {Operation} op Called once per operation.
+ * @returns {BenchResult} How long the operation took.
+ */
+template <typename Operation>
+BenchResult measure(
+  const std::string& name
+  , const BenchSettings& settings
+  , Operation op);
+
+/**
+ * Times what depends on a variant of the rules: rolling a tile's worth of
+ * dice, looking up the odds of a fight, and playing a position out.
+ *
+ * @param {std::string} variant What the variant is called.
+ * @param {BenchSettings} settings What to run and how.
+ * @param {Adjacency} adjacency Which tiles border each other.
+ * @param {std::vector<std::uint8_t>} owners The seat owning each tile.
+ * @param {std::vector<std::uint8_t>} dice The dice on each tile.
+ * @param {size_t} num_seats How many seats there are.
+ * @param {std::vector<BenchResult>&} results Where the results are added.
+ */
+template <typename Rules>
+void measure_rules(
+  const std::string& variant
+  , const BenchSettings& settings
+  , const Adjacency& adjacency
+  , const std::vector<std::uint8_t>& owners
+  , const std::vector<std::uint8_t>& dice
+  , size_t num_seats
+  , std::vector<BenchResult>& results);
+
+/**
+ * Runs every benchmark whose name passes the filter.
+ *
+ * @param {BenchSettings} settings What to run and how.
+ * @returns {std::vector<BenchResult>} The results, in the order run.
+ */
+std::vector<BenchResult> run_benchmarks(const BenchSettings& settings);
+
+/**
+ * Checks that the work every turn and every rollout repeats does not
+ * allocate once it has warmed up: finding the tiles that can attack and what
+ * they can attack, resolving a fight, a turn of each AI, a turn among as many
+ * players as there can be, and playing a position out.
+ *
+ * @param {BenchSettings} settings The seed to check with.
+ * @returns {bool} True if none of them allocated.
+ */
+bool check_zero_allocations(const BenchSettings& settings);
+
+/**
+ * Prints results as a table.
+ *
+ * @param {std::vector<BenchResult>} results The results.
+ */
+void print_table(const std::vector<BenchResult>& results);
+
+/**
+ * Prints results as JSON, for keeping track of them over time.
+ *
+ * @param {BenchSettings} settings What the results were run with.
+ * @param {std::vector<BenchResult>} results The results.
+ */
+void print_json(
+  const BenchSettings& settings
+  , const std::vector<BenchResult>& results);
+
+
+/*********************
+ * STATIC PROPERTIES *
+ *********************/
+
+// Long enough that the clock's resolution does not matter
+const double SAMPLE_NS = 1e7;
+
+// How many different boards generating one cycles through
+const size_t NUM_BOARD_SEEDS = 16;
+
+// As long as the rollouts that judge a fair start may last
+const size_t PLAYOUT_TURN_LIMIT = 300;
+
+// How many players the mix of AIs is, a third of them each kind
+const size_t MIX_NUM_PLAYERS = 15;
+
+// Where results that are otherwise unused go, so they are not optimized away
+volatile double sink;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+/**
+ * Times the board queries, fights and AI turns on fixed seeds, so runs can be
+ * compared with each other.
+ */
+int main(int argc, char** argv)
+{
+  BenchSettings settings = { 1, 10, "" };
+  bool as_json = false;
+  bool check_allocations = false;
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      bool has_value = i + 1 < argc;
+
+      if (std::string(argv[i]) == "--seed" && has_value) {
+        settings.seed = std::stoull(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--samples" && has_value) {
+        settings.num_samples = std::max<size_t>(std::stoul(argv[++i]), 2);
+      }
+      else if (std::string(argv[i]) == "--filter" && has_value) {
+        settings.filter = argv[++i];
+      }
+      else if (std::string(argv[i]) == "--json") {
+        as_json = true;
+      }
+      else if (std::string(argv[i]) == "--assert-zero-alloc") {
+        check_allocations = true;
+      }
+      else {
+        throw std::invalid_argument("Unknown argument.");
+      }
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Usage: " << argv[0]
+      << " [--seed N] [--samples N] [--filter NAME] [--json]"
+      << " [--assert-zero-alloc]" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    if (check_allocations) {
+      return check_zero_allocations(settings) ? 0 : 1;
+    }
+
+    std::vector<BenchResult> results = run_benchmarks(settings);
+    if (as_json) {
+      print_json(settings, results);
+    }
+    else {
+      print_table(results);
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Error in program: " << ex.what() << std::endl;
+    return 1;
+  }
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+template <typename Operation>
+BenchResult measure(
+  const std::string& name
+  , const BenchSettings& settings
+  , Operation op)
+{
+  typedef std::chrono::steady_clock clock;
+
+  // Warm up the caches and the allocator for a tenth of a sample, which also
+  // shows how many runs fill one
+  size_t num_warm_ups = 0;
+  clock::time_point start = clock::now();
+  std::chrono::duration<double, std::nano> warming (0);
+  while (warming.count() < SAMPLE_NS / 10)
+  {
+    op();
+    ++num_warm_ups;
+    warming = clock::now() - start;
+  }
+  size_t ops_per_sample = std::max<size_t>(
+    static_cast<size_t> (SAMPLE_NS * num_warm_ups / warming.count())
+    , 1);
+
+  std::vector<double> samples (settings.num_samples);
+  AllocCounter::Probe allocations;
+  for (double& sample : samples)
+  {
+    start = clock::now();
+    for (size_t i = 0; i < ops_per_sample; ++i)
+    {
+      op();
+    }
+    std::chrono::duration<double, std::nano> elapsed = clock::now() - start;
+    sample = elapsed.count() / ops_per_sample;
+  }
+
+  double sum = 0, sum_squares = 0;
+  for (double sample : samples)
+  {
+    sum += sample;
+    sum_squares += sample * sample;
+  }
+  double mean = sum / samples.size();
+  double variance = (sum_squares - sum * mean) / (samples.size() - 1);
+
+  BenchResult result;
+  result.name = name;
+  result.num_samples = samples.size();
+  result.ops_per_sample = ops_per_sample;
+  result.mean_ns = mean;
+  result.deviation_ns = std::sqrt(std::max(variance, 0.0));
+  result.fastest_ns = *std::min_element(std::begin(samples), std::end(samples));
+  result.allocations_per_op =
+    static_cast<double> (allocations.getCount())
+    / (samples.size() * ops_per_sample);
+
+  return result;
+}
+
+
+std::vector<BenchResult> run_benchmarks(const BenchSettings& settings)
+{
+  std::vector<BenchResult> results;
+  size_t next = 0;
+  auto wanted = [&](const std::string& name)
+  {
+    return name.find(settings.filter) != std::string::npos;
+  };
+
+  // Nothing is drawn and fights do not wait
+  HeadlessDisplay d (Display::MINIMUM_WIDTH, Display::MINIMUM_HEIGHT);
+
+  // Generating boards
+  struct BoardSize { size_t width, height; Board::Generator generator; };
+  const BoardSize BOARD_SIZES[] = {
+    { 10, 10, Board::Generator::RANDOM_WALK }
+    , { 40, 12, Board::Generator::RANDOM_WALK }
+    , { 80, 23, Board::Generator::RANDOM_WALK }
+    , { 80, 23, Board::Generator::VORONOI }
+    , { 400, 200, Board::Generator::VORONOI }
+  };
+  for (const BoardSize& size : BOARD_SIZES)
+  {
+    std::string name = std::string("board/")
+      + (size.generator == Board::Generator::VORONOI ? "voronoi" : "walk")
+      + "/" + std::to_string(size.width) + "x" + std::to_string(size.height);
+    if (!wanted(name)) { continue; }
+
+    // The same few boards over and over, since how long the random walk
+    // takes depends on luck
+    results.push_back(measure(name, settings, [&]()
+    {
+      std::mt19937 rng(
+        MapGenerator::getMapSeed(settings.seed, next++ % NUM_BOARD_SEEDS));
+      Board board (rng, d, size.width, size.height, size.generator);
+    }));
+  }
+
+  // Everything else plays on the same board, dealt to four players
+  const std::vector<Tile::owner_t> seats = { 0, 1, 2, 3 };
+  std::mt19937 fixture_rng(settings.seed);
+  Board board = make_fixture(
+    fixture_rng
+    , d
+    , Display::MINIMUM_WIDTH
+    , Display::MINIMUM_HEIGHT - 1
+    , Board::Generator::RANDOM_WALK
+    , Board::DEFAULT_NUM_TILES
+    , seats.size());
+  std::vector<TileState> start;
+  board.getTileStates(start);
+
+  size_t num_tiles = start.size();
+  Board::tile_iterator tiles = board.getTiles();
+
+  if (wanted("query/getAdjacentTiles")) {
+    results.push_back(measure("query/getAdjacentTiles", settings, [&]()
+    {
+      board.getAdjacentTiles(*(tiles + next++ % num_tiles));
+    }));
+  }
+
+  if (wanted("query/getTilesByOwner")) {
+    results.push_back(measure("query/getTilesByOwner", settings, [&]()
+    {
+      board.getTilesByOwner(seats[next++ % seats.size()]);
+    }));
+  }
+
+  // The filters take their tiles by value, so copying them is part of it
+  std::vector<std::list<Board::tile_iterator>> neighborhoods, territories;
+  for (size_t id = 0; id < num_tiles; ++id)
+  {
+    neighborhoods.push_back(board.getAdjacentTiles(*(tiles + id)));
+  }
+  for (Tile::owner_t seat : seats)
+  {
+    territories.push_back(board.getTilesByOwner(seat));
+  }
+
+  if (wanted("filter/filterOwnedTiles")) {
+    results.push_back(measure("filter/filterOwnedTiles", settings, [&]()
+    {
+      size_t id = next++ % num_tiles;
+      Board::filterOwnedTiles((tiles + id)->getOwner(), neighborhoods[id]);
+    }));
+  }
+
+  if (wanted("filter/filterForFrontlineTiles")) {
+    results.push_back(measure("filter/filterForFrontlineTiles", settings, [&]()
+    {
+      board.filterForFrontlineTiles(territories[next++ % seats.size()]);
+    }));
+  }
+
+  if (wanted("filter/filterForMultipleDice")) {
+    results.push_back(measure("filter/filterForMultipleDice", settings, [&]()
+    {
+      board.filterForMultipleDice(territories[next++ % seats.size()]);
+    }));
+  }
+
+  // Every fight starts from the dealt position, between the same tiles
+  std::vector<std::pair<size_t, size_t>> borders;
+  for (size_t id = 0; id < num_tiles; ++id)
+  {
+    const Adjacency& adjacency = board.getAdjacency();
+    for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+    {
+      size_t neighbor = adjacency.getNeighbors(id)[i];
+      if (start[id].owner != start[neighbor].owner) {
+        borders.push_back(std::make_pair(id, neighbor));
+      }
+    }
+  }
+
+  if (wanted("fight") && !borders.empty()) {
+    std::mt19937 rng(settings.seed);
+    results.push_back(measure("fight", settings, [&]()
+    {
+      const std::pair<size_t, size_t>& border =
+        borders[next++ % borders.size()];
+      board.setTileStates(start);
+      board.fight(rng, border.first, border.second);
+    }));
+  }
+
+  // A whole turn of each AI, from the dealt position
+  AIEasy easy (seats[0]);
+  AIMedium medium (seats[0]);
+  AIHard hard (seats[0]);
+  Player* const PLAYERS[] = { &easy, &medium, &hard };
+  const char* PLAYER_NAMES[] = {
+    "turn/AIEasy"
+    , "turn/AIMedium"
+    , "turn/AIHard"
+  };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    if (!wanted(PLAYER_NAMES[i])) { continue; }
+
+    std::mt19937 rng(settings.seed);
+    results.push_back(measure(PLAYER_NAMES[i], settings, [&]()
+    {
+      board.setTileStates(start);
+      PLAYERS[i]->takeTurn(rng, d, board);
+    }));
+  }
+
+  // A turn as the number of players grows. Each player's turn only looks at
+  // their own tiles, so turns should get no slower with more players.
+  const size_t PLAYER_COUNTS[] = { 2, 8, 16, 32, GameRules::MAX_NUM_PLAYERS };
+  for (size_t num_players : PLAYER_COUNTS)
+  {
+    std::string name = "players/" + std::to_string(num_players);
+    if (!wanted(name)) { continue; }
+
+    std::mt19937 crowd_rng(settings.seed);
+    Board crowd = make_fixture(
+      crowd_rng
+      , d
+      , CROWD_WIDTH
+      , CROWD_HEIGHT
+      , Board::Generator::VORONOI
+      , CROWD_NUM_TILES
+      , num_players);
+    std::vector<TileState> crowd_start;
+    crowd.getTileStates(crowd_start);
+
+    std::vector<AIEasy> players;
+    for (size_t i = 0; i < num_players; ++i)
+    {
+      players.emplace_back(static_cast<Tile::owner_t> (i));
+    }
+
+    // Dealt again after as many turns whatever the number of players, so
+    // that costs every turn the same
+    size_t turn = 0;
+    results.push_back(measure(name, settings, [&]()
+    {
+      if (turn % GameRules::MAX_NUM_PLAYERS == 0) {
+        crowd.setTileStates(crowd_start);
+      }
+      players[turn++ % num_players].takeTurn(crowd_rng, d, crowd);
+    }));
+  }
+
+  // A turn of a mix of every AI, called through Player the way the game does
+  // and dispatched statically the way batch code can. Both play the same
+  // game, so only how the turn is called differs.
+  std::mt19937 mix_rng(settings.seed);
+  Board mix = make_fixture(
+    mix_rng
+    , d
+    , CROWD_WIDTH
+    , CROWD_HEIGHT
+    , Board::Generator::VORONOI
+    , CROWD_NUM_TILES
+    , MIX_NUM_PLAYERS);
+  std::vector<TileState> mix_start;
+  mix.getTileStates(mix_start);
+
+  if (wanted("sim/virtual")) {
+    std::vector<std::unique_ptr<Player>> players;
+    for (size_t i = 0; i < MIX_NUM_PLAYERS; ++i)
+    {
+      Tile::owner_t id = static_cast<Tile::owner_t> (i);
+      switch (i % 3)
+      {
+        case 0: players.emplace_back(new AIEasy(id)); break;
+        case 1: players.emplace_back(new AIMedium(id)); break;
+        default: players.emplace_back(new AIHard(id)); break;
+      }
+    }
+
+    std::mt19937 rng(settings.seed);
+    size_t turn = 0, next_player = 0;
+    results.push_back(measure("sim/virtual", settings, [&]()
+    {
+      if (turn++ % GameRules::MAX_NUM_PLAYERS == 0) {
+        mix.setTileStates(mix_start);
+      }
+      if (players.size() < 2) { return; }
+
+      if (players[next_player]->takeTurn(rng, d, mix)) {
+        mix.reinforce(rng, players[next_player]->getId());
+        next_player = (next_player + 1) % players.size();
+      }
+      else {
+        players.erase(std::begin(players) + next_player);
+        if (next_player == players.size()) { next_player = 0; }
+      }
+    }));
+  }
+
+  if (wanted("sim/static")) {
+    Simulation<AIEasy::Policy, AIMedium::Policy, AIHard::Policy> sim (mix);
+    for (size_t i = 0; i < MIX_NUM_PLAYERS; ++i)
+    {
+      Tile::owner_t id = static_cast<Tile::owner_t> (i);
+      switch (i % 3)
+      {
+        case 0: sim.addPlayer<0>(id); break;
+        case 1: sim.addPlayer<1>(id); break;
+        default: sim.addPlayer<2>(id); break;
+      }
+    }
+
+    std::mt19937 rng(settings.seed);
+    size_t turn = 0;
+    results.push_back(measure("sim/static", settings, [&]()
+    {
+      if (turn++ % GameRules::MAX_NUM_PLAYERS == 0) {
+        mix.setTileStates(mix_start);
+      }
+      sim.step(rng);
+    }));
+  }
+
+  // Planning a chain of attacks out of every tile that can attack, on the
+  // mix board, whose tiles have many neighbors
+  if (wanted("plan/chain")) {
+    mix.setTileStates(mix_start);
+    std::vector<size_t> attackers;
+    std::vector<Board::tile_id_t> enemies;
+    for (size_t id = 0; id < mix_start.size(); ++id)
+    {
+      mix.getEnemyNeighborIds(id, enemies);
+      if (mix_start[id].num_dice > 1 && !enemies.empty()) {
+        attackers.push_back(id);
+      }
+    }
+
+    AttackPlanner::Chain chain;
+    results.push_back(measure("plan/chain", settings, [&]()
+    {
+      mix.planAttackChain(attackers[next++ % attackers.size()], chain);
+    }));
+  }
+
+  // Each variant of the rules, on the dealt position, where every player's
+  // id is their seat
+  std::vector<std::uint8_t> owners (num_tiles), dice (num_tiles);
+  for (size_t id = 0; id < num_tiles; ++id)
+  {
+    owners[id] = start[id].owner;
+    dice[id] = static_cast<std::uint8_t> (start[id].num_dice);
+  }
+  measure_rules<ClassicRules>(
+    "classic"
+    , settings
+    , board.getAdjacency()
+    , owners
+    , dice
+    , seats.size()
+    , results);
+  measure_rules<LargeRules>(
+    "large"
+    , settings
+    , board.getAdjacency()
+    , owners
+    , dice
+    , seats.size()
+    , results);
+
+  return results;
+}
+
+
+template <typename Rules>
+void measure_rules(
+  const std::string& variant
+  , const BenchSettings& settings
+  , const Adjacency& adjacency
+  , const std::vector<std::uint8_t>& owners
+  , const std::vector<std::uint8_t>& dice
+  , size_t num_seats
+  , std::vector<BenchResult>& results)
+{
+  std::mt19937 rng(settings.seed);
+  size_t next = 0;
+
+  std::string name = "rules/" + variant + "/roll";
+  if (name.find(settings.filter) != std::string::npos) {
+    results.push_back(measure(name, settings, [&]()
+    {
+      sink = Rules::roll(rng, Rules::MAX_DICE_PER_TILE);
+    }));
+  }
+
+  name = "rules/" + variant + "/getWinChance";
+  if (name.find(settings.filter) != std::string::npos) {
+    const FightOdds<Rules>& odds = FightOdds<Rules>::get();
+    results.push_back(measure(name, settings, [&]()
+    {
+      size_t attacker = next++ % Rules::MAX_DICE_PER_TILE + 1;
+      size_t defender = (next / Rules::MAX_DICE_PER_TILE)
+        % Rules::MAX_DICE_PER_TILE + 1;
+      sink = odds.getWinChance(attacker, defender);
+    }));
+  }
+
+  name = "rules/" + variant + "/playout";
+  if (name.find(settings.filter) != std::string::npos) {
+    Playout<Rules> playout;
+    results.push_back(measure(name, settings, [&]()
+    {
+      playout.play(
+        rng, adjacency, owners, dice, num_seats, PLAYOUT_TURN_LIMIT);
+    }));
+  }
+}
+
+
+bool check_zero_allocations(const BenchSettings& settings)
+{
+  HeadlessDisplay d (Display::MINIMUM_WIDTH, Display::MINIMUM_HEIGHT);
+
+  const std::vector<Tile::owner_t> seats = { 0, 1, 2, 3 };
+  std::mt19937 fixture_rng(settings.seed);
+  Board board = make_fixture(
+    fixture_rng
+    , d
+    , Display::MINIMUM_WIDTH
+    , Display::MINIMUM_HEIGHT - 1
+    , Board::Generator::RANDOM_WALK
+    , Board::DEFAULT_NUM_TILES
+    , seats.size());
+  std::vector<TileState> start;
+  board.getTileStates(start);
+
+  bool passed = true;
+  auto check = [&](const char* name, std::uint64_t allocations)
+  {
+    std::cout << std::left << std::setw(32) << name
+      << (allocations == 0 ? "ok" : "FAILED") << " ("
+      << allocations << " allocations)" << std::endl;
+    passed = passed && allocations == 0;
+  };
+
+  // Every check runs once to size its buffers, then again while counting
+  std::vector<Board::tile_id_t> frontline, targets;
+  auto generate_moves = [&]()
+  {
+    for (Tile::owner_t seat : seats)
+    {
+      board.getFrontlineIds(seat, frontline);
+      for (Board::tile_id_t id : frontline)
+      {
+        board.getEnemyNeighborIds(id, targets);
+      }
+    }
+  };
+  generate_moves();
+  {
+    AllocCounter::Probe allocations;
+    generate_moves();
+    check("move generation", allocations.getCount());
+  }
+
+  std::mt19937 rng(settings.seed);
+  auto fight_every_border = [&]()
+  {
+    for (Tile::owner_t seat : seats)
+    {
+      board.setTileStates(start);
+      board.getFrontlineIds(seat, frontline);
+      for (Board::tile_id_t id : frontline)
+      {
+        board.setTileStates(start);
+        board.getEnemyNeighborIds(id, targets);
+        board.fight(rng, id, targets.front());
+      }
+    }
+  };
+  fight_every_border();
+  {
+    AllocCounter::Probe allocations;
+    fight_every_border();
+    check("fight", allocations.getCount());
+  }
+
+  AttackPlanner::Chain chain;
+  std::vector<AttackPlanner::Chain> chains;
+  auto plan_every_frontline = [&]()
+  {
+    board.setTileStates(start);
+    for (Tile::owner_t seat : seats)
+    {
+      board.getFrontlineIds(seat, frontline);
+      for (Board::tile_id_t id : frontline)
+      {
+        board.planAttackChain(id, chain);
+        board.getAttackChains(id, chains);
+      }
+    }
+  };
+  plan_every_frontline();
+  {
+    AllocCounter::Probe allocations;
+    plan_every_frontline();
+    check("attack chains", allocations.getCount());
+  }
+
+  AIEasy easy (seats[0]);
+  AIMedium medium (seats[0]);
+  AIHard hard (seats[0]);
+  Player* const PLAYERS[] = { &easy, &medium, &hard };
+  const char* PLAYER_NAMES[] = {
+    "turn/AIEasy"
+    , "turn/AIMedium"
+    , "turn/AIHard"
+  };
+  for (size_t i = 0; i < 3; ++i)
+  {
+    board.setTileStates(start);
+    PLAYERS[i]->takeTurn(rng, d, board);
+
+    board.setTileStates(start);
+    AllocCounter::Probe allocations;
+    PLAYERS[i]->takeTurn(rng, d, board);
+    check(PLAYER_NAMES[i], allocations.getCount());
+  }
+
+  // The same with as many players as there can be
+  std::mt19937 crowd_rng(settings.seed);
+  Board crowd = make_fixture(
+    crowd_rng
+    , d
+    , CROWD_WIDTH
+    , CROWD_HEIGHT
+    , Board::Generator::VORONOI
+    , CROWD_NUM_TILES
+    , GameRules::MAX_NUM_PLAYERS);
+  std::vector<TileState> crowd_start;
+  crowd.getTileStates(crowd_start);
+  {
+    crowd.setTileStates(crowd_start);
+    easy.takeTurn(rng, d, crowd);
+
+    crowd.setTileStates(crowd_start);
+    AllocCounter::Probe allocations;
+    easy.takeTurn(rng, d, crowd);
+    check("turn/AIEasy/many players", allocations.getCount());
+  }
+
+  // Setting up a set of rollouts allocates, so what they cost each is the
+  // difference between playing out a few and playing out twice as many
+  const size_t NUM_ROLLOUTS = 64;
+  FairStart few (NUM_ROLLOUTS, 0, 1), more (2 * NUM_ROLLOUTS, 0, 1);
+  few.getWinRates(board.getAdjacency(), start, seats, settings.seed);
+
+  AllocCounter::Probe few_allocations;
+  few.getWinRates(board.getAdjacency(), start, seats, settings.seed);
+  std::uint64_t per_few = few_allocations.getCount();
+
+  AllocCounter::Probe more_allocations;
+  more.getWinRates(board.getAdjacency(), start, seats, settings.seed);
+  std::uint64_t per_more = more_allocations.getCount();
+
+  check("playouts", per_more - std::min(per_few, per_more));
+
+  if (!AllocCounter::isEnabled()) {
+    std::cout << "Allocations are not being counted" << std::endl;
+    return false;
+  }
+
+  return passed;
+}
+
+
+void print_table(const std::vector<BenchResult>& results)
+{
+  std::cout << std::left << std::setw(32) << "benchmark"
+    << std::right << std::setw(14) << "ns/op"
+    << std::setw(10) << "+/- %"
+    << std::setw(14) << "fastest"
+    << std::setw(12) << "allocs/op" << std::endl
+    << std::fixed;
+
+  for (const BenchResult& result : results)
+  {
+    std::cout << std::left << std::setw(32) << result.name
+      << std::right << std::setprecision(1)
+      << std::setw(14) << result.mean_ns
+      << std::setw(10) << 100 * result.deviation_ns / result.mean_ns
+      << std::setw(14) << result.fastest_ns
+      << std::setprecision(2)
+      << std::setw(12) << result.allocations_per_op << std::endl;
+  }
+}
+
+
+void print_json(
+  const BenchSettings& settings
+  , const std::vector<BenchResult>& results)
+{
+  std::cout << "{\"seed\": " << settings.seed
+    << ", \"samples\": " << settings.num_samples
+    << ", \"benchmarks\": [" << std::fixed;
+
+  for (size_t i = 0; i < results.size(); ++i)
+  {
+    const BenchResult& result = results[i];
+    std::cout << (i == 0 ? "" : ",") << std::endl
+      << "  {\"name\": \"" << result.name << "\""
+      << std::setprecision(1)
+      << ", \"ns_per_op\": " << result.mean_ns
+      << ", \"stddev_ns\": " << result.deviation_ns
+      << ", \"fastest_ns\": " << result.fastest_ns
+      << std::setprecision(3)
+      << ", \"allocs_per_op\": " << result.allocations_per_op
+      << ", \"ops_per_sample\": " << result.ops_per_sample
+      << "}";
+  }
+
+  std::cout << std::endl << "]}" << std::endl;
+}
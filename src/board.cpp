@@ -1,14 +1,19 @@
+#include <algorithm>
 #include <cmath>
-#include <chrono>
+#include <cstdint>
+#include <cstdio>
 #include <float.h>
 #include <random>
-#include <sstream>
 #include <stdexcept>
 #include <string>
-#include <thread>
+#include <utility>
 #include "board.h"
 #include "display.h"
+#include "perf_stats.h"
+#include "rules.h"
 #include "tile.h"
+#include "trace.h"
+#include "voronoi_generator.h"
 
 /*********************
  * STATIC PROPERTIES *
@@ -17,6 +22,8 @@
 size_t Board::MINIMUM_WIDTH = 10
   , Board::MINIMUM_HEIGHT = 10;
 
+const size_t Board::DEFAULT_NUM_TILES;
+
 
 /******************************
  * HELPER FUNCTION PROTOTYPES *
@@ -33,13 +40,32 @@ size_t Board::MINIMUM_WIDTH = 10
 double get_dist(Tile::coord_t p1, Tile::coord_t p2, size_t width);
 
 /**
- * Gets an index into the adjacency matrix using two coordinates.
+ * Finds how far along a Hilbert curve filling a square a point is.
  *
- * @param {size_t} c1 The first coordinate (smaller).
- * @param {size_t} c2 The second coordinate (larger).
- * @returns {size_t} The index into the matrix.
+ * @param {std::uint64_t} x The x-value of the point.
+ * @param {std::uint64_t} y The y-value of the point.
+ * @param {std::uint64_t} side The width of the square, a power of two.
+ * @returns {std::uint64_t} How many points the curve passes first.
  */
-inline size_t get_adjacency_index(Tile::coord_t c1, Tile::coord_t c2);
+std::uint64_t hilbert_index(
+  std::uint64_t x
+  , std::uint64_t y
+  , std::uint64_t side);
+
+/**
+ * Finds how big tiles may be for a board to be divided into about a number of
+ * them: between five sixths of an even share of the spaces and all of it.
+ *
+ * @param {size_t} num_spaces How many spaces the board has.
+ * @param {size_t} num_tiles About how many tiles to make.
+ * @param {size_t&} min_size Where the fewest spaces a tile may have is stored.
+ * @param {size_t&} max_size Where the most spaces a tile may have is stored.
+ */
+void get_tile_size_limits(
+  size_t num_spaces
+  , size_t num_tiles
+  , size_t& min_size
+  , size_t& max_size);
 
 
 /*******************
@@ -50,11 +76,15 @@ Board::Board(
   std::mt19937& rng
   , Display& d
   , const size_t width
-  , const size_t height)
+  , const size_t height
+  , Generator generator
+  , size_t num_tiles)
   : d_(d)
   , width_(width)
   , height_(height)
 {
+  PerfStats::Timer timer (PerfStats::Metric::BOARD_GENERATION);
+
   if (width == 0 || height == 0) {
     throw std::invalid_argument("Board cannot have no size.");
   }
@@ -63,134 +93,26 @@ Board::Board(
     throw std::invalid_argument("Board dimensions cannot be below minimums.");
   }
 
-  size_t num_spaces = width * height;
-  size_t num_generated = 0;
-  size_t min_size_per_tile = num_spaces / 30;
-  size_t max_size_per_tile = num_spaces / 25;
-  size_t max_attempts = 100;
-
-  // We will use this temporary object to keep track of which tiles are where
-  // It will then be used to create our adjacency matrix at the end.
-  std::vector<Board::tile_iterator> occupied (num_spaces, std::end(tiles_));
+  if (num_tiles == 0 || num_tiles >= TileGrid::NO_TILE) {
+    throw std::invalid_argument("Board needs a valid number of tiles.");
+  }
 
-  // We will use this so that we don't accidentally pick a starting point for
-  // a tile that is in-use by another tile
-  std::vector<size_t> space_weights (num_spaces, 1);
+  // We will use this to keep track of which tiles are where. It will then be
+  // used to create our adjacency lists at the end, and kept for lookups.
+  std::vector<Board::tile_id_t> occupied;
 
-  // Generate each tile (A tile consists of multiple spaces)
-  for (size_t percent_generated = 0
-      ; percent_generated < 80
-      ; percent_generated = 100 * num_generated / num_spaces)
+  switch (generator)
   {
-    Tile cur_tile;
-
-    // Pick a random starting space
-    std::discrete_distribution<Tile::coord_t> starting_weights (
-      std::begin(space_weights)
-      , std::end(space_weights));
-    Tile::coord_t starting_coord = starting_weights(rng);
-    Tile::coord_t coord = starting_coord;
-
-    // Figure out which nearby tiles are open and add then to another vector of
-    // weights for picking where to go next
-    std::vector<double> next_space_weights (num_spaces, 0);
-    size_t cur_tile_size = 1;
-
-    // Let tile know it owns this space
-    cur_tile.addCoordindate(coord);
-
-    // Generate tile based on starting point
-    bool success = false;
-    for(;;)
-    {
-      // Find an adjacent space
-      // Left available?
-      size_t new_coord = coord - 1;
-      if ((coord % width != 0) && (occupied[new_coord] == std::end(tiles_))) {
-        next_space_weights[new_coord] = DBL_MAX;
-      }
-      // Right available?
-      new_coord = coord + 1;
-      if ((coord % width != (width - 1))
-          && (occupied[new_coord] == std::end(tiles_))) {
-        next_space_weights[new_coord] = DBL_MAX;
-      }
-      // Up?
-      new_coord = coord - width;
-      if (((coord / width) != 0)
-          && (occupied[new_coord] == std::end(tiles_))) {
-        next_space_weights[new_coord] = DBL_MAX;
-      }
-      // Down?
-      new_coord = coord + width;
-      if (((coord / width) != (height - 1))
-          && (occupied[new_coord] == std::end(tiles_))) {
-        next_space_weights[new_coord] = DBL_MAX;
-      }
-
-      // Calculate the weights for these new points, check for any valid weights
-      bool no_valid_weights = true;
-      for (double& space : next_space_weights)
-      {
-        if (space == DBL_MAX) {
-          space = (width * height / 2) - get_dist(starting_coord, space, width);
-        }
-        if (space != 0) { no_valid_weights = false; }
-      }
-
-      // Can't find next space
-      if (no_valid_weights) {
-        size_t cur_tile_size = cur_tile.getCoordinates().size();
-
-        success = (cur_tile_size >= min_size_per_tile)
-            && (cur_tile_size <= max_size_per_tile);
-
-        break;
-      }
-
-      // Find the next space
-      std::discrete_distribution<Tile::coord_t> next_space (
-        std::begin(next_space_weights)
-        , std::end(next_space_weights));
-      coord = next_space(rng);
-      next_space_weights[coord] = 0;
-
-      // If we ran out of attempts, stop and do not add this tile
-      if (occupied[coord] != std::end(tiles_)) {
-        // Unmark all the spaces this tile occupied
-        for(Tile::coord_t coord : cur_tile.getCoordinates())
-        {
-          occupied[coord] = std::end(tiles_);
-        }
-        break;
-      }
-
-      cur_tile.addCoordindate(coord);
-
-      // Stop adding spaces if too big
-      if (++cur_tile_size >= min_size_per_tile) {
-        success = true;
-        break;
-      }
-    }
-
-    // Tile generation was successful
-    if (success) {
-      num_generated += cur_tile.getCoordinates().size();
-      cur_tile.setId(tiles_.size());
-      tiles_.push_front(std::move(cur_tile));
-
-      const std::vector<Tile::coord_t>& cur_coordinates =
-        tiles_.front().getCoordinates();
+    case Generator::RANDOM_WALK:
+      generateRandomWalk(rng, occupied, num_tiles);
+      break;
 
-      // Mark spaces as occupied by this tile
-      for (Tile::coord_t cur_coord : cur_coordinates)
-      {
-        occupied[cur_coord] = std::begin(tiles_);
-        space_weights[cur_coord] = 0;
-      }
-    }
+    case Generator::VORONOI:
+      generateVoronoi(rng, occupied, num_tiles);
+      break;
   }
+  renumberTiles(occupied);
+  clearOwners();
 
   // Randomly give each tile a number of dice.
   // Starting chances should favor middle numbers
@@ -213,45 +135,83 @@ Board::Board(
     tile.setNumDice(num_dice_distribution(rng) + 1);
   }
 
-  // Generate adjacenty matrix
-  adjacency_.resize(tiles_.size() * (tiles_.size() - 1) / 2);
-  Board::tile_iterator empty_space = std::end(tiles_);
-  for (size_t i = 0; i < num_spaces; ++i)
+  grid_ = std::make_shared<TileGrid>(width, height, std::move(occupied));
+  connectTiles();
+  d_.setGrid(grid_);
+}
+
+
+Board::Board(
+  Display& d
+  , std::shared_ptr<const TileGrid> grid
+  , const std::vector<TileState>& states
+  , Adjacency adjacency)
+  : d_(d)
+  , width_(grid->getWidth())
+  , height_(grid->getHeight())
+  , tiles_(states.size())
+  , adjacency_(std::move(adjacency))
+  , grid_(std::move(grid))
+{
+  if (states.empty() || states.size() >= TileGrid::NO_TILE) {
+    throw std::invalid_argument("Board needs a valid number of tiles.");
+  }
+
+  for (size_t id = 0; id < tiles_.size(); ++id)
   {
-    Board::tile_iterator cur_space = occupied[i];
-    if (cur_space == std::end(tiles_)) { continue; }
+    tiles_[id].setId(id);
+  }
 
-    // Since we start in the upper left-hand corner, we only have to look down
-    // and to the right to see unchecked spaces
-    // Right
-    if (i % width != (width - 1)) {
-      Board::tile_iterator right_space = occupied[i + 1];
-      if (right_space != empty_space && right_space != cur_space) {
-        markAdjacent(*cur_space, *right_space);
-      }
+  // Give every tile back the spaces it occupies
+  size_t num_spaces = width_ * height_;
+  for (Tile::coord_t coord = 0; coord < num_spaces; ++coord)
+  {
+    Board::tile_id_t id = grid_->at(coord);
+    if (id == TileGrid::NO_TILE) { continue; }
+
+    if (id >= tiles_.size()) {
+      throw std::invalid_argument("Grid refers to a tile that does not exist.");
     }
-    // Down
-    if (i / width != (height - 1)) {
-      Board::tile_iterator down_space = occupied[i + width];
-      if (down_space != empty_space && down_space != cur_space) {
-        markAdjacent(*cur_space, *down_space);
-      }
+    tiles_[id].addCoordindate(coord);
+  }
+
+  for (const Tile& tile : tiles_)
+  {
+    if (tile.getCoordinates().empty()) {
+      throw std::invalid_argument("Grid has a tile without any spaces.");
     }
   }
+
+  if (adjacency_.getNumTiles() != 0
+      && adjacency_.getNumTiles() != tiles_.size()) {
+    throw std::invalid_argument("Adjacency does not match the board.");
+  }
+
+  clearOwners();
+  connectTiles();
+  setTileStates(states);
+  d_.setGrid(grid_);
 }
 
 
-std::list<Board::tile_iterator> Board::getTilesByColor(Color c) const
+std::list<Board::tile_iterator> Board::getTilesByOwner(
+  Tile::owner_t owner) const
 {
-  std::list<tile_iterator> to_return;
+  std::vector<tile_id_t> ids;
+  if (owner < first_owned_.size()) {
+    for (tile_id_t id = first_owned_[owner]
+        ; id != TileGrid::NO_TILE
+        ; id = next_owned_[id])
+    {
+      ids.push_back(id);
+    }
+  }
+  std::sort(std::begin(ids), std::end(ids));
 
-  for (tile_iterator cur = std::begin(tiles_)
-      ; cur != std::end(tiles_)
-      ; ++cur)
+  std::list<tile_iterator> to_return;
+  for (tile_id_t id : ids)
   {
-    if ((*cur).getColor() == c) {
-      to_return.push_back(cur);
-    }
+    to_return.push_back(std::begin(tiles_) + id);
   }
 
   return to_return;
@@ -262,130 +222,505 @@ std::list<Board::tile_iterator> Board::getAdjacentTiles(const Tile& t) const
 {
   std::list<tile_iterator> to_return;
 
-  for (tile_iterator cur = std::begin(tiles_)
-      ; cur != std::end(tiles_)
-      ; ++cur)
+  const Board::tile_id_t* neighbors = adjacency_.getNeighbors(t.getId());
+  size_t degree = adjacency_.getDegree(t.getId());
+  for (size_t i = 0; i < degree; ++i)
   {
-    if (areAdjacent(t, *cur)) {
-      to_return.push_back(cur);
-    }
+    to_return.push_back(std::begin(tiles_) + neighbors[i]);
   }
 
   return to_return;
 }
 
 
-void Board::setTileColor(size_t tile_id, Color c)
+void Board::getFrontlineIds(
+  Tile::owner_t owner
+  , std::vector<tile_id_t>& ids) const
+{
+  ids.clear();
+  if (owner >= first_owned_.size()) { return; }
+
+  for (tile_id_t id = first_owned_[owner]
+      ; id != TileGrid::NO_TILE
+      ; id = next_owned_[id])
+  {
+    const Board::tile_id_t* neighbors = adjacency_.getNeighbors(id);
+    size_t degree = adjacency_.getDegree(id);
+    for (size_t i = 0; i < degree; ++i)
+    {
+      if (tiles_[neighbors[i]].getOwner() != owner) {
+        ids.push_back(id);
+        break;
+      }
+    }
+  }
+
+  // The list is in whatever order the tiles changed hands
+  std::sort(std::begin(ids), std::end(ids));
+}
+
+
+void Board::getEnemyNeighborIds(
+  size_t id
+  , std::vector<tile_id_t>& ids) const
 {
-  getTileById(tile_id).setColor(c);
+  ids.clear();
+
+  Tile::owner_t owner = tiles_[id].getOwner();
+  const Board::tile_id_t* neighbors = adjacency_.getNeighbors(id);
+  size_t degree = adjacency_.getDegree(id);
+  for (size_t i = 0; i < degree; ++i)
+  {
+    if (tiles_[neighbors[i]].getOwner() != owner) {
+      ids.push_back(neighbors[i]);
+    }
+  }
 }
 
 
-void Board::draw() const
+bool Board::solveEndgame(
+  Tile::owner_t owner
+  , std::vector<EndgameSolver::Move>& moves) const
 {
-  // Draw each tile one by one
-  for (const Tile& t : tiles_)
+  moves.clear();
+
+  if (owner >= num_owned_.size() || num_owned_[owner] == 0) { return false; }
+
+  // Everybody still holding tiles, in turn order starting after the owner
+  size_t num_ids = turn_order_.empty()
+    ? num_owned_.size()
+    : turn_order_.size();
+  auto id_at = [&](size_t i)
   {
-    std::vector<size_t> coordinates = t.getCoordinates();
-    Color cur_color = t.getColor();
-    // This is okay because we will never have double-digits numbers
-    char dice_num = std::to_string(t.getNumDice()).front();
-    auto character = Display::getDisplayableCharacter(cur_color, dice_num);
+    return turn_order_.empty()
+      ? static_cast<Tile::owner_t> (i)
+      : turn_order_[i];
+  };
+  size_t start = 0;
+  while (start < num_ids && id_at(start) != owner) { ++start; }
+  if (start == num_ids) { return false; }
+
+  const EndgameSolver::Limits& limits = endgame_.getLimits();
+  Tile::owner_t seats[EndgameSolver::MAX_SEATS] = { owner };
+  size_t num_seats = 1;
+  for (size_t i = 1; i < num_ids; ++i)
+  {
+    Tile::owner_t id = id_at((start + i) % num_ids);
+    if (num_owned_[id] == 0) { continue; }
+    if (num_seats == limits.max_players) { return false; }
 
-    d_.drawValue(coordinates, character);
+    seats[num_seats++] = id;
   }
+
+  Trace::Span span ("Board::solveEndgame");
+
+  return endgame_.solve(*this, seats, num_seats, moves);
 }
 
 
-void Board::fight(std::mt19937& rng, size_t attacker_id, size_t defender_id)
+Board::tile_iterator Board::getTileAt(Tile::coord_t coord) const
 {
-  Tile& attacker = getTileById(attacker_id);
-  Tile& defender = getTileById(defender_id);
+  if (coord >= width_ * height_ || grid_->at(coord) == TileGrid::NO_TILE) {
+    return std::end(tiles_);
+  }
+
+  return std::begin(tiles_) + grid_->at(coord);
+}
 
-  size_t attacker_dice = attacker.getNumDice();
-  size_t defender_dice = defender.getNumDice();
-  size_t attacker_total = 0, defender_total = 0;
 
-  std::ostringstream status;
+Board::tile_iterator Board::getTileAt(size_t x, size_t y) const
+{
+  if (x >= width_ || y >= height_) { return std::end(tiles_); }
+
+  return getTileAt(y * width_ + x);
+}
 
 
-  // Get attacker total, print
-  for (size_t i = 0; i < attacker_dice; ++i) {
-    attacker_total += (rng() % 6) + 1;
+void Board::getCentroid(const Tile& t, double& x, double& y) const
+{
+  x = centroids_[t.getId()].first;
+  y = centroids_[t.getId()].second;
+}
+
+
+void Board::getTileStates(std::vector<TileState>& states) const
+{
+  states.resize(tiles_.size());
+  for (const Tile& tile : tiles_)
+  {
+    TileState& state = states[tile.getId()];
+    state.owner = tile.getOwner();
+    state.num_dice = static_cast<std::uint8_t> (tile.getNumDice());
+  }
+}
+
+
+void Board::setTileOwner(size_t tile_id, Tile::owner_t owner)
+{
+  Tile& tile = getTileById(tile_id);
+  Tile::owner_t old_owner = tile.getOwner();
+  setOwner(tile, owner);
+  evaluation_.update(*this, tile_id, old_owner);
+}
+
+
+void Board::setTileStates(const std::vector<TileState>& states)
+{
+  if (states.size() != tiles_.size()) {
+    throw std::invalid_argument("Tile states do not match the board.");
   }
-  status << "Attacker > " << attacker_total;
-  d_.printMessage(status.str());
-  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+  for (Tile& tile : tiles_)
+  {
+    const TileState& state = states[tile.getId()];
+    setOwner(tile, state.owner);
+    tile.setNumDice(state.num_dice);
+  }
+
+  // Every tile may have changed, so it is quicker to start over
+  evaluation_.reset(*this);
+  planner_.reserve(tiles_.size());
+}
 
 
-  // Get defender total, print
-  for (size_t i = 0; i < defender_dice; ++i) {
-    defender_total += (rng() % 6) + 1;
+void Board::setBankedDice(Tile::owner_t owner, size_t num_dice)
+{
+  if (owner >= banked_dice_.size()) {
+    throw std::invalid_argument("No player can have that id.");
   }
+
+  banked_dice_[owner] = std::min<size_t>(num_dice, GameRules::MAX_BANKED_DICE);
+}
+
+
+void Board::setTurnOrder(const std::vector<Tile::owner_t>& ids)
+{
+  for (Tile::owner_t id : ids)
+  {
+    if (id >= num_owned_.size()) {
+      throw std::invalid_argument("No player can have that id.");
+    }
+  }
+
+  turn_order_ = ids;
+}
+
+
+void Board::draw() const
+{
+  Trace::Span span ("Board::draw");
+
+  d_.drawBoard(tiles_);
+}
+
+
+void Board::fight(std::mt19937& rng, size_t attacker_id, size_t defender_id)
+{
+  Trace::Span span ("Board::fight");
+
+  size_t attacker_dice = getTileById(attacker_id).getNumDice();
+  size_t defender_dice = getTileById(defender_id).getNumDice();
+  size_t attacker_total = GameRules::roll(rng, attacker_dice);
+  size_t defender_total = GameRules::roll(rng, defender_dice);
+
+  resolveFight(attacker_id, defender_id, attacker_total, defender_total);
+}
+
+
+void Board::resolveFight(
+  size_t attacker_id
+  , size_t defender_id
+  , size_t attacker_total
+  , size_t defender_total)
+{
+  Tile& attacker = getTileById(attacker_id);
+  Tile& defender = getTileById(defender_id);
+
+  // Written into a buffer on the stack, so that fights never allocate
+  char status[64];
+
+
+  // Print attacker total
+  std::snprintf(status, sizeof(status), "Attacker > %zu", attacker_total);
+  d_.printMessage(status);
+  d_.pause(500);
+
+
+  // Print defender total
   // pad status with 10 spaces
-  status << "          " << defender_total << " < Defender";
-  d_.printMessage(status.str());
-  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  std::snprintf(
+    status
+    , sizeof(status)
+    , "Attacker > %zu          %zu < Defender"
+    , attacker_total
+    , defender_total);
+  d_.printMessage(status);
+  d_.pause(500);
   d_.clearMessageBar();
 
 
   // Attacker won
+  Tile::owner_t defender_owner = defender.getOwner();
   if (attacker_total > defender_total) {
-    defender.setNumDice(attacker_dice - 1);
-    defender.setColor(attacker.getColor());
+    defender.setNumDice(attacker.getNumDice() - 1);
+    setOwner(defender, attacker.getOwner());
   }
 
   // In all cases, attacker's tile gets reduced to 1.
   attacker.setNumDice(1);
+  evaluation_.update(*this, attacker_id, attacker.getOwner());
+  evaluation_.update(*this, defender_id, defender_owner);
+
+  if (fight_observer_) {
+    fight_observer_(attacker_id, defender_id, attacker_total, defender_total);
+  }
 
   // Show updated tiles
   draw();
 }
 
 
-bool Board::areAdjacent(const Tile& t1, const Tile& t2) const
+void Board::reinforce(std::mt19937& rng, Tile::owner_t owner)
+{
+  if (owner >= first_owned_.size()) {
+    throw std::invalid_argument("No player can have that id.");
+  }
+
+  Trace::Span span ("Board::reinforce");
+
+  // In id order, so where the dice go does not depend on the order the
+  // tiles changed hands
+  room_.clear();
+  for (tile_id_t id = first_owned_[owner]
+      ; id != TileGrid::NO_TILE
+      ; id = next_owned_[id])
+  {
+    if (tiles_[id].getNumDice() < Tile::MAX_DICE_PER_TILE) {
+      room_.push_back(id);
+    }
+  }
+  std::sort(std::begin(room_), std::end(room_));
+
+  // The largest group is kept up to date as tiles change hands, so it costs
+  // nothing to find
+  size_t num_dice = banked_dice_[owner]
+    + evaluation_.getFeatures(*this, owner).largest_region;
+  size_t num_open = room_.size();
+  for (; num_dice > 0 && num_open > 0; --num_dice)
+  {
+    size_t i = std::uniform_int_distribution<size_t>(0, num_open - 1)(rng);
+    Tile& tile = tiles_[room_[i]];
+    tile.incNumDice();
+    ++added_[room_[i]];
+
+    // Tiles that fill up are moved past the ones that still have room
+    if (tile.getNumDice() == Tile::MAX_DICE_PER_TILE) {
+      std::swap(room_[i], room_[--num_open]);
+    }
+  }
+  banked_dice_[owner] = std::min<size_t>(num_dice, GameRules::MAX_BANKED_DICE);
+
+  for (tile_id_t id : room_)
+  {
+    if (added_[id] == 0) { continue; }
+
+    evaluation_.update(*this, id, owner);
+    if (reinforcement_observer_) { reinforcement_observer_(id, added_[id]); }
+    added_[id] = 0;
+  }
+
+  draw();
+}
+
+
+void Board::addDice(size_t tile_id, size_t num_dice)
+{
+  Tile& tile = getTileById(tile_id);
+  tile.setNumDice(tile.getNumDice() + num_dice);
+  evaluation_.update(*this, tile_id, tile.getOwner());
+}
+
+
+Board::Generator Board::parseGenerator(const std::string& name)
+{
+  if (name == "walk") { return Generator::RANDOM_WALK; }
+  if (name == "voronoi") { return Generator::VORONOI; }
+
+  throw std::invalid_argument("Unknown map generator: " + name);
+}
+
+
+void Board::connectTiles()
 {
-  // Since, to determine if a tile is adjacent, we only need to check one,
-  // we will only mark the one with the lower id.
+  // Find the center of each tile
+  centroids_.resize(tiles_.size());
+  for (const Tile& tile : tiles_)
+  {
+    double sum_x = 0, sum_y = 0;
+    for (Tile::coord_t coord : tile.getCoordinates())
+    {
+      sum_x += coord % width_;
+      sum_y += coord / width_;
+    }
 
-  Tile::coord_t smaller = std::min(t1.getId(), t2.getId());
-  Tile::coord_t larger = std::max(t1.getId(), t2.getId());
+    double num_coords = tile.getCoordinates().size();
+    centroids_[tile.getId()] =
+      std::make_pair(sum_x / num_coords, sum_y / num_coords);
+  }
 
-  Tile::coord_t index = get_adjacency_index(smaller, larger);
+  // Find which tiles border each other, unless we already know
+  if (adjacency_.getNumTiles() == 0) {
+    adjacency_ = Adjacency(*grid_, tiles_.size());
+  }
 
-  return adjacency_[index];
+  evaluation_.reset(*this);
 }
 
 
-void Board::markAdjacent(const Tile& t1, const Tile& t2)
+void Board::renumberTiles(std::vector<tile_id_t>& occupied)
 {
-  // Since, to determine if a tile is adjacent, we only need to check one,
-  // we will only mark the one with the lower id.
+  std::vector<std::pair<double, double>> centroids (tiles_.size());
+  for (const Tile& tile : tiles_)
+  {
+    double sum_x = 0, sum_y = 0;
+    for (Tile::coord_t coord : tile.getCoordinates())
+    {
+      sum_x += coord % width_;
+      sum_y += coord / width_;
+    }
+
+    double num_coords = tile.getCoordinates().size();
+    centroids[tile.getId()] =
+      std::make_pair(sum_x / num_coords, sum_y / num_coords);
+  }
+
+  std::vector<tile_id_t> new_ids = orderAlongCurve(width_, height_, centroids);
 
-  Tile::coord_t smaller = std::min(t1.getId(), t2.getId());
-  Tile::coord_t larger = std::max(t1.getId(), t2.getId());
+  std::vector<Tile> renumbered (tiles_.size());
+  for (Tile& tile : tiles_)
+  {
+    tile_id_t id = new_ids[tile.getId()];
+    tile.setId(id);
+    renumbered[id] = std::move(tile);
+  }
+  tiles_ = std::move(renumbered);
 
-  Tile::coord_t index = get_adjacency_index(smaller, larger);
+  for (tile_id_t& id : occupied)
+  {
+    if (id != TileGrid::NO_TILE) { id = new_ids[id]; }
+  }
 
-  adjacency_[index] = true;
+  // Generators that found the borders already need them renumbered too
+  if (adjacency_.getNumTiles() != 0) {
+    adjacency_ = adjacency_.renumber(new_ids);
+  }
+}
+
+
+std::vector<Board::tile_id_t> Board::orderAlongCurve(
+  size_t width
+  , size_t height
+  , const std::vector<std::pair<double, double>>& centroids)
+{
+  std::uint64_t side = 1;
+  while (side < width || side < height) { side *= 2; }
+
+  std::vector<std::pair<std::uint64_t, size_t>> keys (centroids.size());
+  for (size_t id = 0; id < centroids.size(); ++id)
+  {
+    keys[id] = std::make_pair(
+      hilbert_index(
+        static_cast<std::uint64_t> (centroids[id].first + 0.5)
+        , static_cast<std::uint64_t> (centroids[id].second + 0.5)
+        , side)
+      , id);
+  }
+
+  // Tiles whose centers round to the same space keep their old order
+  std::sort(std::begin(keys), std::end(keys));
+
+  std::vector<tile_id_t> new_ids (centroids.size());
+  for (size_t i = 0; i < keys.size(); ++i)
+  {
+    new_ids[keys[i].second] = static_cast<tile_id_t> (i);
+  }
+
+  return new_ids;
+}
+
+
+bool Board::areAdjacent(const Tile& t1, const Tile& t2) const
+{
+  return adjacency_.areAdjacent(t1.getId(), t2.getId());
 }
 
 
 Tile& Board::getTileById(size_t id)
 {
-  for (Tile& t : tiles_)
+  if (id >= tiles_.size()) {
+    throw std::out_of_range("No tile with the given id exists.");
+  }
+
+  return tiles_[id];
+}
+
+
+void Board::clearOwners()
+{
+  next_owned_.assign(tiles_.size(), TileGrid::NO_TILE);
+  prev_owned_.assign(tiles_.size(), TileGrid::NO_TILE);
+  first_owned_.fill(TileGrid::NO_TILE);
+  num_owned_.fill(0);
+  banked_dice_.fill(0);
+
+  room_.reserve(tiles_.size());
+  added_.assign(tiles_.size(), 0);
+
+  for (Tile& tile : tiles_)
   {
-    if (t.getId() == id) {
-      return t;
+    tile.setOwner(Tile::NO_OWNER);
+  }
+}
+
+
+void Board::setOwner(Tile& tile, Tile::owner_t owner)
+{
+  Tile::owner_t old_owner = tile.getOwner();
+  if (owner == old_owner) { return; }
+
+  if (owner != Tile::NO_OWNER && owner >= first_owned_.size()) {
+    throw std::invalid_argument("No player can have that id.");
+  }
+
+  tile_id_t id = static_cast<tile_id_t> (tile.getId());
+
+  // Take it off the old owner's list
+  if (old_owner != Tile::NO_OWNER) {
+    tile_id_t prev = prev_owned_[id], next = next_owned_[id];
+    if (prev != TileGrid::NO_TILE) { next_owned_[prev] = next; }
+    else { first_owned_[old_owner] = next; }
+    if (next != TileGrid::NO_TILE) { prev_owned_[next] = prev; }
+    --num_owned_[old_owner];
+  }
+
+  // And put it at the front of the new owner's
+  prev_owned_[id] = TileGrid::NO_TILE;
+  next_owned_[id] = TileGrid::NO_TILE;
+  if (owner != Tile::NO_OWNER) {
+    next_owned_[id] = first_owned_[owner];
+    if (first_owned_[owner] != TileGrid::NO_TILE) {
+      prev_owned_[first_owned_[owner]] = id;
     }
+    first_owned_[owner] = id;
+    ++num_owned_[owner];
   }
 
-  throw std::out_of_range("No tile with the given id exists.");
+  tile.setOwner(owner);
 }
 
 
-std::list<Board::tile_iterator> Board::filterColoredTiles(
-  Color c,
+std::list<Board::tile_iterator> Board::filterOwnedTiles(
+  Tile::owner_t owner,
   std::list<Board::tile_iterator> tiles)
 {
   // This will be used to keep track of tiles we're going to remove from tiles.
@@ -395,12 +730,12 @@ std::list<Board::tile_iterator> Board::filterColoredTiles(
     ; cur != std::end(tiles)
     ; ++cur)
   {
-    if ((**cur).getColor() == c) {
+    if ((**cur).getOwner() == owner) {
       to_erase.push_back(cur);
     }
   }
 
-  // Delete the tiles of the given color from the passed-in tiles.
+  // Delete the tiles of the given owner from the passed-in tiles.
   for(std::list<Board::tile_iterator>::iterator cur : to_erase)
   {
     tiles.erase(cur);
@@ -425,7 +760,7 @@ std::list<Board::tile_iterator> Board::filterForFrontlineTiles(
     bool is_frontline = false;
     for (Board::tile_iterator tile : adjacent)
     {
-      if ((*tile).getColor() != (**cur).getColor()) {
+      if ((*tile).getOwner() != (**cur).getOwner()) {
         is_frontline = true;
         break;
       }
@@ -474,6 +809,182 @@ std::list<Board::tile_iterator> Board::filterForMultipleDice(
 }
 
 
+void Board::generateRandomWalk(
+  std::mt19937& rng
+  , std::vector<tile_id_t>& occupied
+  , size_t num_tiles)
+{
+  size_t width = width_, height = height_;
+  size_t num_spaces = width * height;
+  size_t num_generated = 0;
+  size_t min_size_per_tile, max_size_per_tile;
+  get_tile_size_limits(
+    num_spaces
+    , num_tiles
+    , min_size_per_tile
+    , max_size_per_tile);
+  size_t max_attempts = 100;
+
+  occupied.assign(num_spaces, TileGrid::NO_TILE);
+
+  // We will use this so that we don't accidentally pick a starting point for
+  // a tile that is in-use by another tile
+  std::vector<size_t> space_weights (num_spaces, 1);
+
+  // Generate each tile (A tile consists of multiple spaces)
+  for (size_t percent_generated = 0
+      ; percent_generated < 80
+      ; percent_generated = 100 * num_generated / num_spaces)
+  {
+    Tile cur_tile;
+
+    // Pick a random starting space
+    std::discrete_distribution<Tile::coord_t> starting_weights (
+      std::begin(space_weights)
+      , std::end(space_weights));
+    Tile::coord_t starting_coord = starting_weights(rng);
+    Tile::coord_t coord = starting_coord;
+
+    // Figure out which nearby tiles are open and add then to another vector of
+    // weights for picking where to go next
+    std::vector<double> next_space_weights (num_spaces, 0);
+    size_t cur_tile_size = 1;
+
+    // Let tile know it owns this space
+    cur_tile.addCoordindate(coord);
+
+    // Generate tile based on starting point
+    bool success = false;
+    for(;;)
+    {
+      // Find an adjacent space
+      // Left available?
+      size_t new_coord = coord - 1;
+      if ((coord % width != 0)
+          && (occupied[new_coord] == TileGrid::NO_TILE)) {
+        next_space_weights[new_coord] = DBL_MAX;
+      }
+      // Right available?
+      new_coord = coord + 1;
+      if ((coord % width != (width - 1))
+          && (occupied[new_coord] == TileGrid::NO_TILE)) {
+        next_space_weights[new_coord] = DBL_MAX;
+      }
+      // Up?
+      new_coord = coord - width;
+      if (((coord / width) != 0)
+          && (occupied[new_coord] == TileGrid::NO_TILE)) {
+        next_space_weights[new_coord] = DBL_MAX;
+      }
+      // Down?
+      new_coord = coord + width;
+      if (((coord / width) != (height - 1))
+          && (occupied[new_coord] == TileGrid::NO_TILE)) {
+        next_space_weights[new_coord] = DBL_MAX;
+      }
+
+      // Calculate the weights for these new points, check for any valid weights
+      bool no_valid_weights = true;
+      for (Tile::coord_t space = 0; space < num_spaces; ++space)
+      {
+        double& weight = next_space_weights[space];
+        if (weight == DBL_MAX) {
+          weight = (num_spaces / 2) - get_dist(starting_coord, space, width);
+        }
+        if (weight != 0) { no_valid_weights = false; }
+      }
+
+      // Can't find next space
+      if (no_valid_weights) {
+        size_t cur_tile_size = cur_tile.getCoordinates().size();
+
+        success = (cur_tile_size >= min_size_per_tile)
+            && (cur_tile_size <= max_size_per_tile);
+
+        break;
+      }
+
+      // Find the next space
+      std::discrete_distribution<Tile::coord_t> next_space (
+        std::begin(next_space_weights)
+        , std::end(next_space_weights));
+      coord = next_space(rng);
+      next_space_weights[coord] = 0;
+
+      // If we ran out of attempts, stop and do not add this tile
+      if (occupied[coord] != TileGrid::NO_TILE) {
+        // Unmark all the spaces this tile occupied
+        for(Tile::coord_t coord : cur_tile.getCoordinates())
+        {
+          occupied[coord] = TileGrid::NO_TILE;
+        }
+        break;
+      }
+
+      cur_tile.addCoordindate(coord);
+
+      // Stop adding spaces if too big
+      if (++cur_tile_size >= min_size_per_tile) {
+        success = true;
+        break;
+      }
+    }
+
+    // Tile generation was successful
+    if (success) {
+      num_generated += cur_tile.getCoordinates().size();
+      if (tiles_.size() == TileGrid::NO_TILE) {
+        throw std::length_error("Board has too many tiles to number.");
+      }
+
+      Board::tile_id_t cur_id = static_cast<Board::tile_id_t> (tiles_.size());
+      cur_tile.setId(cur_id);
+      tiles_.push_back(std::move(cur_tile));
+
+      const std::vector<Tile::coord_t>& cur_coordinates =
+        tiles_.back().getCoordinates();
+
+      // Mark spaces as occupied by this tile
+      for (Tile::coord_t cur_coord : cur_coordinates)
+      {
+        occupied[cur_coord] = cur_id;
+        space_weights[cur_coord] = 0;
+      }
+    }
+  }
+}
+
+
+void Board::generateVoronoi(
+  std::mt19937& rng
+  , std::vector<tile_id_t>& occupied
+  , size_t num_tiles)
+{
+  // The same limits on the size of a tile as the random walk
+  size_t num_spaces = width_ * height_;
+  size_t min_tile_size, max_tile_size;
+  get_tile_size_limits(num_spaces, num_tiles, min_tile_size, max_tile_size);
+  VoronoiGenerator generator (width_, height_, min_tile_size, max_tile_size);
+
+  std::vector<VoronoiGenerator::border_t> borders;
+  size_t num_generated = generator.generate(rng, occupied, borders);
+
+  tiles_.resize(num_generated);
+  for (size_t id = 0; id < num_generated; ++id)
+  {
+    tiles_[id].setId(id);
+  }
+  for (Tile::coord_t coord = 0; coord < num_spaces; ++coord)
+  {
+    if (occupied[coord] != TileGrid::NO_TILE) {
+      tiles_[occupied[coord]].addCoordindate(coord);
+    }
+  }
+
+  adjacency_ = Adjacency(num_generated, std::move(borders));
+}
+
+
 /***********************************
  * HELPER FUNCTION IMPLEMENTATIONS *
  ***********************************/
@@ -485,12 +996,43 @@ double get_dist(Tile::coord_t p1, Tile::coord_t p2, size_t width)
     , p2_x    = p2 % width
     , p2_y    = p2 / width;
 
-  return sqrt(std::pow(p1_x - p2_x, 2) + (p1_y - p2_y));
+  return std::sqrt(std::pow(p1_x - p2_x, 2) + std::pow(p1_y - p2_y, 2));
 }
 
 
-inline size_t get_adjacency_index(Tile::coord_t c1, Tile::coord_t c2)
+std::uint64_t hilbert_index(
+  std::uint64_t x
+  , std::uint64_t y
+  , std::uint64_t side)
 {
-  return (c2 * (c2 - 1) / 2) + c1;
+  std::uint64_t index = 0;
+  for (std::uint64_t half = side / 2; half > 0; half /= 2)
+  {
+    std::uint64_t right = (x & half) ? 1 : 0;
+    std::uint64_t lower = (y & half) ? 1 : 0;
+    index += half * half * ((3 * right) ^ lower);
+
+    // Turn the quadrant so the curve inside it starts where it came in
+    if (lower == 0) {
+      if (right == 1) {
+        x = side - 1 - x;
+        y = side - 1 - y;
+      }
+      std::swap(x, y);
+    }
+  }
+
+  return index;
 }
 
+
+void get_tile_size_limits(
+  size_t num_spaces
+  , size_t num_tiles
+  , size_t& min_size
+  , size_t& max_size)
+{
+  // The usual 25 tiles makes tiles of a 30th to a 25th of the board
+  min_size = std::max<size_t>(num_spaces * 5 / (num_tiles * 6), 1);
+  max_size = std::max<size_t>(num_spaces / num_tiles, 1);
+}
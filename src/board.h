@@ -1,11 +1,25 @@
 #ifndef BOARD_H
 #define BOARD_H
 
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <list>
-#include "color.h"
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+#include "adjacency.h"
+#include "attack_planner.h"
 #include "display.h"
+#include "endgame_solver.h"
+#include "evaluation.h"
+#include "frame.h"
 #include "player.h"
+#include "rules.h"
 #include "tile.h"
+#include "tile_grid.h"
 
 class Board
 {
@@ -16,18 +30,73 @@ class Board
      * CONSTRUCTORS *
      ****************/
 
+    /**
+     * Ways of dividing a board into tiles.
+     */
+    enum class Generator : std::uint8_t
+    {
+      RANDOM_WALK // Grows each tile by a random walk, retrying on collisions
+      , VORONOI // Regions around scattered sites; see VoronoiGenerator
+    };
+
+    /**
+     * Generates a new board.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {Display&} d The display to show the board on.
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {Generator} generator How to divide the board into tiles.
+     * @param {size_t} num_tiles About how many tiles to divide it into. Large
+     * numbers suit the Voronoi generator, since the random walk slows down
+     * with every tile.
+     */
     Board(
       std::mt19937& rng
       , Display& d
       , const size_t width
-      , const size_t height);
+      , const size_t height
+      , Generator generator = Generator::RANDOM_WALK
+      , size_t num_tiles = DEFAULT_NUM_TILES);
+
+    /**
+     * Rebuilds a board that was generated earlier, such as one from a saved
+     * game.
+     *
+     * @param {Display&} d The display to show the board on.
+     * @param {std::shared_ptr<const TileGrid>} grid Which tile is where.
+     * @param {std::vector<TileState>} states The owner and dice of every tile,
+     * indexed by id.
+     * @param {Adjacency} adjacency Which tiles border each other, or an empty
+     * one to work it out from the grid.
+     */
+    Board(
+      Display& d
+      , std::shared_ptr<const TileGrid> grid
+      , const std::vector<TileState>& states
+      , Adjacency adjacency = Adjacency());
 
 
     /*********
      * TYPES *
      *********/
 
-    using tile_iterator = std::list<Tile>::const_iterator;
+    using tile_iterator = std::vector<Tile>::const_iterator;
+
+    using tile_id_t = TileGrid::tile_id_t;
+
+    /**
+     * Told about every fight once it has been decided, with the ids of the
+     * attacking and defending tiles and what each side rolled.
+     */
+    using fight_observer_t =
+      std::function<void(size_t, size_t, size_t, size_t)>;
+
+    /**
+     * Told about every tile given dice at the end of a turn, with its id and
+     * how many dice it was given.
+     */
+    using reinforcement_observer_t = std::function<void(size_t, size_t)>;
 
 
     /***********
@@ -39,27 +108,127 @@ class Board
     /**
      * Returns the beginning of the tiles this board owns.
      *
-     * @returns {std::list<Tile>::iterator} An iterator to the beginning of the
-     * tiles list.
+     * @returns {tile_iterator} An iterator to the beginning of the tiles, which
+     * are ordered by id.
      */
     tile_iterator getTiles() const { return std::begin(tiles_); }
 
     /**
      * Returns the end of the tiles this board owns.
      *
-     * @returns {std::list<Tile>::iterator} An iterator to the end of the tiles
-     * list.
+     * @returns {tile_iterator} An iterator to the end of the tiles.
      */
     tile_iterator getTilesEnd() const { return std::end(tiles_); }
 
     /**
-     * Returns all the tiles that share a particular color.
+     * Returns all the tiles a player owns.
      *
-     * @param {Color} c The color to search for.
+     * @param {Tile::owner_t} owner The player's id.
      * @returns {std::vector<std::list<Tile>::iterator>} A vector of iterators
-     * to access tile objects.
+     * to access tile objects, ordered by id.
      */
-    std::list<tile_iterator> getTilesByColor(Color c) const;
+    std::list<tile_iterator> getTilesByOwner(Tile::owner_t owner) const;
+
+    /**
+     * Returns how many tiles a player owns, without looking at any of them.
+     *
+     * @param {Tile::owner_t} owner The player's id.
+     * @returns {size_t} The number of tiles.
+     */
+    size_t getNumTiles(Tile::owner_t owner) const
+    {
+      return owner < num_owned_.size() ? num_owned_[owner] : 0;
+    }
+
+    /**
+     * Returns how many dice a player has banked, for lack of room on their
+     * tiles, to be placed at the end of their next turn.
+     *
+     * @param {Tile::owner_t} owner The player's id.
+     * @returns {size_t} The number of dice.
+     */
+    size_t getBankedDice(Tile::owner_t owner) const
+    {
+      return owner < banked_dice_.size() ? banked_dice_[owner] : 0;
+    }
+
+    /**
+     * Returns how a player stands, by what the AIs judge a position on. This
+     * is kept up to date as tiles change hands, so costs nothing to ask.
+     *
+     * @param {Tile::owner_t} owner The player's id.
+     * @returns {Evaluation::Features} How they stand.
+     */
+    Evaluation::Features getFeatures(Tile::owner_t owner) const
+    {
+      return evaluation_.getFeatures(*this, owner);
+    }
+
+    /**
+     * Returns how the attacker would stand after a fight, without making it.
+     * This only looks at the tiles around the fight.
+     *
+     * @param {size_t} attacker_id The attacking tile's id.
+     * @param {size_t} defender_id The defending tile's id.
+     * @param {bool} won Whether the attacker wins.
+     * @returns {Evaluation::Features} How the attacking player would stand.
+     */
+    Evaluation::Features getFeaturesAfterFight(
+      size_t attacker_id
+      , size_t defender_id
+      , bool won) const
+    {
+      return evaluation_.getFeaturesAfterFight(
+        *this
+        , attacker_id
+        , defender_id
+        , won);
+    }
+
+    /**
+     * Finds the best chain of attacks out of a tile, going by the exact
+     * chance of every fight in it. See AttackPlanner.
+     *
+     * @param {size_t} from The attacking tile's id.
+     * @param {AttackPlanner::Chain&} chain Where the chain is stored.
+     * @returns {bool} False if the tile cannot attack.
+     */
+    bool planAttackChain(size_t from, AttackPlanner::Chain& chain) const
+    {
+      return planner_.plan(*this, from, chain);
+    }
+
+    /**
+     * Finds the best chain of attacks out of a tile starting with each enemy
+     * next to it, best first. Fills a vector like getFrontlineIds.
+     *
+     * @param {size_t} from The attacking tile's id.
+     * @param {std::vector<AttackPlanner::Chain>&} chains Where the chains are
+     * stored.
+     */
+    void getAttackChains(
+      size_t from
+      , std::vector<AttackPlanner::Chain>& chains) const
+    {
+      planner_.getChains(*this, from, chains);
+    }
+
+    /**
+     * Works out how likely every attack of a player's is to win or lose
+     * them the game, if so few tiles are contested and so few players
+     * are left that it can be. See EndgameSolver. The other players move in
+     * the turn order after them. Fills a vector like getFrontlineIds.
+     *
+     * @param {Tile::owner_t} owner The player to move.
+     * @param {std::vector<EndgameSolver::Move>&} moves Where the attacks are
+     * stored, in order of the attacking tile's id and then the defending
+     * tile's.
+     * @returns {bool} False if the position is too big to solve, or the
+     * player cannot attack.
+     */
+    bool solveEndgame(
+      Tile::owner_t owner
+      , std::vector<EndgameSolver::Move>& moves) const;
 
     /**
      * Returns all the tiles that share a border with the provided tile.
@@ -70,22 +239,176 @@ class Board
      */
     std::list<tile_iterator> getAdjacentTiles(const Tile& t) const;
 
+    /**
+     * Finds the tiles of a player that border a tile of anybody else, which
+     * are the tiles that player can attack from. Only the player's own tiles
+     * are looked at, so this costs the same however many players share the
+     * board. Fills a vector instead of returning one, so that a vector kept
+     * between turns never allocates.
+     *
+     * @param {Tile::owner_t} owner The player's id.
+     * @param {std::vector<tile_id_t>&} ids Where the ids are stored, in order.
+     */
+    void getFrontlineIds(
+      Tile::owner_t owner
+      , std::vector<tile_id_t>& ids) const;
+
+    /**
+     * Finds the tiles that border a tile and belong to somebody else, which
+     * are the tiles it can attack. Fills a vector like getFrontlineIds.
+     *
+     * @param {size_t} id The tile.
+     * @param {std::vector<tile_id_t>&} ids Where the ids are stored, in order.
+     */
+    void getEnemyNeighborIds(size_t id, std::vector<tile_id_t>& ids) const;
+
+    /**
+     * Returns the tile occupying a space on the board in constant time.
+     *
+     * @param {Tile::coord_t|size_t, size_t} coord The space, either as an index
+     * or as x and y values.
+     * @returns {tile_iterator} The tile, or the end of the tiles if no tile
+     * occupies the space (or it is off the board).
+     */
+    tile_iterator getTileAt(Tile::coord_t coord) const;
+    tile_iterator getTileAt(size_t x, size_t y) const;
+
+    /**
+     * Gets the center of a tile, measured in spaces from the upper left-hand
+     * corner of the board.
+     *
+     * @param {Tile} t The tile.
+     * @param {double&} x Where the result's x-value is stored.
+     * @param {double&} y Where the result's y-value is stored.
+     */
+    void getCentroid(const Tile& t, double& x, double& y) const;
+
+    size_t getWidth() const { return width_; }
+    size_t getHeight() const { return height_; }
+
+    /**
+     * Returns which tile occupies each space.
+     *
+     * @returns {const TileGrid&} The grid.
+     */
+    const TileGrid& getGrid() const { return *grid_; }
+
+    /**
+     * Returns which tiles border each other.
+     *
+     * @returns {const Adjacency&} The neighbors of every tile.
+     */
+    const Adjacency& getAdjacency() const { return adjacency_; }
+
+    /**
+     * Copies out the owner and number of dice of every tile.
+     *
+     * @param {std::vector<TileState>&} states Where the states are stored,
+     * indexed by tile id.
+     */
+    void getTileStates(std::vector<TileState>& states) const;
+
 
     /*** SETTERS ***/
 
     /**
-     * Sets the tile with the given id to the provided color.
+     * Gives the tile with the given id to a player.
+     *
+     * @param {size_t} tile_id The id of the tile.
+     * @param {Tile::owner_t} owner The player's id, or Tile::NO_OWNER.
+     */
+    void setTileOwner(size_t tile_id, Tile::owner_t owner);
+
+    /**
+     * Sets the owner and number of dice of every tile, such as when resuming
+     * a replay.
      *
-     * @param {size_t} tile_id The id of the tile to set the color of.
-     * @param {Color} c The color to set the tile to.
+     * @param {std::vector<TileState>} states The new states, indexed by tile
+     * id. There must be one for every tile.
      */
-    void setTileColor(size_t tile_id, Color c);
+    void setTileStates(const std::vector<TileState>& states);
+
+    /**
+     * Sets how many dice a player has banked, such as when resuming a game.
+     *
+     * @param {Tile::owner_t} owner The player's id.
+     * @param {size_t} num_dice The number of dice, up to
+     * GameRules::MAX_BANKED_DICE.
+     */
+    void setBankedDice(Tile::owner_t owner, size_t num_dice);
+
+    /**
+     * Sets the order players take turns in, which solveEndgame plays out.
+     * Players may be left in it once they are out of the game. Until it is
+     * set, players take turns in order of id.
+     *
+     * @param {std::vector<Tile::owner_t>} ids The players' ids, in order.
+     */
+    void setTurnOrder(const std::vector<Tile::owner_t>& ids);
+
+    /**
+     * Sets what is told about every fight on this board.
+     *
+     * @param {fight_observer_t} observer The observer, or nullptr for none.
+     */
+    void setFightObserver(fight_observer_t observer)
+    {
+      fight_observer_ = std::move(observer);
+    }
+
+    /**
+     * Sets what is told about every tile given dice at the end of a turn.
+     *
+     * @param {reinforcement_observer_t} observer The observer, or nullptr for
+     * none.
+     */
+    void setReinforcementObserver(reinforcement_observer_t observer)
+    {
+      reinforcement_observer_ = std::move(observer);
+    }
+
+    /**
+     * Sets which positions solveEndgame works out exactly.
+     *
+     * @param {EndgameSolver::Limits} limits The limits.
+     */
+    void setEndgameLimits(const EndgameSolver::Limits& limits)
+    {
+      endgame_.setLimits(limits);
+    }
 
 
     /*** UTILITY ***/
 
     /**
-     * Prints the current state of the board to the screen.
+     * Finds a generator by the name used on the command line.
+     *
+     * @param {std::string} name "walk" or "voronoi".
+     * @returns {Generator} The generator. Throws if there is none by that
+     * name.
+     */
+    static Generator parseGenerator(const std::string& name);
+
+    /**
+     * Numbers tiles in the order a Hilbert curve passes their centers, so
+     * tiles that are close on the board are close in id too, and so are the
+     * things stored by id for them.
+     *
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {std::vector<std::pair<double, double>>} centroids The center of
+     * every tile as (x, y), indexed by id.
+     * @returns {std::vector<tile_id_t>} The new id of every tile, indexed by
+     * its old one.
+     */
+    static std::vector<tile_id_t> orderAlongCurve(
+      size_t width
+      , size_t height
+      , const std::vector<std::pair<double, double>>& centroids);
+
+    /**
+     * Hands the current state of every tile to the display, which draws the
+     * visible part of the board on its own thread.
      */
     void draw() const;
 
@@ -99,14 +422,49 @@ class Board
     void fight(std::mt19937& rng, size_t attacker_id, size_t defender_id);
 
     /**
-     * Removes tiles that have a particular Color.
+     * Shows and carries out a fight whose dice have already been rolled.
      *
-     * @param {Color} c The color to filter on.
+     * @param {size_t} attacker_id The attacking tile's id.
+     * @param {size_t} defender_id The defending tile's id.
+     * @param {size_t} attacker_total The sum of the attacker's dice.
+     * @param {size_t} defender_total The sum of the defender's dice. (Wins
+     * ties)
+     */
+    void resolveFight(
+      size_t attacker_id
+      , size_t defender_id
+      , size_t attacker_total
+      , size_t defender_total);
+
+    /**
+     * Gives a player their dice at the end of their turn: one for every tile
+     * in their largest group of touching tiles, plus any they had banked.
+     * Each goes on a random tile of theirs with room for it, and what there
+     * is no room for is banked, up to GameRules::MAX_BANKED_DICE.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {Tile::owner_t} owner The player's id.
+     */
+    void reinforce(std::mt19937& rng, Tile::owner_t owner);
+
+    /**
+     * Adds dice to a tile, up to as many as it can hold, such as when
+     * replaying a reinforcement.
+     *
+     * @param {size_t} tile_id The id of the tile.
+     * @param {size_t} num_dice How many dice to add.
+     */
+    void addDice(size_t tile_id, size_t num_dice);
+
+    /**
+     * Removes tiles that a particular player owns.
+     *
+     * @param {Tile::owner_t} owner The player's id.
      * @param {std::vector<tile_iterator>&} tiles The tiles to filter.
      * @returns {std::vector<tile_iterator>} The filtered tiles.
      */
-    static std::list<tile_iterator> filterColoredTiles(
-      Color c
+    static std::list<tile_iterator> filterOwnedTiles(
+      Tile::owner_t owner
       , std::list<tile_iterator> tiles);
 
     /**
@@ -128,6 +486,14 @@ class Board
       std::list<tile_iterator> tiles);
 
 
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // About how many tiles a board is divided into, unless asked otherwise
+    static const size_t DEFAULT_NUM_TILES = 25;
+
+
   private:
 
     /***********
@@ -135,21 +501,56 @@ class Board
      ***********/
 
     /**
-     * Checks if two Tiles are adjacent on this board.
+     * Finds the center of every tile and, if not already known, which tiles
+     * border each other, once the grid and tiles are in place.
+     */
+    void connectTiles();
+
+    /**
+     * Gives the tiles new ids along a Hilbert curve once they have been
+     * generated, since generators number them in whatever order they happen
+     * to make them.
      *
-     * @param {Tile} t1 The first tile.
-     * @param {Tile} t2 The second tile.
-     * @returns {bool} True if they are adjacent.
+     * @param {std::vector<tile_id_t>&} occupied The tile of every space,
+     * changed to the new ids.
      */
-    bool areAdjacent(const Tile& t1, const Tile& t2) const;
+    void renumberTiles(std::vector<tile_id_t>& occupied);
+
+    /**
+     * Grows tiles one at a time by random walks from random starting spaces,
+     * throwing away any that run into another tile or cannot grow enough.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {std::vector<tile_id_t>&} occupied Where the tile of every space
+     * is stored.
+     * @param {size_t} num_tiles About how many tiles to make.
+     */
+    void generateRandomWalk(
+      std::mt19937& rng
+      , std::vector<tile_id_t>& occupied
+      , size_t num_tiles);
+
+    /**
+     * Divides the board into Voronoi regions, which also gives the adjacency.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {std::vector<tile_id_t>&} occupied Where the tile of every space
+     * is stored.
+     * @param {size_t} num_tiles About how many tiles to make.
+     */
+    void generateVoronoi(
+      std::mt19937& rng
+      , std::vector<tile_id_t>& occupied
+      , size_t num_tiles);
 
     /**
-     * Marks two tiles as adjacent in the Board's adjacency matrix.
+     * Checks if two Tiles are adjacent on this board.
      *
      * @param {Tile} t1 The first tile.
      * @param {Tile} t2 The second tile.
+     * @returns {bool} True if they are adjacent.
      */
-    void markAdjacent(const Tile& t1, const Tile& t2);
+    bool areAdjacent(const Tile& t1, const Tile& t2) const;
 
     /**
      * Finds a tile with the given id.
@@ -159,6 +560,21 @@ class Board
      */
     Tile& getTileById(size_t id);
 
+    /**
+     * Gives every tile back to nobody, empties the lists of who owns what
+     * and everyone's banked dice, once the tiles are in place.
+     */
+    void clearOwners();
+
+    /**
+     * Gives a tile to a player, moving it from one player's list to the
+     * other's.
+     *
+     * @param {Tile&} tile The tile.
+     * @param {Tile::owner_t} owner The player's id, or Tile::NO_OWNER.
+     */
+    void setOwner(Tile& tile, Tile::owner_t owner);
+
 
     /**************
      * PROPERTIES *
@@ -166,8 +582,44 @@ class Board
 
     Display& d_;
     size_t width_, height_;
-    std::list<Tile> tiles_;
-    std::vector<bool> adjacency_;
+    std::vector<Tile> tiles_; // Indexed by id
+    Adjacency adjacency_;
+
+    // The tiles of each player, as lists running through the tiles, so that
+    // a tile changes hands without allocating. Tiles nobody owns are on no
+    // list, and lists end in TileGrid::NO_TILE.
+    std::vector<tile_id_t> next_owned_, prev_owned_; // Indexed by tile id
+    std::array<tile_id_t, GameRules::MAX_NUM_PLAYERS> first_owned_;
+    std::array<size_t, GameRules::MAX_NUM_PLAYERS> num_owned_;
+
+    // Indexed by player id
+    std::array<size_t, GameRules::MAX_NUM_PLAYERS> banked_dice_;
+
+    // The players' ids in the order they take turns, or empty for id order
+    std::vector<Tile::owner_t> turn_order_;
+
+    // What reinforcing works in: the tiles with room for dice, and how many
+    // each was given, indexed by tile id. Kept so that a turn does not
+    // allocate.
+    std::vector<tile_id_t> room_;
+    std::vector<std::uint8_t> added_;
+
+    // What the AIs judge a position by, kept up to date with the tiles
+    Evaluation evaluation_;
+
+    // Only what planning works in, and what solving remembers, so that
+    // neither changes the board
+    mutable AttackPlanner planner_;
+    mutable EndgameSolver endgame_;
+
+    // Which tile occupies each space. Shared with the display.
+    std::shared_ptr<const TileGrid> grid_;
+
+    // The center of each tile as (x, y), indexed by id
+    std::vector<std::pair<double, double>> centroids_;
+
+    fight_observer_t fight_observer_;
+    reinforcement_observer_t reinforcement_observer_;
 
     /* GLOBALS */
 
@@ -0,0 +1,1086 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "adjacency.h"
+#include "attack_planner.h"
+#include "board.h"
+#include "endgame_solver.h"
+#include "evaluation.h"
+#include "fight_odds.h"
+#include "fixture.h"
+#include "headless_display.h"
+#include "map_generator.h"
+#include "rules.h"
+#include "tile.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * A board the checks are run on, and how many players it is dealt to.
+ */
+struct Fixture
+{
+  const char* name;
+  Board::Generator generator;
+  size_t width, height, num_tiles, num_players;
+};
+
+/**
+ * A position played out by brute force, with players numbered by their place
+ * in the turn order from the one to move.
+ */
+struct EndgamePosition
+{
+  // Indexed by tile id
+  std::vector<std::uint8_t> owners, dice;
+
+  std::array<size_t, EndgameSolver::MAX_SEATS> banked;
+
+  // A bit for every seat still playing, and whose turn it is
+  unsigned playing;
+  size_t seat;
+};
+
+// The chance of every seat winning
+using EndgameValues = std::array<double, EndgameSolver::MAX_SEATS>;
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Prints whether a check passed, and what it found.
+ *
+ * @param {std::string} name What was checked.
+ * @param {bool} ok Whether it passed.
+ * @param {std::string} detail What it found.
+ * @returns {bool} Whether it passed.
+ */
+bool report_check(const std::string& name, bool ok, const std::string& detail);
+
+/**
+ * Checks that Voronoi boards of every size come out with about as many tiles
+ * as asked for, and that every tile can be reached from every other, since a
+ * player cut off from everybody else could never be beaten.
+ *
+ * @param {std::uint64_t} seed The seed to start from.
+ * @returns {bool} True if every board passed.
+ */
+bool check_boards(std::uint64_t seed);
+
+/**
+ * Checks the features a board keeps up to date as tiles change hands against
+ * ones worked out from scratch, over many random fights and reinforcements,
+ * and the features predicted for each fight against what it left.
+ *
+ * @param {std::uint64_t} seed The seed to check with.
+ * @returns {bool} True if they always agreed.
+ */
+bool check_evaluation(std::uint64_t seed);
+
+/**
+ * Checks the chains the planner finds against every chain it could have
+ * chosen, over many random deals of each fixture.
+ *
+ * @param {std::uint64_t} seed The seed to check with.
+ * @returns {bool} True if it always found the best one.
+ */
+bool check_planner(std::uint64_t seed);
+
+/**
+ * Tries every chain that goes on from the last tile of one, through the
+ * enemies the planner would try, and returns what the best is worth.
+ *
+ * @param {Board} b The board.
+ * @param {Tile::owner_t} owner Whose chain it is.
+ * @param {std::vector<Board::tile_id_t>&} path The tiles taken so far.
+ * @param {size_t} num_dice The dice its last tile attacks with.
+ * @param {double} chance The chance of every attack so far winning.
+ * @param {double} value What the chain so far is worth.
+ * @returns {double} What the best chain going on from it is worth.
+ */
+double search_chains(
+  const Board& b
+  , Tile::owner_t owner
+  , std::vector<Board::tile_id_t>& path
+  , size_t num_dice
+  , double chance
+  , double value);
+
+/**
+ * Checks what the endgame solver works out against playing every position
+ * out by brute force, on small boards where every tile borders somebody
+ * else's, and that it solves the ends of games on each fixture in the order
+ * the AIs go through attacks.
+ *
+ * @param {std::uint64_t} seed The seed to check with.
+ * @returns {bool} True if it always agreed.
+ */
+bool check_endgame(std::uint64_t seed);
+
+/**
+ * Returns the chance of each seat winning within a number of turns, with
+ * everybody making the attack that is best for them, by trying every attack,
+ * roll and way of handing out dice.
+ *
+ * @param {Adjacency} adjacency Which tiles border each other.
+ * @param {EndgamePosition} p The position.
+ * @param {size_t} num_turns How many turns are left.
+ * @returns {EndgameValues} The chances.
+ */
+EndgameValues play_out(
+  const Adjacency& adjacency
+  , EndgamePosition p
+  , size_t num_turns);
+
+/**
+ * Returns the chances after the seat to move makes an attack, and is
+ * reinforced.
+ *
+ * @param {Adjacency} adjacency Which tiles border each other.
+ * @param {EndgamePosition} p The position.
+ * @param {size_t} from The attacking tile's id.
+ * @param {size_t} to The defending tile's id.
+ * @param {size_t} num_turns How many turns are left, counting this one.
+ * @returns {EndgameValues} The chances.
+ */
+EndgameValues play_out_attack(
+  const Adjacency& adjacency
+  , const EndgamePosition& p
+  , size_t from
+  , size_t to
+  , size_t num_turns);
+
+/**
+ * Returns the chances once the seat to move has been given some dice, one at
+ * a time to any of their tiles with room, and the turn has passed on.
+ *
+ * @param {Adjacency} adjacency Which tiles border each other.
+ * @param {EndgamePosition} p The position.
+ * @param {size_t} num_dice How many dice are left to hand out.
+ * @param {size_t} num_turns How many turns are left, counting this one.
+ * @returns {EndgameValues} The chances.
+ */
+EndgameValues play_out_reinforcement(
+  const Adjacency& adjacency
+  , EndgamePosition p
+  , size_t num_dice
+  , size_t num_turns);
+
+/**
+ * Returns whether a seat has a tile bordering somebody else's.
+ *
+ * @param {Adjacency} adjacency Which tiles border each other.
+ * @param {EndgamePosition} p The position.
+ * @param {size_t} seat The seat.
+ * @returns {bool} True if it can attack.
+ */
+bool has_frontline(
+  const Adjacency& adjacency
+  , const EndgamePosition& p
+  , size_t seat);
+
+/**
+ * Returns how many tiles are in a seat's largest group of touching tiles.
+ *
+ * @param {Adjacency} adjacency Which tiles border each other.
+ * @param {EndgamePosition} p The position.
+ * @param {size_t} seat The seat.
+ * @returns {size_t} The number of tiles.
+ */
+size_t get_largest_region(
+  const Adjacency& adjacency
+  , const EndgamePosition& p
+  , size_t seat);
+
+
+/*********************
+ * STATIC PROPERTIES *
+ *********************/
+
+// The boards every check that plays on one is run on: the size a game starts
+// at, with either generator, a bigger one, and the one as many players as
+// there can be share
+const Fixture FIXTURES[] = {
+  {
+    "walk/80x23"
+    , Board::Generator::RANDOM_WALK
+    , Display::MINIMUM_WIDTH, Display::MINIMUM_HEIGHT - 1
+    , Board::DEFAULT_NUM_TILES, 4
+  }
+  , {
+    "voronoi/80x23"
+    , Board::Generator::VORONOI
+    , Display::MINIMUM_WIDTH, Display::MINIMUM_HEIGHT - 1
+    , Board::DEFAULT_NUM_TILES, 4
+  }
+  , {
+    "voronoi/200x60"
+    , Board::Generator::VORONOI
+    , 200, 60
+    , Board::DEFAULT_NUM_TILES, 4
+  }
+  , {
+    "voronoi/400x200"
+    , Board::Generator::VORONOI
+    , CROWD_WIDTH, CROWD_HEIGHT
+    , CROWD_NUM_TILES, 16
+  }
+};
+
+// How many boards of each size and number of tiles are checked
+const size_t NUM_CHECKED_BOARDS = 40;
+
+// How many fights the features are checked over on each board
+const size_t NUM_CHECKED_FIGHTS = 20000;
+
+// About how many chains the planner is checked on for each board, over as
+// many random deals of it as that takes
+const size_t NUM_CHECKED_CHAINS = 4000;
+
+// How many positions of each kind the endgame solver is checked on
+const size_t NUM_CHECKED_ENDGAMES = 120;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+/**
+ * Checks what the board, the planner and the endgame solver work out against
+ * slower ways of working it out, on fixed seeds. Every check is run unless
+ * some are named.
+ */
+int main(int argc, char** argv)
+{
+  std::uint64_t seed = 1;
+  bool all = true;
+  bool boards = false, evaluation = false, planner = false, endgame = false;
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      bool has_value = i + 1 < argc;
+
+      if (std::string(argv[i]) == "--seed" && has_value) {
+        seed = std::stoull(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--boards") {
+        boards = true;
+        all = false;
+      }
+      else if (std::string(argv[i]) == "--evaluation") {
+        evaluation = true;
+        all = false;
+      }
+      else if (std::string(argv[i]) == "--planner") {
+        planner = true;
+        all = false;
+      }
+      else if (std::string(argv[i]) == "--endgame") {
+        endgame = true;
+        all = false;
+      }
+      else {
+        throw std::invalid_argument("Unknown argument.");
+      }
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Usage: " << argv[0]
+      << " [--seed N] [--boards] [--evaluation] [--planner] [--endgame]"
+      << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    bool passed = true;
+    if (all || boards) {
+      passed = check_boards(seed) && passed;
+    }
+    if (all || evaluation) {
+      passed = check_evaluation(seed) && passed;
+    }
+    if (all || planner) {
+      passed = check_planner(seed) && passed;
+    }
+    if (all || endgame) {
+      passed = check_endgame(seed) && passed;
+    }
+
+    return passed ? 0 : 1;
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Error in program: " << ex.what() << std::endl;
+    return 1;
+  }
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+bool report_check(const std::string& name, bool ok, const std::string& detail)
+{
+  std::cout << std::left << std::setw(32) << name << (ok ? "ok" : "FAILED")
+    << " (" << detail << ")" << std::endl;
+
+  return ok;
+}
+
+
+bool check_boards(std::uint64_t seed)
+{
+  const size_t NUM_TILES[] = { Board::DEFAULT_NUM_TILES, CROWD_NUM_TILES };
+
+  bool passed = true;
+  for (const Fixture& fixture : FIXTURES)
+  {
+    if (fixture.generator != Board::Generator::VORONOI) { continue; }
+
+    HeadlessDisplay d (fixture.width, fixture.height);
+    for (size_t num_tiles : NUM_TILES)
+    {
+      // Tiles may be a fifth smaller than an even share of the board, so
+      // that many more can fit, and a few are lost to the space between them
+      size_t fewest = num_tiles * 3 / 4, most = num_tiles * 6 / 5;
+      size_t num_disconnected = 0, num_miscounted = 0;
+      size_t min_tiles = most, max_tiles = 0;
+      for (size_t i = 0; i < NUM_CHECKED_BOARDS; ++i)
+      {
+        std::mt19937 rng(seed + i);
+        Board board = make_fixture(
+          rng
+          , d
+          , fixture.width
+          , fixture.height
+          , fixture.generator
+          , num_tiles
+          , fixture.num_players);
+
+        const Adjacency& adjacency = board.getAdjacency();
+        size_t num_generated = adjacency.getNumTiles();
+        min_tiles = std::min(min_tiles, num_generated);
+        max_tiles = std::max(max_tiles, num_generated);
+        if (!MapGenerator::isConnected(adjacency)) { ++num_disconnected; }
+        if (num_generated < fewest || num_generated > most) {
+          ++num_miscounted;
+        }
+      }
+
+      passed = report_check(
+        std::string("boards/") + fixture.name + "/" + std::to_string(num_tiles)
+        , num_disconnected == 0 && num_miscounted == 0
+        , std::to_string(min_tiles) + " to " + std::to_string(max_tiles)
+          + " tiles, " + std::to_string(num_disconnected) + " disconnected")
+        && passed;
+    }
+  }
+
+  return passed;
+}
+
+
+bool check_evaluation(std::uint64_t seed)
+{
+  auto same = [](const Evaluation::Features& a, const Evaluation::Features& b)
+  {
+    return a.num_tiles == b.num_tiles
+      && a.largest_region == b.largest_region
+      && a.frontline_dice == b.frontline_dice
+      && a.exposure == b.exposure;
+  };
+
+  bool passed = true;
+  for (const Fixture& fixture : FIXTURES)
+  {
+    HeadlessDisplay d (fixture.width, fixture.height);
+    std::mt19937 rng(seed);
+    Board board = make_fixture(
+      rng
+      , d
+      , fixture.width
+      , fixture.height
+      , fixture.generator
+      , fixture.num_tiles
+      , fixture.num_players);
+    std::vector<TileState> start;
+    board.getTileStates(start);
+
+    Evaluation recounted;
+    std::vector<Board::tile_id_t> frontline, targets;
+    size_t num_mispredicted = 0, num_drifted = 0;
+    size_t num_fights = 0, num_stuck = 0;
+    size_t turn = 0;
+    while (num_fights < NUM_CHECKED_FIGHTS)
+    {
+      // Players take turns, and the game starts over once somebody holds
+      // every tile, or nobody is left who can attack
+      Tile::owner_t owner =
+        static_cast<Tile::owner_t> (turn++ % fixture.num_players);
+      board.getFrontlineIds(owner, frontline);
+      if (frontline.empty()) {
+        if (board.getNumTiles(owner) == start.size()
+            || ++num_stuck == fixture.num_players) {
+          board.setTileStates(start);
+          num_stuck = 0;
+        }
+        continue;
+      }
+      num_stuck = 0;
+      ++num_fights;
+
+      std::uniform_int_distribution<size_t> pick_from (0, frontline.size() - 1);
+      Board::tile_id_t from = frontline[pick_from(rng)];
+      board.getEnemyNeighborIds(from, targets);
+      std::uniform_int_distribution<size_t> pick_to (0, targets.size() - 1);
+      Board::tile_id_t to = targets[pick_to(rng)];
+
+      Evaluation::Features won = board.getFeaturesAfterFight(from, to, true);
+      Evaluation::Features lost = board.getFeaturesAfterFight(from, to, false);
+      board.fight(rng, from, to);
+      bool took = (board.getTiles() + to)->getOwner() == owner;
+      if (!same(board.getFeatures(owner), took ? won : lost)) {
+        ++num_mispredicted;
+      }
+
+      board.reinforce(rng, owner);
+
+      recounted.reset(board);
+      for (Tile::owner_t id = 0; id < fixture.num_players; ++id)
+      {
+        if (!same(board.getFeatures(id), recounted.getFeatures(board, id))) {
+          ++num_drifted;
+          break;
+        }
+      }
+    }
+
+    passed = report_check(
+      std::string("evaluation/") + fixture.name
+      , num_mispredicted == 0 && num_drifted == 0
+      , std::to_string(num_mispredicted) + " mispredicted, "
+        + std::to_string(num_drifted) + " out of date of "
+        + std::to_string(num_fights) + " fights")
+      && passed;
+  }
+
+  return passed;
+}
+
+
+bool check_planner(std::uint64_t seed)
+{
+  const double TOLERANCE = 1e-9;
+  const FightOdds<GameRules>& odds = FightOdds<GameRules>::get();
+
+  bool passed = true;
+  for (const Fixture& fixture : FIXTURES)
+  {
+    HeadlessDisplay d (fixture.width, fixture.height);
+    std::mt19937 rng(seed);
+    Board board = make_fixture(
+      rng
+      , d
+      , fixture.width
+      , fixture.height
+      , fixture.generator
+      , fixture.num_tiles
+      , fixture.num_players);
+
+    std::vector<TileState> states;
+    board.getTileStates(states);
+    std::uniform_int_distribution<size_t> pick_owner (
+      0
+      , fixture.num_players - 1);
+    std::uniform_int_distribution<size_t> pick_dice (
+      1
+      , GameRules::MAX_DICE_PER_TILE);
+
+    AttackPlanner::Chain chain;
+    std::vector<AttackPlanner::Chain> chains;
+    std::vector<Board::tile_id_t> enemies, path;
+    size_t num_chains = 0, num_wrong = 0;
+    while (num_chains < NUM_CHECKED_CHAINS)
+    {
+      for (TileState& state : states)
+      {
+        state.owner = static_cast<Tile::owner_t> (pick_owner(rng));
+        state.num_dice = static_cast<std::uint8_t> (pick_dice(rng));
+      }
+      board.setTileStates(states);
+
+      for (size_t from = 0; from < states.size(); ++from)
+      {
+        Tile::owner_t owner = states[from].owner;
+        size_t num_dice = states[from].num_dice;
+
+        // Every enemy is tried first, as the planner does
+        double best = -1;
+        board.getEnemyNeighborIds(from, enemies);
+        for (Board::tile_id_t target : enemies)
+        {
+          double win_chance =
+            odds.getWinChance(num_dice, states[target].num_dice);
+          path.assign(1, target);
+          best = std::max(
+            best
+            , search_chains(
+              board
+              , owner
+              , path
+              , num_dice - 1
+              , win_chance
+              , win_chance));
+        }
+
+        bool found = board.planAttackChain(from, chain);
+        board.getAttackChains(from, chains);
+        ++num_chains;
+        if (found != (best >= 0)) {
+          ++num_wrong;
+          continue;
+        }
+        if (!found) { continue; }
+
+        // The chain must be worth what it says, and be the best there is
+        double chance = 1, value = 0;
+        for (size_t i = 0; i < chain.length; ++i)
+        {
+          chance *= odds.getWinChance(
+            num_dice - i
+            , states[chain.targets[i]].num_dice);
+          value += chance;
+        }
+        if (std::fabs(value - chain.expected_captures) > TOLERANCE
+            || std::fabs(chance - chain.success_chance) > TOLERANCE
+            || std::fabs(best - chain.expected_captures) > TOLERANCE
+            || chains.size() != enemies.size()
+            || std::fabs(chains.front().expected_captures - best)
+              > TOLERANCE) {
+          ++num_wrong;
+        }
+      }
+    }
+
+    passed = report_check(
+      std::string("planner/") + fixture.name
+      , num_wrong == 0
+      , std::to_string(num_wrong) + " of " + std::to_string(num_chains)
+        + " wrong")
+      && passed;
+  }
+
+  return passed;
+}
+
+
+double search_chains(
+  const Board& b
+  , Tile::owner_t owner
+  , std::vector<Board::tile_id_t>& path
+  , size_t num_dice
+  , double chance
+  , double value)
+{
+  double best = value;
+  if (num_dice == 0 || path.size() == AttackPlanner::MAX_CHAIN_LENGTH) {
+    return best;
+  }
+
+  // Past the first attack, the weakest few enemies, ties going to the lower
+  // id, whether or not the chain has taken them
+  Board::tile_iterator tiles = b.getTiles();
+  const Adjacency& adjacency = b.getAdjacency();
+  const Board::tile_id_t* neighbors = adjacency.getNeighbors(path.back());
+  std::vector<Board::tile_id_t> branches;
+  for (size_t i = 0; i < adjacency.getDegree(path.back()); ++i)
+  {
+    if ((tiles + neighbors[i])->getOwner() != owner) {
+      branches.push_back(neighbors[i]);
+    }
+  }
+  std::stable_sort(
+    std::begin(branches)
+    , std::end(branches)
+    , [&](Board::tile_id_t x, Board::tile_id_t y)
+    {
+      return (tiles + x)->getNumDice() < (tiles + y)->getNumDice();
+    });
+  if (branches.size() > AttackPlanner::MAX_BRANCHES) {
+    branches.resize(AttackPlanner::MAX_BRANCHES);
+  }
+
+  for (Board::tile_id_t target : branches)
+  {
+    if (std::find(std::begin(path), std::end(path), target)
+        != std::end(path)) {
+      continue;
+    }
+
+    double win_chance = chance * FightOdds<GameRules>::get().getWinChance(
+      num_dice
+      , (tiles + target)->getNumDice());
+    path.push_back(target);
+    best = std::max(
+      best
+      , search_chains(b, owner, path, num_dice - 1, win_chance
+        , value + win_chance));
+    path.pop_back();
+  }
+
+  return best;
+}
+
+
+bool check_endgame(std::uint64_t seed)
+{
+  const double TOLERANCE = 1e-9;
+  const size_t MAX_PLAYERS = 3;
+
+  HeadlessDisplay d (Display::MINIMUM_WIDTH, Display::MINIMUM_HEIGHT);
+  std::mt19937 rng(seed);
+  std::vector<EndgameSolver::Move> moves;
+  std::vector<Board::tile_id_t> frontline, targets;
+  std::vector<TileState> states;
+
+  // Whether the moves are the attacks the AIs go through, in their order,
+  // each with the chances a check gives
+  auto check_moves = [&](
+    const Board& board
+    , Tile::owner_t owner
+    , const std::function<bool(const EndgameSolver::Move&)>& check)
+  {
+    size_t next = 0;
+    board.getFrontlineIds(owner, frontline);
+    for (Board::tile_id_t from : frontline)
+    {
+      board.getEnemyNeighborIds(from, targets);
+      for (Board::tile_id_t to : targets)
+      {
+        if (next == moves.size()
+            || moves[next].attacker != from
+            || moves[next].defender != to
+            || !check(moves[next])) {
+          return false;
+        }
+        ++next;
+      }
+    }
+
+    return next == moves.size();
+  };
+
+  // Small boards dealt between two or three players in a random turn order,
+  // played out a turn or two ahead
+  EndgameSolver::Limits limits = EndgameSolver::DEFAULT_LIMITS;
+  limits.max_tiles = EndgameSolver::MAX_TILES;
+  limits.max_players = MAX_PLAYERS;
+  limits.max_positions = std::numeric_limits<size_t>::max();
+
+  size_t num_checked = 0, num_wrong = 0;
+  for (size_t layout = 0; num_checked < NUM_CHECKED_ENDGAMES; ++layout)
+  {
+    Board board (rng, d, 24, 10, Board::Generator::VORONOI, 4 + layout % 3);
+    const Adjacency& adjacency = board.getAdjacency();
+    size_t num_tiles = adjacency.getNumTiles();
+    if (num_tiles < 3 || num_tiles > 5) { continue; }
+
+    for (size_t deal = 0; deal < 8 && num_checked < NUM_CHECKED_ENDGAMES
+        ; ++deal)
+    {
+      // Three players need three turns for the order they take them in to
+      // make a difference, which is only quick enough on the smallest boards
+      size_t num_players = 2 + deal % (MAX_PLAYERS - 1);
+      if (num_players == MAX_PLAYERS && num_tiles > MAX_PLAYERS) {
+        continue;
+      }
+      std::vector<Tile::owner_t> order (num_players);
+      for (size_t i = 0; i < num_players; ++i)
+      {
+        order[i] = static_cast<Tile::owner_t> (i);
+      }
+      std::shuffle(std::begin(order), std::end(order), rng);
+      board.setTurnOrder(order);
+
+      states.resize(num_tiles);
+      for (TileState& state : states)
+      {
+        state.owner = static_cast<Tile::owner_t> (rng() % num_players);
+        state.num_dice = static_cast<std::uint8_t> (1 + rng() % 4);
+      }
+      board.setTileStates(states);
+      for (Tile::owner_t id = 0; id < num_players; ++id)
+      {
+        board.setBankedDice(id, rng() % 2);
+      }
+
+      // Everybody has to be playing, and every tile bordering somebody
+      // else's, for the solver to be exact
+      bool exact = true;
+      for (Tile::owner_t id = 0; id < num_players; ++id)
+      {
+        exact = exact && board.getNumTiles(id) > 0;
+      }
+      for (size_t id = 0; id < num_tiles && exact; ++id)
+      {
+        board.getEnemyNeighborIds(id, targets);
+        exact = !targets.empty();
+      }
+      if (!exact) { continue; }
+
+      // The player to move is seat 0, and the others follow in turn order
+      size_t start = rng() % num_players;
+      Tile::owner_t owner = order[start];
+      EndgamePosition p;
+      p.owners.resize(num_tiles);
+      p.dice.resize(num_tiles);
+      p.banked.fill(0);
+      for (size_t seat = 0; seat < num_players; ++seat)
+      {
+        Tile::owner_t id = order[(start + seat) % num_players];
+        p.banked[seat] = board.getBankedDice(id);
+        for (size_t tile = 0; tile < num_tiles; ++tile)
+        {
+          if (states[tile].owner == id) {
+            p.owners[tile] = static_cast<std::uint8_t> (seat);
+          }
+        }
+      }
+      for (size_t tile = 0; tile < num_tiles; ++tile)
+      {
+        p.dice[tile] = states[tile].num_dice;
+      }
+      p.playing = (1u << num_players) - 1;
+      p.seat = 0;
+
+      limits.max_turns = num_players == MAX_PLAYERS ? 4 : 1 + deal / 2 % 2;
+      board.setEndgameLimits(limits);
+      ++num_checked;
+      if (!board.solveEndgame(owner, moves)
+          || !check_moves(
+            board
+            , owner
+            , [&](const EndgameSolver::Move& move)
+            {
+              EndgameValues values = play_out_attack(
+                adjacency
+                , p
+                , move.attacker
+                , move.defender
+                , move.num_turns);
+              double others = 0;
+              for (size_t seat = 1; seat < EndgameSolver::MAX_SEATS; ++seat)
+              {
+                others += values[seat];
+              }
+              return std::fabs(move.win_chance - values[0]) <= TOLERANCE
+                && std::fabs(move.lose_chance - others) <= TOLERANCE;
+            })) {
+        ++num_wrong;
+      }
+    }
+  }
+
+  bool passed = report_check(
+    "endgame/voronoi/24x10"
+    , num_wrong == 0
+    , std::to_string(num_wrong) + " of " + std::to_string(num_checked)
+      + " wrong");
+
+  // The end of a game on each fixture, where one player is down to a tile or
+  // two surrounded by another's, and the tiles behind make the solver only
+  // nearly exact
+  for (const Fixture& fixture : FIXTURES)
+  {
+    HeadlessDisplay fixture_d (fixture.width, fixture.height);
+    Board board = make_fixture(
+      rng
+      , fixture_d
+      , fixture.width
+      , fixture.height
+      , fixture.generator
+      , fixture.num_tiles
+      , fixture.num_players);
+    const Adjacency& adjacency = board.getAdjacency();
+    size_t num_tiles = adjacency.getNumTiles();
+    board.setTurnOrder(std::vector<Tile::owner_t> { 1, 0 });
+    board.setEndgameLimits(EndgameSolver::DEFAULT_LIMITS);
+
+    size_t num_solved = 0;
+    num_wrong = 0;
+    for (size_t i = 0; i < NUM_CHECKED_ENDGAMES; ++i)
+    {
+      // The player who is ahead has filled their tiles by now
+      states.assign(num_tiles, TileState { 0, GameRules::MAX_DICE_PER_TILE });
+      size_t held = rng() % num_tiles;
+      states[held].owner = 1;
+      if (i % 2 == 1 && adjacency.getDegree(held) > 0) {
+        states[adjacency.getNeighbors(held)[0]].owner = 1;
+      }
+      for (TileState& state : states)
+      {
+        if (state.owner == 1) {
+          state.num_dice = static_cast<std::uint8_t> (
+            1 + rng() % GameRules::MAX_DICE_PER_TILE);
+        }
+      }
+      board.setTileStates(states);
+
+      Tile::owner_t owner = static_cast<Tile::owner_t> (i % 2);
+      if (!board.solveEndgame(owner, moves)) { continue; }
+
+      ++num_solved;
+      if (!check_moves(
+            board
+            , owner
+            , [&](const EndgameSolver::Move& move)
+            {
+              return move.win_chance >= 0 && move.lose_chance >= 0
+                && move.win_chance + move.lose_chance <= 1 + TOLERANCE;
+            })) {
+        ++num_wrong;
+      }
+    }
+
+    // Solving nothing would mean it never comes into play in real games
+    passed = report_check(
+      std::string("endgame/") + fixture.name
+      , num_wrong == 0 && num_solved > 0
+      , std::to_string(num_wrong) + " of " + std::to_string(num_solved)
+        + " solved wrong")
+      && passed;
+  }
+
+  return passed;
+}
+
+
+EndgameValues play_out(
+  const Adjacency& adjacency
+  , EndgamePosition p
+  , size_t num_turns)
+{
+  // Whoever has nowhere to attack from is out when their turn comes
+  for (;;)
+  {
+    if ((p.playing & (p.playing - 1)) == 0) {
+      EndgameValues values {};
+      for (size_t seat = 0; seat < EndgameSolver::MAX_SEATS; ++seat)
+      {
+        if (p.playing & (1u << seat)) { values[seat] = 1; }
+      }
+      return values;
+    }
+
+    if (has_frontline(adjacency, p, p.seat)) { break; }
+
+    p.playing &= ~(1u << p.seat);
+    do
+    {
+      p.seat = (p.seat + 1) % EndgameSolver::MAX_SEATS;
+    }
+    while (!(p.playing & (1u << p.seat)));
+  }
+
+  if (num_turns == 0) { return EndgameValues {}; }
+
+  // The first of the best attacks, in order of tile id
+  auto score = [&](const EndgameValues& values)
+  {
+    double others = 0;
+    for (size_t seat = 0; seat < EndgameSolver::MAX_SEATS; ++seat)
+    {
+      if (seat != p.seat) { others += values[seat]; }
+    }
+    return values[p.seat] - others;
+  };
+
+  EndgameValues best {};
+  bool found = false;
+  for (size_t from = 0; from < p.owners.size(); ++from)
+  {
+    if (p.owners[from] != p.seat) { continue; }
+
+    const Board::tile_id_t* neighbors = adjacency.getNeighbors(from);
+    for (size_t to = 0; to < p.owners.size(); ++to)
+    {
+      if (p.owners[to] == p.seat
+          || std::find(neighbors, neighbors + adjacency.getDegree(from), to)
+            == neighbors + adjacency.getDegree(from)) {
+        continue;
+      }
+
+      EndgameValues values =
+        play_out_attack(adjacency, p, from, to, num_turns);
+      if (!found || score(values) > score(best)) {
+        found = true;
+        best = values;
+      }
+    }
+  }
+
+  return best;
+}
+
+
+EndgameValues play_out_attack(
+  const Adjacency& adjacency
+  , const EndgamePosition& p
+  , size_t from
+  , size_t to
+  , size_t num_turns)
+{
+  double win_chance = FightOdds<GameRules>::get().getWinChance(
+    p.dice[from]
+    , p.dice[to]);
+
+  EndgamePosition won = p;
+  won.owners[to] = static_cast<std::uint8_t> (p.seat);
+  won.dice[to] = static_cast<std::uint8_t> (p.dice[from] - 1);
+  won.dice[from] = 1;
+  EndgamePosition lost = p;
+  lost.dice[from] = 1;
+
+  EndgameValues values {};
+  const EndgamePosition* outcomes[] = { &won, &lost };
+  const double chances[] = { win_chance, 1 - win_chance };
+  for (size_t i = 0; i < 2; ++i)
+  {
+    if (chances[i] <= 0) { continue; }
+
+    const EndgamePosition& outcome = *outcomes[i];
+    size_t num_dice = outcome.banked[outcome.seat]
+      + get_largest_region(adjacency, outcome, outcome.seat);
+    EndgameValues after =
+      play_out_reinforcement(adjacency, outcome, num_dice, num_turns);
+    for (size_t seat = 0; seat < EndgameSolver::MAX_SEATS; ++seat)
+    {
+      values[seat] += chances[i] * after[seat];
+    }
+  }
+
+  return values;
+}
+
+
+EndgameValues play_out_reinforcement(
+  const Adjacency& adjacency
+  , EndgamePosition p
+  , size_t num_dice
+  , size_t num_turns)
+{
+  std::vector<size_t> open;
+  for (size_t tile = 0; tile < p.owners.size(); ++tile)
+  {
+    if (p.owners[tile] == p.seat
+        && p.dice[tile] < GameRules::MAX_DICE_PER_TILE) {
+      open.push_back(tile);
+    }
+  }
+
+  // Dice with nowhere to go are banked, and the turn passes on
+  if (num_dice == 0 || open.empty()) {
+    p.banked[p.seat] = std::min<size_t>(num_dice, GameRules::MAX_BANKED_DICE);
+    do
+    {
+      p.seat = (p.seat + 1) % EndgameSolver::MAX_SEATS;
+    }
+    while (!(p.playing & (1u << p.seat)));
+
+    return play_out(adjacency, p, num_turns - 1);
+  }
+
+  EndgameValues values {};
+  for (size_t tile : open)
+  {
+    EndgamePosition given = p;
+    ++given.dice[tile];
+    EndgameValues after =
+      play_out_reinforcement(adjacency, given, num_dice - 1, num_turns);
+    for (size_t seat = 0; seat < EndgameSolver::MAX_SEATS; ++seat)
+    {
+      values[seat] += after[seat] / open.size();
+    }
+  }
+
+  return values;
+}
+
+
+bool has_frontline(
+  const Adjacency& adjacency
+  , const EndgamePosition& p
+  , size_t seat)
+{
+  for (size_t tile = 0; tile < p.owners.size(); ++tile)
+  {
+    if (p.owners[tile] != seat) { continue; }
+
+    const Board::tile_id_t* neighbors = adjacency.getNeighbors(tile);
+    for (size_t i = 0; i < adjacency.getDegree(tile); ++i)
+    {
+      if (p.owners[neighbors[i]] != seat) { return true; }
+    }
+  }
+
+  return false;
+}
+
+
+size_t get_largest_region(
+  const Adjacency& adjacency
+  , const EndgamePosition& p
+  , size_t seat)
+{
+  std::vector<bool> seen (p.owners.size(), false);
+  size_t largest = 0;
+  for (size_t first = 0; first < p.owners.size(); ++first)
+  {
+    if (p.owners[first] != seat || seen[first]) { continue; }
+
+    std::vector<size_t> open (1, first);
+    seen[first] = true;
+    size_t size = 0;
+    while (!open.empty())
+    {
+      size_t tile = open.back();
+      open.pop_back();
+      ++size;
+
+      const Board::tile_id_t* neighbors = adjacency.getNeighbors(tile);
+      for (size_t i = 0; i < adjacency.getDegree(tile); ++i)
+      {
+        if (p.owners[neighbors[i]] == seat && !seen[neighbors[i]]) {
+          seen[neighbors[i]] = true;
+          open.push_back(neighbors[i]);
+        }
+      }
+    }
+    largest = std::max(largest, size);
+  }
+
+  return largest;
+}
@@ -25,6 +25,7 @@ enum class ColorPair
   , WHITE_PURPLE
   , WHITE_RED
   , WHITE_BLACK
+  , DEFAULT = 0 // Whatever the terminal normally uses
 };
 
 class ColorHelpers
@@ -37,6 +38,29 @@ class ColorHelpers
       return static_cast<ColorPair> (c);
     }
 
+    /**
+     * Gets the red, green and blue values of a color, each from 0 to 1000.
+     *
+     * @param {Color} c The color.
+     * @param {short int&} r Where the red value is stored.
+     * @param {short int&} g Where the green value is stored.
+     * @param {short int&} b Where the blue value is stored.
+     */
+    static void getRGB (Color c, short int& r, short int& g, short int& b)
+    {
+      switch (c)
+      {
+        case Color::BLUE:   r = 400;  g = 700;  b = 1000; break;
+        case Color::CYAN:   r = 400;  g = 1000; b = 1000; break;
+        case Color::GRAY:   r = 700;  g = 700;  b = 700;  break;
+        case Color::GREEN:  r = 400;  g = 1000; b = 400;  break;
+        case Color::ORANGE: r = 1000; g = 700;  b = 400;  break;
+        case Color::PINK:   r = 1000; g = 400;  b = 1000; break;
+        case Color::PURPLE: r = 400;  g = 400;  b = 1000; break;
+        case Color::RED:    r = 1000; g = 400;  b = 400;  break;
+      }
+    }
+
 };
 
 #endif
@@ -0,0 +1,332 @@
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <ncurses.h>
+#include <stdexcept>
+#include <thread>
+#include "curses_display.h"
+#include "color.h"
+#include "perf_stats.h"
+#include "screen.h"
+#include "trace.h"
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Wraps the init_color ncurses macro. Exists just to cast Color::<COLOR> to a
+ * short int.
+ *
+ * @param {Color} c The color to set the rgb values for.
+ */
+inline void Init_color(Color c);
+
+
+/**
+ * Wraps the init_pair ncurses macro. Exists just to cast Color::<COLOR> and
+ * ColorPair::<PAIR> to short ints.
+ *
+ * @param {ColorPair} c The color to set the rgb values for.
+ * @param {short int} f The foreground color.
+ * @param {Color} b The background Color.
+ */
+inline void Init_pair(ColorPair cp, short int f, Color b);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const int CursesDisplay::BLINK_MS = 500
+  , CursesDisplay::TICK_MS = 20;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+CursesDisplay::CursesDisplay(size_t width, size_t height)
+  : Display(width, height)
+  , terminal_width_(0)
+  , terminal_height_(0)
+  , running_(true)
+{
+  // Get terminal dimensions
+  size_t max_x, max_y;
+  WIN = initscr();
+  getmaxyx(stdscr, max_y, max_x);
+  terminal_width_ = max_x;
+  terminal_height_ = max_y;
+
+  // Terminal too small. The screen is given back before throwing, since the
+  // destructor never runs.
+  if (max_x < MINIMUM_WIDTH || max_y < MINIMUM_HEIGHT) {
+    endwin();
+    throw std::runtime_error("Terminal size cannot be less than board size.");
+  }
+
+  // Terminal does not support color
+  if (!has_colors()) {
+    endwin();
+    throw std::runtime_error("Terminal does not support color.");
+  }
+
+  // Clear screen
+  refresh();
+
+  start_color();        /* Turns on color mode */
+  cbreak();             /* Disable line buffering */
+  curs_set(0);          /* Make cursor invisible */
+  noecho();             /* getch() will not print characters */
+  keypad(stdscr, true); /* getch will get tokens correctly */
+  timeout(TICK_MS);     /* getch timeout, so the render thread can redraw */
+  mousemask(BUTTON1_CLICKED, nullptr); /* getch reports left clicks */
+
+
+  /*** Initialize NCurses color information ***/
+
+  Init_color(Color::BLUE);
+  Init_color(Color::CYAN);
+  Init_color(Color::GRAY);
+  Init_color(Color::GREEN);
+  Init_color(Color::ORANGE);
+  Init_color(Color::PINK);
+  Init_color(Color::PURPLE);
+  Init_color(Color::RED);
+
+  Init_pair(ColorPair::WHITE_BLUE,   COLOR_WHITE, Color::BLUE);
+  Init_pair(ColorPair::WHITE_CYAN,   COLOR_WHITE, Color::CYAN);
+  Init_pair(ColorPair::WHITE_GRAY,   COLOR_WHITE, Color::GRAY);
+  Init_pair(ColorPair::WHITE_GREEN,  COLOR_WHITE, Color::GREEN);
+  Init_pair(ColorPair::WHITE_ORANGE, COLOR_WHITE, Color::ORANGE);
+  Init_pair(ColorPair::WHITE_PINK,   COLOR_WHITE, Color::PINK);
+  Init_pair(ColorPair::WHITE_PURPLE, COLOR_WHITE, Color::PURPLE);
+  Init_pair(ColorPair::WHITE_RED,    COLOR_WHITE, Color::RED);
+  init_pair(static_cast<short int> (ColorPair::WHITE_BLACK)
+    , COLOR_WHITE, COLOR_BLACK);
+
+  shown_.resize(max_x, max_y);
+  next_.resize(max_x, max_y);
+
+  // From here on, only the render thread touches ncurses
+  render_thread_ = std::thread(&CursesDisplay::renderLoop, this);
+}
+
+
+CursesDisplay::~CursesDisplay()
+{
+  running_ = false;
+  render_thread_.join();
+
+  endwin();
+}
+
+
+void CursesDisplay::wait(int ms)
+{
+  // The render thread keeps going in the meantime
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+
+void CursesDisplay::present(const Frame& frame)
+{
+  // Copying into the back buffer reuses whatever memory it already has
+  frames_.getWriteBuffer() = frame;
+  frames_.publish();
+}
+
+
+Display::InputEvent CursesDisplay::waitForInput()
+{
+  std::unique_lock<std::mutex> lock (input_mutex_);
+  input_ready_.wait(lock, [this] { return !input_.empty(); });
+
+  InputEvent event = input_.front();
+  input_.pop_front();
+
+  return event;
+}
+
+
+void CursesDisplay::getTerminalSize(size_t& width, size_t& height) const
+{
+  width = terminal_width_;
+  height = terminal_height_;
+}
+
+
+void CursesDisplay::renderLoop()
+{
+  using clock = std::chrono::steady_clock;
+
+  bool blink_on = false;
+  TileGrid::tile_id_t last_blinking = TileGrid::NO_TILE;
+  clock::time_point next_blink = clock::now();
+  clock::time_point next_hud = clock::now();
+  Trace::get().nameThread("render");
+
+  while (running_)
+  {
+    bool dirty = frames_.update();
+    const Frame& frame = frames_.getReadBuffer();
+
+    // We only need to clear the screen if it was resized.
+    size_t max_x, max_y;
+    getmaxyx(stdscr, max_y, max_x);
+    if (max_x != terminal_width_ || max_y != terminal_height_) {
+      clear();
+      shown_.resize(max_x, max_y);
+      next_.resize(max_x, max_y);
+      terminal_width_ = max_x;
+      terminal_height_ = max_y;
+      dirty = true;
+    }
+
+    // A newly selected tile starts out highlighted, then flips every so often
+    clock::time_point now = clock::now();
+    if (frame.blinking != last_blinking) {
+      last_blinking = frame.blinking;
+      blink_on = true;
+      next_blink = now + std::chrono::milliseconds(BLINK_MS);
+      dirty = true;
+    }
+    else if (frame.blinking != TileGrid::NO_TILE && now >= next_blink) {
+      blink_on = !blink_on;
+      next_blink = now + std::chrono::milliseconds(BLINK_MS);
+      dirty = true;
+    }
+
+    // Keep the numbers on the perf HUD current
+    if (frame.show_perf && now >= next_hud) {
+      next_hud = now + std::chrono::milliseconds(BLINK_MS);
+      dirty = true;
+    }
+
+    if (dirty) {
+      render(frame, blink_on);
+    }
+
+    readInput();
+  }
+}
+
+
+void CursesDisplay::render(const Frame& frame, bool blink_on)
+{
+  PerfStats::Timer timer (PerfStats::Metric::FRAME_RENDER);
+  Trace::Span span ("CursesDisplay::render");
+
+  next_.compose(frame, blink_on);
+  if (frame.show_perf) {
+    PerfStats::get().getSummary(hud_);
+    next_.composeOverlay(hud_);
+  }
+
+  size_t first, last;
+  next_.getChangedRows(first, last);
+
+  for (size_t row = first; row < last; ++row)
+  {
+    for (size_t col = 0; col < next_.getWidth(); ++col)
+    {
+      const ScreenCell& cell = next_.at(col, row);
+      if (cell != shown_.at(col, row)) {
+        mvaddch(row, col, getDisplayableCharacter(cell));
+      }
+    }
+  }
+
+  {
+    Trace::Span refresh_span ("refresh");
+    refresh();
+  }
+  shown_.copyRows(next_, first, last);
+
+  // The first frame painted after a key was read shows what it did
+  if (frame.input_time != 0 && frame.input_time != painted_input_time_) {
+    painted_input_time_ = frame.input_time;
+
+    std::chrono::nanoseconds now =
+      std::chrono::steady_clock::now().time_since_epoch();
+    std::uint64_t painted_at = static_cast<std::uint64_t> (now.count());
+    if (painted_at > frame.input_time) {
+      PerfStats::get().record(
+        PerfStats::Metric::INPUT_TO_PAINT
+        , painted_at - frame.input_time);
+    }
+  }
+}
+
+
+void CursesDisplay::readInput()
+{
+  int ch = getch();
+
+  std::chrono::nanoseconds now =
+    std::chrono::steady_clock::now().time_since_epoch();
+  InputEvent event = {
+    ch
+    , false
+    , 0
+    , static_cast<std::uint64_t> (now.count())
+  };
+  switch (ch)
+  {
+    case ERR:
+    case KEY_RESIZE:
+      return;
+
+    case KEY_UP:    event.key = UP; break;
+    case KEY_DOWN:  event.key = DOWN; break;
+    case KEY_LEFT:  event.key = LEFT; break;
+    case KEY_RIGHT: event.key = RIGHT; break;
+
+    // Work out where on the board the click was, as the user saw it
+    case KEY_MOUSE:
+      {
+        event.key = MOUSE;
+
+        MEVENT mouse;
+        if (getmouse(&mouse) == OK && mouse.x >= 0 && mouse.y >= 0) {
+          event.on_board = shown_.screenToBoard(
+            static_cast<size_t> (mouse.x)
+            , static_cast<size_t> (mouse.y)
+            , event.coord);
+        }
+        break;
+      }
+  }
+
+  {
+    std::lock_guard<std::mutex> lock (input_mutex_);
+    input_.push_back(event);
+  }
+  input_ready_.notify_one();
+}
+
+
+int CursesDisplay::getDisplayableCharacter(const ScreenCell& cell)
+{
+  return cell.character | COLOR_PAIR(static_cast<int> (cell.pair));
+}
+
+
+/***********
+ * HELPERS *
+ ***********/
+
+inline void Init_color(Color c)
+{
+  short int r, g, b;
+  ColorHelpers::getRGB(c, r, g, b);
+
+  init_color(static_cast<short int>(c), r, g, b);
+}
+
+
+inline void Init_pair(ColorPair cp, short int f, Color b)
+{
+  init_pair(static_cast<short int>(cp), f, static_cast<short int>(b));
+}
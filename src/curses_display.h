@@ -0,0 +1,122 @@
+#ifndef CURSES_DISPLAY_H
+#define CURSES_DISPLAY_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ncurses.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "display.h"
+#include "frame.h"
+#include "screen.h"
+#include "triple_buffer.h"
+
+/**
+ * Shows the game in the terminal. Drawing happens on a separate render thread,
+ * which the game thread only ever hands immutable frames to. The game thread
+ * therefore never waits on ncurses, and the screen keeps blinking, resizing and
+ * showing messages while the game thread is busy.
+ */
+class CursesDisplay : public Display
+{
+
+  public:
+
+    /******************************
+     * CONSTRUCTORS & DESTRUCTORS *
+     ******************************/
+
+    CursesDisplay(size_t width, size_t height);
+
+    virtual ~CursesDisplay();
+
+
+  protected:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GAME THREAD ***/
+
+    virtual void wait(int ms) override;
+
+    virtual void present(const Frame& frame) override;
+
+    virtual InputEvent waitForInput() override;
+
+    virtual void getTerminalSize(size_t& width, size_t& height) const override;
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** RENDER THREAD ***/
+
+    /**
+     * Draws the latest frame whenever it changes, blinks, or the terminal is
+     * resized, and collects input, until the display is destroyed.
+     */
+    void renderLoop();
+
+    /**
+     * Draws a frame, only touching the characters that changed since the last
+     * one.
+     *
+     * @param {Frame} frame The frame to draw.
+     * @param {bool} blink_on Whether the blinking tile is highlighted.
+     */
+    void render(const Frame& frame, bool blink_on);
+
+    /**
+     * Waits a short while for a key press and queues it for the game thread.
+     */
+    void readInput();
+
+    /**
+     * Returns a character that ncurses can use.
+     *
+     * @param {ScreenCell} cell The character and its colors.
+     * @returns {int} An ncurses-printable character.
+     */
+    static int getDisplayableCharacter(const ScreenCell& cell);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    /*** CLASS PROPERTIES ***/
+
+    // How often the selected tile blinks, and how often input is checked
+    static const int BLINK_MS, TICK_MS;
+
+
+    /*** INSTANCE PROPERTIES ***/
+
+    WINDOW* WIN;
+
+    // Only touched by the render thread
+    Screen shown_, next_;
+    std::vector<std::string> hud_;
+    std::uint64_t painted_input_time_ = 0;
+
+    // Shared between the two threads
+    TripleBuffer<Frame> frames_;
+    std::atomic<size_t> terminal_width_, terminal_height_;
+    std::deque<InputEvent> input_;
+    std::mutex input_mutex_;
+    std::condition_variable input_ready_;
+    std::atomic<bool> running_;
+    std::thread render_thread_;
+
+};
+
+#endif
@@ -1,31 +1,286 @@
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <random>
 #include <stdexcept>
+#include <string>
 #include <vector>
 #include "dicefeud.h"
-#include "color.h"
+#include "alloc_counter.h"
 #include "display.h"
+#include "fair_start.h"
+#include "frame.h"
+#include "perf_stats.h"
+#include "replay_writer.h"
+#include "rules.h"
+#include "snapshot.h"
+#include "trace.h"
 #include "behavior/human.h"
 #include "behavior/ai_easy.h"
 #include "behavior/ai_medium.h"
 #include "behavior/ai_hard.h"
 
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Creates a player of the given kind.
+ *
+ * @param {Snapshot::PlayerKind} kind Who controls the player.
+ * @param {Tile::owner_t} id The player's id.
+ * @returns {Player*} The new player, owned by the caller.
+ */
+Player* make_player(Snapshot::PlayerKind kind, Tile::owner_t id);
+
+/**
+ * Finds out what kind of player a player is, so that it can be saved.
+ *
+ * @param {Player} p The player.
+ * @returns {Snapshot::PlayerKind} Who controls the player.
+ */
+Snapshot::PlayerKind get_player_kind(const Player& p);
+
+/**
+ * Returns what a turn of a kind of player is called in a trace.
+ *
+ * @param {Snapshot::PlayerKind} kind Who controls the player.
+ * @returns {const char*} The name of the span.
+ */
+const char* get_turn_span_name(Snapshot::PlayerKind kind);
+
+
 /*******************
  * IMPLEMENTATIONS *
  *******************/
 
-DiceFeud::DiceFeud(std::mt19937& rng, Display& d, size_t numPlayers)
-  : d_(d)
-  , board_(rng, d, Display::MINIMUM_WIDTH, Display::MINIMUM_HEIGHT - 1)
+DiceFeud::DiceFeud(
+  std::mt19937& rng
+  , Display& d
+  , size_t numPlayers
+  , size_t width
+  , size_t height
+  , bool has_human)
+  : board_(rng, d, width, height)
+  , d_(d)
+{
+  setUpPlayers(rng, numPlayers, has_human);
+}
+
+
+DiceFeud::DiceFeud(
+  std::mt19937& rng
+  , Display& d
+  , Board board
+  , size_t numPlayers
+  , bool has_human)
+  : board_(std::move(board))
+  , d_(d)
+{
+  setUpPlayers(rng, numPlayers, has_human);
+}
+
+
+DiceFeud::DiceFeud(Display& d, const Snapshot& snapshot)
+  : board_(d, snapshot.getGrid(), snapshot.getTileStates())
+  , d_(d)
+  , turn_(snapshot.getTurn())
+  , turn_limit_(snapshot.getTurnLimit())
+{
+  std::vector<Snapshot::PlayerEntry> players;
+  snapshot.getPlayers(players);
+
+  for (const Snapshot::PlayerEntry& entry : players)
+  {
+    players_.emplace_back(make_player(entry.kind, entry.id));
+    board_.setBankedDice(entry.id, entry.banked_dice);
+  }
+
+  updateTurnOrder();
+}
+
+
+bool DiceFeud::balanceStart(std::mt19937& rng, const FairStart& fair_start)
+{
+  std::vector<TileState> states;
+  board_.getTileStates(states);
+
+  std::vector<Tile::owner_t> seats;
+  for (const std::unique_ptr<Player>& p : players_)
+  {
+    seats.push_back(p->getId());
+  }
+
+  bool fair =
+    fair_start.balance(rng, board_.getAdjacency(), states, seats);
+  board_.setTileStates(states);
+
+  return fair;
+}
+
+
+void DiceFeud::save(const std::string& path, const std::mt19937& rng) const
+{
+  std::vector<TileState> states;
+  board_.getTileStates(states);
+
+  std::vector<Snapshot::PlayerEntry> players;
+  for (const std::unique_ptr<Player>& p : players_)
+  {
+    Snapshot::PlayerEntry entry = {
+      p->getId()
+      , get_player_kind(*p)
+      , static_cast<std::uint8_t> (board_.getBankedDice(p->getId()))
+    };
+    players.push_back(entry);
+  }
+
+  Snapshot::write(
+    path
+    , board_.getGrid()
+    , states
+    , players
+    , turn_
+    , turn_limit_
+    , rng);
+}
+
+
+void DiceFeud::setReplay(ReplayWriter* replay)
+{
+  replay_ = replay;
+
+  if (replay) {
+    board_.setFightObserver(
+      [replay](size_t attacker, size_t defender, size_t a_total, size_t d_total)
+      {
+        replay->recordFight(attacker, defender, a_total, d_total);
+      });
+    board_.setReinforcementObserver(
+      [replay](size_t tile_id, size_t num_dice)
+      {
+        replay->recordReinforcement(tile_id, num_dice);
+      });
+  }
+  else {
+    board_.setFightObserver(nullptr);
+    board_.setReinforcementObserver(nullptr);
+  }
+}
+
+
+bool DiceFeud::play(std::mt19937& rng)
+{
+  board_.draw();
+
+  std::vector<TileState> states;
+
+  for (
+      ; players_.size() > 1 && (turn_limit_ == 0 || turn_ < turn_limit_)
+      ; ++turn_)
+  {
+    if (replay_ && replay_->needsKeyframe()) {
+      board_.getTileStates(states);
+      replay_->recordKeyframe(states);
+    }
+
+    Trace::Span turn_span ("DiceFeud::turn");
+
+    std::unique_ptr<Player> cur = std::move(players_.front());
+    players_.pop_front();
+    Snapshot::PlayerKind kind = get_player_kind(*cur);
+
+    // Let the player take their turn, timing the AIs by kind without the
+    // pauses that let the user follow along
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    std::chrono::nanoseconds paused = d_.getPaused();
+    AllocCounter::Probe allocations;
+    bool defeated;
+    {
+      Trace::Span span (get_turn_span_name(kind));
+      defeated = cur->takeTurn(rng, d_, board_) == false;
+    }
+
+    if (kind != Snapshot::PlayerKind::HUMAN) {
+      std::chrono::nanoseconds elapsed =
+        std::chrono::steady_clock::now() - start
+        - (d_.getPaused() - paused);
+      PerfStats::get().record(
+        static_cast<PerfStats::Metric> (
+          static_cast<size_t> (PerfStats::Metric::TURN_AI_EASY)
+          + static_cast<size_t> (kind)
+          - static_cast<size_t> (Snapshot::PlayerKind::AI_EASY))
+        , static_cast<std::uint64_t> (std::max<long long>(elapsed.count(), 0)));
+
+      if (AllocCounter::isEnabled()) {
+        PerfStats::get().record(
+          PerfStats::Metric::TURN_ALLOCATIONS
+          , allocations.getCount());
+      }
+    }
+
+    // The turn was never taken, so it is theirs again when the game resumes
+    if (cur->hasQuit()) {
+      players_.push_front(std::move(cur));
+      if (!save_path_.empty()) { save(save_path_, rng); }
+      return false;
+    }
+
+    if (!defeated) {
+      board_.reinforce(rng, cur->getId());
+
+      // Move this to the back of the queue
+      players_.push_back(std::move(cur));
+    }
+
+    if (replay_) { replay_->endTurn(); }
+  }
+
+  // Nobody won before the turn limit
+  if (players_.size() > 1) {
+    if (!save_path_.empty()) { save(save_path_, rng); }
+    return true;
+  }
+
+  return gameOver();
+}
+
+
+bool DiceFeud::gameOver()
+{
+  if (players_.empty()) { throw std::logic_error("No players in game!"); }
+
+  std::unique_ptr<Player> winner = std::move(players_.front());
+  players_.pop_front();
+
+  // Is the Human Player the winner?
+  Human* was_human = dynamic_cast<Human*>(winner.get());
+
+  if (was_human) {
+
+  }
+  else {
+
+  }
+
+  return true;
+}
+
+
+void DiceFeud::setUpPlayers(
+  std::mt19937& rng
+  , size_t numPlayers
+  , bool has_human)
 {
   if (numPlayers < 2) {
-    std::invalid_argument("There must be at least 2 players.");
+    throw std::invalid_argument("There must be at least 2 players.");
   }
-  if (numPlayers > 8) {
-    std::invalid_argument("There cannot be more than 8 players.");
+  if (numPlayers + (has_human ? 1 : 0) > GameRules::MAX_NUM_PLAYERS) {
+    throw std::invalid_argument("There are too many players for the rules.");
   }
 
   // We want to have a random order to our turns, and deque doesn't let us
@@ -33,16 +288,23 @@ DiceFeud::DiceFeud(std::mt19937& rng, Display& d, size_t numPlayers)
   std::vector<std::unique_ptr<Player>> players_arr;
 
 
-  // One player is always a PURPLE Human
-  players_arr.emplace_back(new Human(Color::PURPLE));
+  // One player is the Human, unless nobody is playing. They get the first
+  // id, which the display gives a color of its own.
+  Tile::owner_t first_ai_id = 0;
+  if (has_human) {
+    players_arr.emplace_back(make_player(Snapshot::PlayerKind::HUMAN, 0));
+    first_ai_id = 1;
+  }
 
 
-  // We want a different ordering of colors for every new game
-  std::vector<Color> colors = {
-    Color::BLUE, Color::CYAN, Color::GRAY, Color::GREEN
-      , Color::ORANGE, Color::PINK, Color::PURPLE, Color::RED
-  };
-  std::shuffle(std::begin(colors), std::end(colors), rng);
+  // The display picks colors by id, so we want a different ordering of ids
+  // for every new game
+  std::vector<Tile::owner_t> ids (numPlayers);
+  for (size_t i = 0; i < numPlayers; ++i)
+  {
+    ids[i] = static_cast<Tile::owner_t> (first_ai_id + i);
+  }
+  std::shuffle(std::begin(ids), std::end(ids), rng);
 
 
   // To make it more and more unlikely that we will select the same
@@ -64,25 +326,10 @@ DiceFeud::DiceFeud(std::mt19937& rng, Display& d, size_t numPlayers)
     // Make our selection of difficulty for this AI.
     size_t difficulty = dist(rng);
 
-    switch (difficulty)
-    {
-      case 0:
-        {
-          players_arr.emplace_back(new AIEasy(colors[i]));
-          break;
-        }
-
-      case 1:
-        {
-          players_arr.emplace_back(new AIMedium(colors[i]));
-          break;
-        }
-
-      default:
-        {
-          players_arr.emplace_back(new AIHard(colors[i]));
-        }
-    }
+    players_arr.emplace_back(make_player(
+      static_cast<Snapshot::PlayerKind> (
+        static_cast<size_t> (Snapshot::PlayerKind::AI_EASY) + difficulty)
+      , ids[i]));
 
     // Make it more unlikely for this to be picked again
     --(difficulty_weights[difficulty]);
@@ -98,8 +345,8 @@ DiceFeud::DiceFeud(std::mt19937& rng, Display& d, size_t numPlayers)
   }
 
   // Now assign each player to random tiles on the board.
-  std::list<Tile>::const_iterator end = board_.getTilesEnd();
-  for(std::list<Tile>::const_iterator cur_tile = board_.getTiles()
+  Board::tile_iterator end = board_.getTilesEnd();
+  for(Board::tile_iterator cur_tile = board_.getTiles()
     ; cur_tile != end
     ; ++cur_tile)
   {
@@ -107,54 +354,73 @@ DiceFeud::DiceFeud(std::mt19937& rng, Display& d, size_t numPlayers)
     std::unique_ptr<Player> cur_player (std::move(players_.front()));
     players_.pop_front();
 
-    // Set this tile's color to this player's color
-    board_.setTileColor((*cur_tile).getId(), (*cur_player).getColor());
+    // Give this tile to this player
+    board_.setTileOwner((*cur_tile).getId(), (*cur_player).getId());
 
     // Put player back in deque
     players_.push_back(std::move(cur_player));
   }
+
+  updateTurnOrder();
 }
 
 
-bool DiceFeud::play(std::mt19937& rng)
+void DiceFeud::updateTurnOrder()
 {
-  board_.draw();
-
-  while (players_.size() > 1)
+  std::vector<Tile::owner_t> ids;
+  for (const std::unique_ptr<Player>& p : players_)
   {
-    std::unique_ptr<Player> cur = std::move(players_.front());
-    players_.pop_front();
-
-    // Let the player take their turn
-    bool defeated = cur->takeTurn(rng, d_, board_) == false;
-
-    if (!defeated) {
-      // Move this to the back of the queue
-      players_.push_back(std::move(cur));
-    }
+    ids.push_back(p->getId());
   }
 
-  return gameOver();
+  board_.setTurnOrder(ids);
 }
 
 
-bool DiceFeud::gameOver()
-{
-  if (players_.size() == 1) { throw std::logic_error("No players in game!"); }
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
 
-  std::unique_ptr<Player> winner = std::move(players_.front());
-  players_.pop_front();
+Player* make_player(Snapshot::PlayerKind kind, Tile::owner_t id)
+{
+  switch (kind)
+  {
+    case Snapshot::PlayerKind::HUMAN:
+      return new Human(id);
 
-  // Is the Human Player the winner?
-  Human* was_human = dynamic_cast<Human*>(winner.get());
+    case Snapshot::PlayerKind::AI_EASY:
+      return new AIEasy(id);
 
-  if (was_human) {
+    case Snapshot::PlayerKind::AI_MEDIUM:
+      return new AIMedium(id);
 
+    case Snapshot::PlayerKind::AI_HARD:
+      return new AIHard(id);
   }
-  else {
 
-  }
+  throw std::invalid_argument("Unknown kind of player.");
+}
 
-  return true;
+
+Snapshot::PlayerKind get_player_kind(const Player& p)
+{
+  if (dynamic_cast<const Human*>(&p)) { return Snapshot::PlayerKind::HUMAN; }
+  if (dynamic_cast<const AIEasy*>(&p)) { return Snapshot::PlayerKind::AI_EASY; }
+  if (dynamic_cast<const AIMedium*>(&p)) {
+    return Snapshot::PlayerKind::AI_MEDIUM;
+  }
+  return Snapshot::PlayerKind::AI_HARD;
 }
 
+
+const char* get_turn_span_name(Snapshot::PlayerKind kind)
+{
+  switch (kind)
+  {
+    case Snapshot::PlayerKind::HUMAN: return "Human::takeTurn";
+    case Snapshot::PlayerKind::AI_EASY: return "AIEasy::takeTurn";
+    case Snapshot::PlayerKind::AI_MEDIUM: return "AIMedium::takeTurn";
+    case Snapshot::PlayerKind::AI_HARD: return "AIHard::takeTurn";
+    default: return "Player::takeTurn";
+  }
+}
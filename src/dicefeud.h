@@ -4,8 +4,12 @@
 #include <deque>
 #include <memory>
 #include <random>
+#include <string>
 #include "board.h"
 #include "display.h"
+#include "fair_start.h"
+#include "replay_writer.h"
+#include "snapshot.h"
 
 class DiceFeud
 {
@@ -16,7 +20,38 @@ class DiceFeud
      * CONSTRUCTORS *
      ****************/
 
-    DiceFeud(std::mt19937& rng, Display& d, size_t numPlayers);
+    DiceFeud(
+      std::mt19937& rng
+      , Display& d
+      , size_t numPlayers
+      , size_t width = Display::MINIMUM_WIDTH
+      , size_t height = Display::MINIMUM_HEIGHT - 1
+      , bool has_human = true);
+
+    /**
+     * Starts a game on a board that has already been generated, such as one
+     * from a map pack.
+     *
+     * @param {std::mt19937&} rng Used to pick the players.
+     * @param {Display&} d The display to show the game on.
+     * @param {Board} board The board, before anyone owns any of it.
+     * @param {size_t} numPlayers The number of AI players.
+     * @param {bool} has_human Whether the user plays as well.
+     */
+    DiceFeud(
+      std::mt19937& rng
+      , Display& d
+      , Board board
+      , size_t numPlayers
+      , bool has_human = true);
+
+    /**
+     * Resumes a saved game.
+     *
+     * @param {Display&} d The display to show the game on.
+     * @param {Snapshot} snapshot The saved game.
+     */
+    DiceFeud(Display& d, const Snapshot& snapshot);
 
 
     /***********
@@ -25,13 +60,74 @@ class DiceFeud
 
     /**
      * Runs this game. If the player wishes to continue at the end of the game,
-     * true will be returned.
+     * true will be returned. If the player quits in the middle of the game, it
+     * is saved and false is returned.
      *
      * @param {std::mt19937&} rng Provides randomness.
      * @returns {bool} True if the player wishes to continue playing.
      */
     bool play(std::mt19937& rng);
 
+    /**
+     * Returns the board, such as for checking how a game ended.
+     *
+     * @returns {const Board&} The board.
+     */
+    const Board& getBoard() const { return board_; }
+
+    /**
+     * Returns how many turns have been played, and how many players are left.
+     *
+     * @returns {size_t} The number of turns or players.
+     */
+    size_t getTurn() const { return turn_; }
+    size_t getNumPlayersLeft() const { return players_.size(); }
+
+    /**
+     * Deals the tiles and dice out again until every player stands about the
+     * same chance of winning. Call before the game is played.
+     *
+     * @param {std::mt19937&} rng Provides randomness.
+     * @param {FairStart} fair_start How to judge and how hard to try.
+     * @returns {bool} True if a fair enough start was found; otherwise the
+     * fairest one found is used.
+     */
+    bool balanceStart(std::mt19937& rng, const FairStart& fair_start);
+
+    /**
+     * Limits how many turns the game may last. A game that reaches the limit
+     * ends in a draw. Games between AI players alone can otherwise go on
+     * forever.
+     *
+     * @param {size_t} max_turns The most turns to play, or 0 for no limit.
+     */
+    void setTurnLimit(size_t max_turns) { turn_limit_ = max_turns; }
+
+    /**
+     * Sets where the game is saved if the user quits in the middle of it or
+     * it reaches the turn limit. Without one, the game is simply ended.
+     *
+     * @param {std::string} path The file to save to.
+     */
+    void setSavePath(const std::string& path) { save_path_ = path; }
+
+    /**
+     * Saves the game as it is between turns.
+     *
+     * @param {std::string} path The file to save to.
+     * @param {std::mt19937} rng The generator the game is being played with.
+     */
+    void save(const std::string& path, const std::mt19937& rng) const;
+
+    /**
+     * Records every turn of this game to a replay. The board must have been
+     * generated from the seed the replay was started with.
+     *
+     * @param {ReplayWriter*} replay The replay, which must outlive the game, or
+     * nullptr to stop recording.
+     */
+    void setReplay(ReplayWriter* replay);
+
 
   private:
 
@@ -42,12 +138,32 @@ class DiceFeud
     Board board_;
     Display& d_;
     std::deque<std::unique_ptr<Player>> players_;
+    size_t turn_ = 0;
+    size_t turn_limit_ = 0;
+    std::string save_path_;
+    ReplayWriter* replay_ = nullptr;
 
 
     /***********
      * METHODS *
      ***********/
 
+    /**
+     * Creates the players in a random order and hands out the tiles between
+     * them.
+     *
+     * @param {std::mt19937&} rng Provides randomness.
+     * @param {size_t} numPlayers The number of AI players.
+     * @param {bool} has_human Whether the user plays as well.
+     */
+    void setUpPlayers(std::mt19937& rng, size_t numPlayers, bool has_human);
+
+    /**
+     * Tells the board the order the players take turns in, for the AIs that
+     * play the end of the game out.
+     */
+    void updateTurnOrder();
+
     /**
      * Shows the Game Over screen, indicating whether the user won or lost, and
      * prompts the user whether they would like to start a new game or not.
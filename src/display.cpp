@@ -1,232 +1,204 @@
-#include <ncurses.h>
-#include <stdexcept>
+#include <array>
+#include <cstdint>
 #include <string>
+#include <utility>
 #include "display.h"
 #include "color.h"
 #include "tile.h"
 
-/******************************
- * HELPER FUNCTION PROTOTYPES *
- ******************************/
-
-/**
- * Wraps the init_color ncurses macro. Exists just to cast Color::<COLOR> to a
- * short int.
- *
- * @param {Color} c The color to set the rgb values for.
- * @param {short int} r The red value.
- * @param {short int} g The green value.
- * @param {short int} b The blue value.
- */
-inline void Init_color(Color c, short int r, short int g, short int b);
-
-
-/**
- * Wraps the init_pair ncurses macro. Exists just to cast Color::<COLOR> and
- * ColorPair::<PAIR> to short ints.
- *
- * @param {ColorPair} c The color to set the rgb values for.
- * @param {short int} f The foreground color.
- * @param {Color} b The background Color.
- */
-inline void Init_pair(ColorPair cp, short int f, Color b);
-
-
 /*******************
  * IMPLEMENTATIONS *
  *******************/
 
 Display::Display(size_t width, size_t height)
-  : game_width(width), game_height(height)
 {
-  // Get terminal dimensions
-  WIN = initscr();
-  getmaxyx(stdscr, known_terminal_height, known_terminal_width);
+  // Boards larger than the terminal are shown through the viewport. It is fit
+  // to the terminal the first time it is used, since only the backend knows
+  // how big that is.
+  staging_.viewport = Viewport(width, height);
+}
 
-  // Terminal too small
-  if (known_terminal_width < MINIMUM_WIDTH
-      || known_terminal_height < MINIMUM_HEIGHT) {
-    std::runtime_error("Terminal size cannot be less than board size.");
-  }
 
-  if (width > known_terminal_width || height > known_terminal_height) {
-    std::runtime_error("Board cannot be larger than terminal.");
-  }
+int Display::blinkUntilKeypress(const Tile& t)
+{
+  staging_.blinking = static_cast<TileGrid::tile_id_t> (t.getId());
+  ++staging_.board_version;
+  publish();
 
-  // Terminal does not support color
-  if (!has_colors()) {
-    std::runtime_error("Terminal does not support color.");
-  }
+  last_input_ = waitForInput();
 
-  // Clear screen
-  refresh();
+  // Make sure we restore what it originally looked like, and that whatever
+  // shows it can tell how long that took
+  staging_.blinking = TileGrid::NO_TILE;
+  staging_.input_time = last_input_.read_at;
+  ++staging_.board_version;
+  publish();
 
-  start_color();        /* Turns on color mode */
-  cbreak();             /* Disable line buffering */
-  curs_set(0);          /* Make cursor invisible */
-  noecho();             /* getch() will not print characters */
-  keypad(stdscr, true); /* getch will get tokens correctly */
-  timeout(500);         /* getch timeout of half a second */
+  return last_input_.key;
+}
 
 
-  /*** Initialize NCurses color information ***/
+void Display::clearMessageBar()
+{
+  staging_.message.clear();
+  publish();
+}
 
-  Init_color(Color::BLUE, 400, 700, 1000);
-  Init_color(Color::CYAN, 400, 1000, 1000);
-  Init_color(Color::GREEN, 400, 1000, 400);
-  Init_color(Color::ORANGE, 1000, 700, 400);
-  Init_color(Color::PINK, 1000, 400, 1000);
-  Init_color(Color::PURPLE, 400, 400, 1000);
-  Init_color(Color::RED, 1000, 400, 400);
 
-  Init_pair(ColorPair::WHITE_BLUE,   COLOR_WHITE, Color::BLUE);
-  Init_pair(ColorPair::WHITE_CYAN,   COLOR_WHITE, Color::CYAN);
-  Init_pair(ColorPair::WHITE_GRAY,   COLOR_WHITE, Color::GRAY);
-  Init_pair(ColorPair::WHITE_GREEN,  COLOR_WHITE, Color::GREEN);
-  Init_pair(ColorPair::WHITE_ORANGE, COLOR_WHITE, Color::ORANGE);
-  Init_pair(ColorPair::WHITE_PINK,   COLOR_WHITE, Color::PINK);
-  Init_pair(ColorPair::WHITE_PURPLE, COLOR_WHITE, Color::PURPLE);
-  Init_pair(ColorPair::WHITE_RED,    COLOR_WHITE, Color::RED);
-  init_pair(static_cast<short int> (ColorPair::WHITE_BLACK)
-    , COLOR_WHITE, COLOR_BLACK);
+void Display::drawBoard(const std::vector<Tile>& tiles)
+{
+  staging_.tiles.resize(tiles.size());
+  for (const Tile& t : tiles)
+  {
+    TileState& state = staging_.tiles[t.getId()];
+    state.owner = t.getOwner();
+    state.num_dice = static_cast<std::uint8_t> (t.getNumDice());
+  }
+
+  ++staging_.board_version;
+  publish();
 }
 
 
-Display::~Display()
+ColorPair Display::getOwnerColorPair(Tile::owner_t owner)
 {
-  endwin();
+  static const std::array<Color, 7> SHARED = {{
+    Color::BLUE, Color::CYAN, Color::GRAY, Color::GREEN
+      , Color::ORANGE, Color::PINK, Color::RED
+  }};
+
+  if (owner == Tile::NO_OWNER) { return ColorPair::DEFAULT; }
+  if (owner == 0) {
+    return ColorHelpers::getCPWithColoredBackground(Color::PURPLE);
+  }
+
+  return ColorHelpers::getCPWithColoredBackground(
+    SHARED[(owner - 1) % SHARED.size()]);
 }
 
 
-int Display::blinkUntilKeypress(std::vector<Tile::coord_t> coordinates) const
+bool Display::getMouseCoordinate(Tile::coord_t& coord) const
 {
-  bool blink_on = true;
-  int ch = ERR;
+  if (last_input_.key != MOUSE || !last_input_.on_board) { return false; }
 
-  // User can't select anything, just hit enter for them
-  if (coordinates.size() < 1) { return '\n'; }
+  coord = last_input_.coord;
+  return true;
+}
 
-  // Find any space in the given coordinates (all should be exactly the same)
-  size_t x, y;
-  decodeCoordinate(coordinates[0], x, y);
 
-  // Mark what it originally looked like before we started blinking
-  int orig_ch = mvinch(y, x);
-  int blink_ch =
-    COLOR_PAIR(static_cast<int>(ColorPair::WHITE_BLACK))
-    | (static_cast<char>(orig_ch));
+const Viewport& Display::getViewport()
+{
+  checkDimensions();
 
-  // This loop will happen every half second
-  do
-  {
-    drawValue(coordinates, blink_on ? blink_ch : orig_ch);
+  return staging_.viewport;
+}
 
-    // flip state
-    blink_on = !blink_on;
-  } while ((ch = getch()) == ERR);
 
-  // Make sure we restore what it originally looked like
-  drawValue(coordinates, orig_ch);
+bool Display::pan(long dx, long dy)
+{
+  checkDimensions();
+  if (!staging_.viewport.pan(dx, dy)) { return false; }
 
-  return ch;
+  ++staging_.board_version;
+  publish();
+  return true;
 }
 
 
-void Display::clearMessageBar()
+bool Display::zoomIn()
 {
-  size_t y = known_terminal_height / 2;
-  y += game_height / 2 + 1;
+  checkDimensions();
+  if (!staging_.viewport.zoomIn()) { return false; }
 
-  move(y, 0);
-  for (size_t i = 0; i < known_terminal_width; ++i)
-  {
-    addch(' ');
-  }
+  ++staging_.board_version;
+  publish();
+  return true;
 }
 
 
-void Display::decodeCoordinate(size_t coord, size_t& x, size_t& y) const
+bool Display::zoomOut()
 {
-  x = coord % game_width;
-  y = coord / game_width;
-
-  // Now center them
-  size_t center_x = known_terminal_width / 2;
-  size_t center_y = known_terminal_height / 2;
+  checkDimensions();
+  if (!staging_.viewport.zoomOut()) { return false; }
 
-  x += center_x - (game_width / 2);
-  y += center_y - (game_height / 2);
+  ++staging_.board_version;
+  publish();
+  return true;
 }
 
 
-void Display::drawValue(
-  std::vector<Tile::coord_t>& coordinates
-  , int character)
-  const
+bool Display::scrollTo(const std::vector<Tile::coord_t>& coordinates)
 {
-  // We only need to clear the screen if it was resized.
-  size_t max_x, max_y;
-  getmaxyx(stdscr, max_y, max_x);
-  if (max_x != known_terminal_width || max_y != known_terminal_height) {
-    clear();
-    known_terminal_width = max_x;
-    known_terminal_height = max_y;
-  }
+  if (coordinates.empty()) { return false; }
 
-  // Print character to screen at coordinates
-  for (size_t coord : coordinates)
+  checkDimensions();
+
+  size_t col, row;
+  for (Tile::coord_t coord : coordinates)
   {
-    size_t x, y;
-    decodeCoordinate(coord, x, y);
+    if (staging_.viewport.mapToScreen(coord, col, row)) { return false; }
+  }
 
-    mvaddch(y, x, character);
+  // Nothing is visible, so bring the middle of the coordinates into view
+  if (!staging_.viewport.centerOn(coordinates[coordinates.size() / 2])) {
+    return false;
   }
+
+  ++staging_.board_version;
+  publish();
+  return true;
 }
 
 
-int Display::getDisplayableCharacter(Color c, char d)
+void Display::togglePerfHud()
 {
-  ColorPair cp = ColorHelpers::getCPWithColoredBackground(c);
-
-  auto to_return = static_cast<int> (d);
-
-  return d | COLOR_PAIR(cp);
+  staging_.show_perf = !staging_.show_perf;
+  ++staging_.board_version;
+  publish();
 }
 
 
 void Display::printMessage(std::string msg)
 {
-  size_t msg_len = msg.length();
-
-  size_t center_x = known_terminal_width / 2;
-  size_t center_y = known_terminal_height / 2;
-
-  center_x -= msg_len / 2;
-  center_y += game_height / 2 + 1;
-
-  mvaddstr(center_y, center_x, msg.c_str());
-  refresh();
+  staging_.message = std::move(msg);
+  publish();
 }
 
 void Display::printMessage(const char* msg)
 {
-  std::string str_msg (msg);
-  printMessage(str_msg);
+  // Reuses the message's memory
+  staging_.message.assign(msg);
+  publish();
 }
 
 
-/***********
- * HELPERS *
- ***********/
-
-inline void Init_color(Color c, short int r, short int g, short int b)
+void Display::setGrid(std::shared_ptr<const TileGrid> grid)
 {
-  init_color(static_cast<short int>(c), r, g, b);
+  staging_.viewport = Viewport(grid->getWidth(), grid->getHeight());
+  staging_.grid = std::move(grid);
+  staging_.tiles.clear();
+  staging_.blinking = TileGrid::NO_TILE;
+  ++staging_.board_version;
+
+  // Make sure the new viewport gets fit to the terminal
+  seen_terminal_width_ = seen_terminal_height_ = 0;
+  checkDimensions();
+
+  publish();
 }
 
 
-inline void Init_pair(ColorPair cp, short int f, Color b)
+void Display::checkDimensions()
 {
-  init_pair(static_cast<short int>(cp), f, static_cast<short int>(b));
-}
+  size_t width, height;
+  getTerminalSize(width, height);
+
+  if (width != seen_terminal_width_ || height != seen_terminal_height_) {
+    seen_terminal_width_ = width;
+    seen_terminal_height_ = height;
 
+    // Leave the last row for the message bar
+    staging_.viewport.resize(width, height > 0 ? height - 1 : 0);
+    ++staging_.board_version;
+  }
+}
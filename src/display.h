@@ -1,12 +1,23 @@
 #ifndef DISPLAY_H
 #define DISPLAY_H
 
-#include <ncurses.h>
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 #include "color.h"
+#include "frame.h"
 #include "tile.h"
+#include "tile_grid.h"
+#include "trace.h"
+#include "viewport.h"
 
+/**
+ * Shows the game to the user. The game only ever talks to this interface; it
+ * keeps the frame currently being built and hands a finished copy to the
+ * backend (a terminal, a recording, or nothing at all) whenever it changes.
+ */
 class Display
 {
 
@@ -18,7 +29,7 @@ class Display
 
     Display(size_t width, size_t height);
 
-    ~Display();
+    virtual ~Display() = default;
 
 
     /***********
@@ -26,14 +37,12 @@ class Display
      ***********/
 
     /**
-     * Blinks the given coordinates until the user presses a key and returns it.
-     * It is assumed that every coordinate will have the same character
-     * on-screen.
+     * Blinks the given tile until the user presses a key and returns it.
      *
-     * @param {std::vector<size_t>} coordinates The coordinates to blink.
+     * @param {Tile} t The tile to blink.
      * @returns {int} The key pressed by the user.
      */
-    int blinkUntilKeypress(std::vector<Tile::coord_t> coordinates) const;
+    int blinkUntilKeypress(const Tile& t);
 
     /**
      * Removes any message currently in the message bar.
@@ -41,36 +50,65 @@ class Display
     void clearMessageBar();
 
     /**
-     * Turns an index into an array into an index into a matrix, where the width
-     * of that matrix is the known game_width. Additionally, centers it on the
-     * screen according to the known game dimensions.
+     * Shows the given state of every tile on the board.
+     *
+     * @param {std::vector<Tile>} tiles Every tile on the board, indexed by id.
+     */
+    void drawBoard(const std::vector<Tile>& tiles);
+
+    /**
+     * Returns what a player's tiles are drawn with. Players are only ids, and
+     * there are fewer colors than there can be players, so the colors are
+     * shared round in turn. The first player, who is the user when they play,
+     * has purple to themselves.
      *
-     * @param {size_t} coord The coordinate to decode.
-     * @param {size_t&} x Where the result's x-value is stored.
-     * @param {size_t&} y Where the result's y-value is stored.
+     * @param {Tile::owner_t} owner The player's id, or Tile::NO_OWNER.
+     * @returns {ColorPair} White on the player's color.
      */
-    void decodeCoordinate(size_t coord, size_t& x, size_t& y) const;
+    static ColorPair getOwnerColorPair(Tile::owner_t owner);
 
     /**
-     * Draws the same character to the screen at every coordinate given.
+     * Finds which board coordinate the last mouse click landed on. Should be
+     * called after blinkUntilKeypress returns MOUSE.
      *
-     * @param {std::vector<size_t>} coordinates The coordinates to draw the
-     * character to.
-     * @param {int} character An ncurses-printable character.
+     * @param {Tile::coord_t&} coord Where the coordinate is stored.
+     * @returns {bool} False if the click was not on the board.
      */
-    void drawValue(
-      std::vector<Tile::coord_t>& coordinates
-      , int character)
-      const;
+    bool getMouseCoordinate(Tile::coord_t& coord) const;
 
     /**
-     * Returns a character that ncurses can use.
+     * Returns the camera over the game board, updated for the current size of
+     * the terminal.
      *
-     * @param {Color} c The color that this character should be.
-     * @param {char} d The character to display.
-     * @returns {int} An ncurses-printable character.
+     * @returns {const Viewport&} The viewport.
      */
-    static int getDisplayableCharacter(Color c, char d);
+    const Viewport& getViewport();
+
+    /**
+     * Moves the camera by the given number of characters.
+     *
+     * @param {long} dx Characters to move right (negative for left).
+     * @param {long} dy Characters to move down (negative for up).
+     * @returns {bool} True if the camera moved.
+     */
+    bool pan(long dx, long dy);
+
+    /**
+     * Changes how many map cells each character on the screen represents.
+     *
+     * @returns {bool} True if the zoom level changed.
+     */
+    bool zoomIn();
+    bool zoomOut();
+
+    /**
+     * Moves the camera so that at least part of the given coordinates are
+     * on-screen.
+     *
+     * @param {std::vector<size_t>} coordinates The coordinates to show.
+     * @returns {bool} True if the camera moved.
+     */
+    bool scrollTo(const std::vector<Tile::coord_t>& coordinates);
 
     /**
      * Prints a message below the game board.
@@ -80,37 +118,148 @@ class Display
     void printMessage(std::string msg);
     void printMessage(const char* msg);
 
+    /**
+     * Tells the display which board it is showing. Resets the camera.
+     *
+     * @param {std::shared_ptr<const TileGrid>} grid Where each tile is.
+     */
+    void setGrid(std::shared_ptr<const TileGrid> grid);
+
+    /**
+     * Shows or hides how long things are taking, over the board.
+     */
+    void togglePerfHud();
+
+    /**
+     * Gives the user time to read what is on the screen.
+     *
+     * @param {int} ms How long to wait, in milliseconds.
+     */
+    void pause(int ms)
+    {
+      Trace::Span span ("Display::pause");
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      wait(ms);
+      paused_ += std::chrono::steady_clock::now() - start;
+    }
+
+    /**
+     * Returns how long the game has really been paused for, which is nothing
+     * on displays that do not wait, so that timings can leave it out.
+     *
+     * @returns {std::chrono::nanoseconds} The total of every pause.
+     */
+    std::chrono::nanoseconds getPaused() const { return paused_; }
+
 
     /**************
      * PROPERTIES *
      **************/
 
-    static const int UP = KEY_UP;
-    static const int DOWN = KEY_DOWN;
-    static const int LEFT = KEY_LEFT;
-    static const int RIGHT = KEY_RIGHT;
+    // Keys that are not plain characters
+    static const int UP = 0x101;
+    static const int DOWN = 0x102;
+    static const int LEFT = 0x103;
+    static const int RIGHT = 0x104;
+    static const int MOUSE = 0x105;
+
+    static const int PAN_UP = 'w';
+    static const int PAN_DOWN = 's';
+    static const int PAN_LEFT = 'a';
+    static const int PAN_RIGHT = 'd';
+    static const int ZOOM_IN = '+';
+    static const int ZOOM_OUT = '-';
+    static const int QUIT = 'q';
     static const size_t MINIMUM_WIDTH = 80;
     static const size_t MINIMUM_HEIGHT = 24;
 
 
+  protected:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * A key press, along with where it happened if it was a mouse click.
+     */
+    struct InputEvent
+    {
+      int key;
+      bool on_board;
+      Tile::coord_t coord;
+
+      // When the key was read, as nanoseconds on the steady clock, if known
+      std::uint64_t read_at;
+    };
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Waits for a pause, however the backend does that.
+     *
+     * @param {int} ms How long to wait, in milliseconds.
+     */
+    virtual void wait(int ms) = 0;
+
+    /**
+     * Shows a finished frame. The frame belongs to the display, so backends
+     * that keep it around have to copy it.
+     *
+     * @param {Frame} frame The frame.
+     */
+    virtual void present(const Frame& frame) = 0;
+
+    /**
+     * Waits until the user presses a key.
+     *
+     * @returns {InputEvent} The key press.
+     */
+    virtual InputEvent waitForInput() = 0;
+
+    /**
+     * Gets the size of the screen the backend draws to.
+     *
+     * @param {size_t&} width Where the width in characters is stored.
+     * @param {size_t&} height Where the height in characters is stored.
+     */
+    virtual void getTerminalSize(size_t& width, size_t& height) const = 0;
+
+
   private:
 
-    /**************
-     * PROPERTIES *
-     **************/
+    /***********
+     * METHODS *
+     ***********/
 
-    /*** CLASS PROPERTIES ***/
+    /**
+     * Fits the camera to the current size of the terminal.
+     */
+    void checkDimensions();
 
-    mutable size_t known_terminal_width = 0
-    , known_terminal_height = 0;
+    /**
+     * Hands the current frame to the backend.
+     */
+    void publish()
+    {
+      Trace::Span span ("Display::publish");
+      present(staging_);
+    }
 
 
-    /*** INSTANCE PROPERTIES ***/
+    /**************
+     * PROPERTIES *
+     **************/
 
-    size_t game_width, game_height;
-    WINDOW* WIN;
+    Frame staging_;
+    InputEvent last_input_ = { 0, false, 0, 0 };
+    size_t seen_terminal_width_ = 0, seen_terminal_height_ = 0;
+    std::chrono::nanoseconds paused_ { 0 };
 
 };
 
 #endif
-
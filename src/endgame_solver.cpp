@@ -0,0 +1,631 @@
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <bitset>
+#include <stdexcept>
+#include "adjacency.h"
+#include "board.h"
+#include "endgame_solver.h"
+#include "fight_odds.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t EndgameSolver::MAX_TILES;
+const size_t EndgameSolver::MAX_SEATS;
+const size_t EndgameSolver::MAX_GROUPS;
+const std::uint8_t EndgameSolver::NEUTRAL;
+
+const EndgameSolver::Limits EndgameSolver::DEFAULT_LIMITS = {
+  6
+  , 2
+  , 16
+  , 20000
+  , 1 << 14
+};
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+void EndgameSolver::setLimits(const Limits& limits)
+{
+  if (limits.max_tiles > MAX_TILES || limits.max_players > MAX_SEATS) {
+    throw std::invalid_argument("Too many tiles or players to solve.");
+  }
+  if (limits.table_size == 0
+      || (limits.table_size & (limits.table_size - 1)) != 0) {
+    throw std::invalid_argument("The table size must be a power of two.");
+  }
+
+  limits_ = limits;
+  table_.clear();
+}
+
+
+bool EndgameSolver::solve(
+  const Board& b
+  , const Tile::owner_t* seats
+  , size_t num_seats
+  , std::vector<Move>& moves)
+{
+  moves.clear();
+
+  if (num_seats < 2 || num_seats > limits_.max_players) { return false; }
+
+  Shape shape {};
+  if (!mapTiles(b, seats, num_seats, shape)) { return false; }
+
+  // What is remembered only holds for the shape it was worked out on
+  if (!isSameShape(shape, shape_) || table_.size() != limits_.table_size) {
+    table_.assign(limits_.table_size, Entry());
+  }
+  shape_ = shape;
+  size_t num_tiles = shape_.num_tiles;
+
+  State s;
+  std::fill(std::begin(s.owners), std::end(s.owners), NEUTRAL);
+  std::fill(std::begin(s.dice), std::end(s.dice), 0);
+  std::fill(std::begin(s.banked), std::end(s.banked), 0);
+  Board::tile_iterator tiles = b.getTiles();
+  for (size_t i = 0; i < num_tiles; ++i)
+  {
+    const Tile& tile = *(tiles + ids_[i]);
+    const Tile::owner_t* seat =
+      std::find(seats, seats + num_seats, tile.getOwner());
+    if (seat != seats + num_seats) {
+      s.owners[i] = static_cast<std::uint8_t> (seat - seats);
+    }
+    s.dice[i] = static_cast<std::uint8_t> (tile.getNumDice());
+  }
+  for (size_t i = 0; i < num_seats; ++i)
+  {
+    s.banked[i] = static_cast<std::uint8_t> (b.getBankedDice(seats[i]));
+  }
+  s.playing = static_cast<std::uint8_t> ((1u << num_seats) - 1);
+  s.seat = 0;
+
+  unsigned frontline = getFrontline(s, 0);
+  if (frontline == 0) { return false; }
+
+  // Look a turn further each time, keeping the last look that finished
+  num_positions_ = 0;
+  aborted_ = false;
+  bool solved = false;
+  for (size_t num_turns = 1; num_turns <= limits_.max_turns; ++num_turns)
+  {
+    if (outcomes_.size() < 2 * num_turns) { outcomes_.resize(2 * num_turns); }
+
+    moves_.clear();
+    bool sure_win = false;
+    for (size_t from = 0; from < num_tiles && !aborted_; ++from)
+    {
+      if (!(frontline & (1u << from))) { continue; }
+
+      for (size_t to = 0; to < num_tiles && !aborted_; ++to)
+      {
+        if (!(shape_.neighbors[from] & (1u << to)) || s.owners[to] == 0) {
+          continue;
+        }
+
+        // Whatever the others win, the player to move loses. The tiles are
+        // numbered in order of id, so the moves stay in that order.
+        Values values = getAttackValues(s, from, to, num_turns);
+        Move move = {
+          ids_[from]
+          , ids_[to]
+          , values[0]
+          , values[0] - getScore(values, 0)
+          , num_turns
+        };
+        moves_.push_back(move);
+        sure_win = sure_win || move.win_chance >= 1;
+      }
+    }
+
+    if (aborted_) { break; }
+
+    moves.swap(moves_);
+    solved = true;
+
+    // Looking further cannot do better than a sure win
+    if (sure_win) { break; }
+  }
+
+  return solved;
+}
+
+
+bool EndgameSolver::mapTiles(
+  const Board& b
+  , const Tile::owner_t* seats
+  , size_t num_seats
+  , Shape& shape)
+{
+  const std::uint8_t BEHIND = 0xFF, GROUPED = 0xFE;
+
+  const Adjacency& adjacency = b.getAdjacency();
+  Board::tile_iterator tiles = b.getTiles();
+  size_t num_board_tiles = adjacency.getNumTiles();
+  index_.assign(num_board_tiles, BEHIND);
+
+  // The tiles looked at border somebody else's, so they are the only ones
+  // that can attack or be attacked
+  size_t num_tiles = 0;
+  for (size_t id = 0; id < num_board_tiles; ++id)
+  {
+    Tile::owner_t owner = (tiles + id)->getOwner();
+    const tile_id_t* neighbors = adjacency.getNeighbors(id);
+    bool contested = false;
+    for (size_t i = 0; i < adjacency.getDegree(id) && !contested; ++i)
+    {
+      contested = (tiles + neighbors[i])->getOwner() != owner;
+    }
+    if (!contested) { continue; }
+
+    if (num_tiles == limits_.max_tiles) { return false; }
+    index_[id] = static_cast<std::uint8_t> (num_tiles);
+    ids_[num_tiles++] = static_cast<tile_id_t> (id);
+  }
+  shape.num_tiles = num_tiles;
+
+  for (size_t i = 0; i < num_tiles; ++i)
+  {
+    const tile_id_t* neighbors = adjacency.getNeighbors(ids_[i]);
+    for (size_t j = 0; j < adjacency.getDegree(ids_[i]); ++j)
+    {
+      std::uint8_t index = index_[neighbors[j]];
+      if (index < MAX_TILES) { shape.neighbors[i] |= 1u << index; }
+    }
+  }
+
+  // Every tile behind borders only its owner's tiles, so each group of them
+  // touches only its owner's tiles looked at
+  for (size_t id = 0; id < num_board_tiles; ++id)
+  {
+    if (index_[id] != BEHIND) { continue; }
+
+    const Tile::owner_t* seat =
+      std::find(seats, seats + num_seats, (tiles + id)->getOwner());
+    if (seat == seats + num_seats) { continue; }
+    size_t owner = static_cast<size_t> (seat - seats);
+
+    unsigned touched = 0;
+    size_t size = 0;
+    stack_.assign(1, static_cast<tile_id_t> (id));
+    index_[id] = GROUPED;
+    while (!stack_.empty())
+    {
+      tile_id_t next = stack_.back();
+      stack_.pop_back();
+      ++size;
+
+      size_t num_dice = (tiles + next)->getNumDice();
+      if (num_dice < GameRules::MAX_DICE_PER_TILE) {
+        ++shape.num_open[owner];
+        shape.room[owner] += GameRules::MAX_DICE_PER_TILE - num_dice;
+      }
+
+      const tile_id_t* neighbors = adjacency.getNeighbors(next);
+      for (size_t i = 0; i < adjacency.getDegree(next); ++i)
+      {
+        std::uint8_t index = index_[neighbors[i]];
+        if (index < MAX_TILES) {
+          touched |= 1u << index;
+        }
+        else if (index == BEHIND) {
+          index_[neighbors[i]] = GROUPED;
+          stack_.push_back(neighbors[i]);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < num_tiles; ++i)
+    {
+      if (touched & (1u << i)) { shape.links[i] |= touched & ~(1u << i); }
+    }
+
+    // Groups touching the same tiles are always counted together, while
+    // groups touching none never are, so only the largest of those matters
+    size_t group = 0;
+    while (group < shape.num_groups
+        && (shape.group_seats[group] != owner
+          || shape.group_tiles[group] != touched)) {
+      ++group;
+    }
+    if (group == shape.num_groups) {
+      if (group == MAX_GROUPS) { return false; }
+      shape.group_seats[group] = static_cast<std::uint8_t> (owner);
+      shape.group_tiles[group] = touched;
+      shape.group_sizes[group] = 0;
+      ++shape.num_groups;
+    }
+    shape.group_sizes[group] = touched == 0
+      ? std::max(shape.group_sizes[group], size)
+      : shape.group_sizes[group] + size;
+  }
+
+  return true;
+}
+
+
+bool EndgameSolver::isSameShape(const Shape& a, const Shape& b)
+{
+  if (a.num_tiles != b.num_tiles
+      || a.neighbors != b.neighbors
+      || a.links != b.links
+      || a.num_groups != b.num_groups
+      || a.num_open != b.num_open
+      || a.room != b.room) {
+    return false;
+  }
+
+  for (size_t group = 0; group < a.num_groups; ++group)
+  {
+    if (a.group_seats[group] != b.group_seats[group]
+        || a.group_tiles[group] != b.group_tiles[group]
+        || a.group_sizes[group] != b.group_sizes[group]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+
+EndgameSolver::Values EndgameSolver::getValues(State s, size_t num_turns)
+{
+  // Whoever has nowhere to attack from is out when their turn comes
+  for (;;)
+  {
+    if (std::bitset<MAX_SEATS>(s.playing).count() == 1) {
+      Values values {};
+      values[getNextSeat(s.playing, s.seat)] = 1;
+      return values;
+    }
+
+    if (getFrontline(s, s.seat) != 0) { break; }
+
+    s.playing = static_cast<std::uint8_t> (s.playing & ~(1u << s.seat));
+    s.seat = getNextSeat(s.playing, s.seat);
+  }
+
+  // Every position reached counts, remembered or not, since every way the
+  // dice can fall leads to one
+  if (++num_positions_ > limits_.max_positions) {
+    aborted_ = true;
+    return Values {};
+  }
+
+  if (num_turns == 0) { return Values {}; }
+
+  std::uint64_t key[2];
+  getKey(s, num_turns, key);
+  Entry& entry = getEntry(key);
+  if (entry.key[0] == key[0] && entry.key[1] == key[1]) {
+    return entry.values;
+  }
+
+  // The seat to move makes whichever attack is best for them
+  unsigned frontline = getFrontline(s, s.seat);
+  Values best {};
+  bool found = false;
+  for (size_t from = 0; from < shape_.num_tiles; ++from)
+  {
+    if (!(frontline & (1u << from))) { continue; }
+
+    for (size_t to = 0; to < shape_.num_tiles; ++to)
+    {
+      if (!(shape_.neighbors[from] & (1u << to)) || s.owners[to] == s.seat) {
+        continue;
+      }
+
+      Values values = getAttackValues(s, from, to, num_turns);
+      if (aborted_) { return Values {}; }
+
+      if (!found || getScore(values, s.seat) > getScore(best, s.seat)) {
+        found = true;
+        best = values;
+      }
+    }
+  }
+
+  // Looking further may have pushed the entry out, which is fine
+  Entry& slot = getEntry(key);
+  slot.key[0] = key[0];
+  slot.key[1] = key[1];
+  slot.values = best;
+
+  return best;
+}
+
+
+EndgameSolver::Values EndgameSolver::getAttackValues(
+  const State& s
+  , size_t attacker
+  , size_t defender
+  , size_t num_turns)
+{
+  // This has to follow the same rules as Board::resolveFight
+  double win_chance = FightOdds<GameRules>::get().getWinChance(
+    s.dice[attacker]
+    , s.dice[defender]);
+
+  Values values {};
+  auto add = [&values](double chance, const Values& outcome)
+  {
+    for (size_t i = 0; i < MAX_SEATS; ++i)
+    {
+      values[i] += chance * outcome[i];
+    }
+  };
+
+  if (win_chance > 0) {
+    State won = s;
+    won.owners[defender] = s.seat;
+    won.dice[defender] = static_cast<std::uint8_t> (std::min<size_t>(
+      static_cast<size_t> (s.dice[attacker]) - 1
+      , GameRules::MAX_DICE_PER_TILE));
+    won.dice[attacker] = 1;
+    add(win_chance, getReinforcedValues(won, num_turns));
+  }
+
+  if (win_chance < 1 && !aborted_) {
+    State lost = s;
+    lost.dice[attacker] = 1;
+    add(1 - win_chance, getReinforcedValues(lost, num_turns));
+  }
+
+  return values;
+}
+
+
+EndgameSolver::Values EndgameSolver::getReinforcedValues(
+  const State& s
+  , size_t num_turns)
+{
+  // This has to follow the same rules as Board::reinforce
+  size_t seat = s.seat;
+  size_t num_dice = s.banked[seat] + getLargestRegion(s, seat);
+
+  State next = s;
+  next.seat = getNextSeat(s.playing, seat);
+
+  size_t open[MAX_TILES];
+  size_t num_open = 0, room = shape_.room[seat];
+  for (size_t id = 0; id < shape_.num_tiles; ++id)
+  {
+    if (s.owners[id] == seat && s.dice[id] < GameRules::MAX_DICE_PER_TILE) {
+      open[num_open++] = id;
+      room += GameRules::MAX_DICE_PER_TILE - s.dice[id];
+    }
+  }
+
+  // Enough dice to fill every tile leaves nothing to chance
+  if (num_dice >= room) {
+    for (size_t i = 0; i < num_open; ++i)
+    {
+      next.dice[open[i]] = GameRules::MAX_DICE_PER_TILE;
+    }
+    next.banked[seat] = static_cast<std::uint8_t> (
+      std::min<size_t>(num_dice - room, GameRules::MAX_BANKED_DICE));
+
+    return getValues(next, num_turns - 1);
+  }
+  next.banked[seat] = 0;
+
+  // Otherwise hand the dice out one at a time, each to any tile with room
+  // alike, merging the ways that end up the same. Dice given to the tiles
+  // behind are simply gone.
+  size_t num_behind = shape_.num_open[seat];
+  std::vector<std::pair<std::uint32_t, double>>& ways =
+    outcomes_[2 * (num_turns - 1)];
+  std::vector<std::pair<std::uint32_t, double>>& more =
+    outcomes_[2 * (num_turns - 1) + 1];
+  ways.clear();
+  ways.emplace_back(0, 1);
+  for (size_t die = 0; die < num_dice; ++die)
+  {
+    more.clear();
+    for (const std::pair<std::uint32_t, double>& way : ways)
+    {
+      size_t num_room = 0;
+      for (size_t i = 0; i < num_open; ++i)
+      {
+        if (s.dice[open[i]] + ((way.first >> (4 * i)) & 0xF)
+            < GameRules::MAX_DICE_PER_TILE) {
+          ++num_room;
+        }
+      }
+
+      double chance = way.second / (num_room + num_behind);
+      for (size_t i = 0; i < num_open; ++i)
+      {
+        if (s.dice[open[i]] + ((way.first >> (4 * i)) & 0xF)
+            < GameRules::MAX_DICE_PER_TILE) {
+          more.emplace_back(way.first + (1u << (4 * i)), chance);
+        }
+      }
+      if (num_behind > 0) {
+        more.emplace_back(way.first, chance * num_behind);
+      }
+    }
+
+    std::sort(std::begin(more), std::end(more));
+    ways.clear();
+    for (const std::pair<std::uint32_t, double>& way : more)
+    {
+      if (!ways.empty() && ways.back().first == way.first) {
+        ways.back().second += way.second;
+      }
+      else {
+        ways.push_back(way);
+      }
+    }
+  }
+
+  // Every way leads to a position, so too many cannot all be looked at
+  if (num_positions_ > limits_.max_positions
+      || ways.size() > limits_.max_positions - num_positions_) {
+    aborted_ = true;
+    return Values {};
+  }
+
+  Values values {};
+  for (const std::pair<std::uint32_t, double>& way : ways)
+  {
+    State reinforced = next;
+    for (size_t i = 0; i < num_open; ++i)
+    {
+      reinforced.dice[open[i]] = static_cast<std::uint8_t> (
+        reinforced.dice[open[i]] + ((way.first >> (4 * i)) & 0xF));
+    }
+
+    Values outcome = getValues(reinforced, num_turns - 1);
+    if (aborted_) { return Values {}; }
+
+    for (size_t i = 0; i < MAX_SEATS; ++i)
+    {
+      values[i] += way.second * outcome[i];
+    }
+  }
+
+  return values;
+}
+
+
+unsigned EndgameSolver::getFrontline(const State& s, size_t seat) const
+{
+  unsigned own = 0;
+  for (size_t id = 0; id < shape_.num_tiles; ++id)
+  {
+    if (s.owners[id] == seat) { own |= 1u << id; }
+  }
+
+  unsigned frontline = 0;
+  for (size_t id = 0; id < shape_.num_tiles; ++id)
+  {
+    if ((own & (1u << id)) && (shape_.neighbors[id] & ~own)) {
+      frontline |= 1u << id;
+    }
+  }
+
+  return frontline;
+}
+
+
+double EndgameSolver::getScore(const Values& values, size_t seat)
+{
+  double others = 0;
+  for (size_t i = 0; i < MAX_SEATS; ++i)
+  {
+    if (i != seat) { others += values[i]; }
+  }
+
+  return values[seat] - others;
+}
+
+
+std::uint8_t EndgameSolver::getNextSeat(unsigned playing, size_t seat)
+{
+  for (size_t i = 1; i <= MAX_SEATS; ++i)
+  {
+    size_t next = (seat + i) % MAX_SEATS;
+    if (playing & (1u << next)) { return static_cast<std::uint8_t> (next); }
+  }
+
+  return static_cast<std::uint8_t> (seat);
+}
+
+
+size_t EndgameSolver::getLargestRegion(const State& s, size_t seat) const
+{
+  unsigned own = 0;
+  for (size_t id = 0; id < shape_.num_tiles; ++id)
+  {
+    if (s.owners[id] == seat) { own |= 1u << id; }
+  }
+
+  // Groups behind that touch none of the seat's tiles stand alone
+  size_t largest = 0;
+  for (size_t group = 0; group < shape_.num_groups; ++group)
+  {
+    if (shape_.group_seats[group] == seat
+        && (shape_.group_tiles[group] & own) == 0) {
+      largest = std::max(largest, shape_.group_sizes[group]);
+    }
+  }
+
+  // Grow a group from the lowest tile left until it stops growing, and add
+  // the groups behind it touches
+  while (own != 0)
+  {
+    unsigned region = own & (~own + 1), grown;
+    do
+    {
+      grown = region;
+      for (size_t id = 0; id < shape_.num_tiles; ++id)
+      {
+        if (region & (1u << id)) {
+          region |= (shape_.neighbors[id] | shape_.links[id]) & own;
+        }
+      }
+    }
+    while (region != grown);
+
+    own &= ~region;
+    size_t size = std::bitset<MAX_TILES>(region).count();
+    for (size_t group = 0; group < shape_.num_groups; ++group)
+    {
+      if (shape_.group_seats[group] == seat
+          && (shape_.group_tiles[group] & region) != 0) {
+        size += shape_.group_sizes[group];
+      }
+    }
+    largest = std::max(largest, size);
+  }
+
+  return largest;
+}
+
+
+void EndgameSolver::getKey(
+  const State& s
+  , size_t num_turns
+  , std::uint64_t* key) const
+{
+  // Seven bits a tile, then whose turn it is and who is still playing
+  key[0] = 0;
+  for (size_t id = 0; id < MAX_TILES; ++id)
+  {
+    key[0] |= static_cast<std::uint64_t> (s.owners[id] | s.dice[id] << 3)
+      << (7 * id);
+  }
+  key[0] |= static_cast<std::uint64_t> (s.seat) << 56;
+  key[0] |= static_cast<std::uint64_t> (s.playing) << 58;
+
+  // Seven bits of banked dice a seat, then the turns left, and a bit that
+  // no empty entry has
+  key[1] = 0;
+  for (size_t seat = 0; seat < MAX_SEATS; ++seat)
+  {
+    key[1] |= static_cast<std::uint64_t> (s.banked[seat]) << (7 * seat);
+  }
+  key[1] |= static_cast<std::uint64_t> (num_turns) << 28;
+  key[1] |= static_cast<std::uint64_t> (1) << 63;
+}
+
+
+EndgameSolver::Entry& EndgameSolver::getEntry(const std::uint64_t* key)
+{
+  std::uint64_t hash = key[0] * 0x9E3779B97F4A7C15ULL
+    ^ (key[1] + 0x632BE59BD9B4E019ULL) * 0xC2B2AE3D27D4EB4FULL;
+  hash ^= hash >> 29;
+
+  return table_[hash & (table_.size() - 1)];
+}
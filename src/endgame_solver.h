@@ -0,0 +1,390 @@
+#ifndef ENDGAME_SOLVER_H
+#define ENDGAME_SOLVER_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "rules.h"
+#include "tile.h"
+#include "tile_grid.h"
+
+class Board;
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Solves small positions exactly. Once so few tiles are left that every
+ * attack, every roll and every way the dice can be handed out afterwards can
+ * be followed, it works out how likely each attack of the player to move is
+ * to win or lose them the game, assuming everybody after them plays their
+ * best: the attack that most raises their own chance of winning over
+ * everybody else's.
+ *
+ * Games can go on forever, so it solves for the chances within a number of
+ * turns, looking one turn further each time until it has looked at as many
+ * positions as it may. What it has worked out is remembered by the
+ * whole position, so later turns and deeper looks reuse it, in a table of a
+ * fixed size where newer positions push out older ones.
+ *
+ * Only the tiles that border somebody else's are looked at, so a big board
+ * can be solved once the fighting is down to a few tiles. The tiles behind
+ * them are taken to stay as they are: they still join up and add to their
+ * owner's groups of touching tiles, and take their share of the dice handed
+ * out, though they are never taken to fill up. A position with tiles behind
+ * is therefore only solved nearly, and one without exactly.
+ */
+class EndgameSolver
+{
+
+  public:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // The most tiles and players a position can have for this to solve it,
+    // so that a position fits in a key of two words
+    static const size_t MAX_TILES = 8;
+    static const size_t MAX_SEATS = 4;
+
+    static_assert(
+      GameRules::MAX_DICE_PER_TILE < 16 && GameRules::MAX_BANKED_DICE < 128
+      , "A position has to fit in a key of two words.");
+
+
+    /*********
+     * TYPES *
+     *********/
+
+    using tile_id_t = TileGrid::tile_id_t;
+
+    /**
+     * Which positions are solved, and how hard to try.
+     */
+    struct Limits
+    {
+      // Positions with more tiles bordering somebody else's, or more
+      // players, than these are left alone
+      size_t max_tiles;
+      size_t max_players;
+
+      // The most turns to look ahead
+      size_t max_turns;
+
+      // The most positions to look at for one solve
+      size_t max_positions;
+
+      // How many positions are remembered, a power of two
+      size_t table_size;
+    };
+
+    // What a solver starts with
+    static const Limits DEFAULT_LIMITS;
+
+    /**
+     * An attack, and what comes of it.
+     */
+    struct Move
+    {
+      tile_id_t attacker, defender;
+
+      // The chances of winning, and of somebody else winning, within
+      // num_turns turns, counting everybody's
+      double win_chance, lose_chance;
+      size_t num_turns;
+    };
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    EndgameSolver() : limits_(DEFAULT_LIMITS) { }
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    const Limits& getLimits() const { return limits_; }
+
+
+    /*** SETTERS ***/
+
+    /**
+     * Sets which positions are solved, and how hard to try.
+     *
+     * @param {Limits} limits The limits. Throws if they are beyond what can
+     * be solved.
+     */
+    void setLimits(const Limits& limits);
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Works out what every attack of the first of some players comes to, if
+     * the position is small enough.
+     *
+     * @param {Board} b The board.
+     * @param {Tile::owner_t*} seats The players still in the game, in the
+     * order they take turns, starting with the one to move. Anybody else's
+     * tiles are never attacked from.
+     * @param {size_t} num_seats How many players there are.
+     * @param {std::vector<Move>&} moves Where the attacks are stored, in
+     * order of the attacking tile's id and then the defending tile's.
+     * @returns {bool} False if too many tiles border somebody else's, the
+     * player cannot attack, or not even the next turn could be looked at.
+     */
+    bool solve(
+      const Board& b
+      , const Tile::owner_t* seats
+      , size_t num_seats
+      , std::vector<Move>& moves);
+
+    /**
+     * Returns how good an attack is for the player making it: their chance
+     * of winning less everybody else's.
+     *
+     * @param {Move} move The attack.
+     * @returns {double} The score, from -1 to 1.
+     */
+    static double getScore(const Move& move)
+    {
+      return move.win_chance - move.lose_chance;
+    }
+
+
+  private:
+
+    /*********
+     * TYPES *
+     *********/
+
+    // The chance of every seat winning
+    using Values = std::array<double, MAX_SEATS>;
+
+    // The most groups of tiles behind the ones looked at that a position
+    // can have for this to solve it
+    static const size_t MAX_GROUPS = 2 * MAX_TILES;
+
+    /**
+     * What stays the same while a position is solved, with the tiles looked
+     * at and players numbered from 0.
+     */
+    struct Shape
+    {
+      size_t num_tiles;
+
+      // A bit for every neighbor of each tile, and for every tile it is
+      // joined to through its owner's tiles behind
+      std::array<unsigned, MAX_TILES> neighbors, links;
+
+      // The groups of touching tiles behind: whose they are, a bit for every
+      // tile looked at that they touch, and how many tiles they have
+      size_t num_groups;
+      std::array<std::uint8_t, MAX_GROUPS> group_seats;
+      std::array<unsigned, MAX_GROUPS> group_tiles;
+      std::array<size_t, MAX_GROUPS> group_sizes;
+
+      // For every seat, how many of their tiles behind have room for dice,
+      // and how much room they have
+      std::array<size_t, MAX_SEATS> num_open, room;
+    };
+
+    /**
+     * A position, with tiles and players numbered from 0.
+     */
+    struct State
+    {
+      // The seat owning each tile, or NEUTRAL
+      std::uint8_t owners[MAX_TILES];
+      std::uint8_t dice[MAX_TILES];
+      std::uint8_t banked[MAX_SEATS];
+
+      // A bit for every seat still playing, and whose turn it is
+      std::uint8_t playing;
+      std::uint8_t seat;
+    };
+
+    /**
+     * A remembered position, and the chance of each seat winning from it.
+     */
+    struct Entry
+    {
+      std::uint64_t key[2];
+      Values values;
+    };
+
+    // The owner of tiles that belong to nobody playing
+    static const std::uint8_t NEUTRAL = 7;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Numbers the tiles that border somebody else's, and works out what the
+     * tiles behind them add.
+     *
+     * @param {Board} b The board.
+     * @param {Tile::owner_t*} seats The players, in turn order.
+     * @param {size_t} num_seats How many players there are.
+     * @param {Shape&} shape Where what the tiles add up to is stored.
+     * @returns {bool} False if there are too many tiles or groups to solve.
+     */
+    bool mapTiles(
+      const Board& b
+      , const Tile::owner_t* seats
+      , size_t num_seats
+      , Shape& shape);
+
+    /**
+     * Returns whether positions on two shapes come to the same, so that what
+     * was remembered for one holds for the other.
+     *
+     * @param {Shape} a The first shape.
+     * @param {Shape} b The second shape.
+     * @returns {bool} True if they are the same.
+     */
+    static bool isSameShape(const Shape& a, const Shape& b);
+
+    /**
+     * Returns the chance of each seat winning within a number of turns, with
+     * everybody playing their best.
+     *
+     * @param {State} s The position.
+     * @param {size_t} num_turns How many turns are left.
+     * @returns {Values} The chances.
+     */
+    Values getValues(State s, size_t num_turns);
+
+    /**
+     * Returns the chances after the seat to move makes an attack, and is
+     * reinforced.
+     *
+     * @param {State} s The position.
+     * @param {size_t} attacker The attacking tile.
+     * @param {size_t} defender The defending tile.
+     * @param {size_t} num_turns How many turns are left, counting this one.
+     * @returns {Values} The chances.
+     */
+    Values getAttackValues(
+      const State& s
+      , size_t attacker
+      , size_t defender
+      , size_t num_turns);
+
+    /**
+     * Returns the chances once the seat to move has been reinforced, over
+     * every way the dice can fall, and the turn has passed on.
+     *
+     * @param {State} s The position after the attack.
+     * @param {size_t} num_turns How many turns are left, counting this one.
+     * @returns {Values} The chances.
+     */
+    Values getReinforcedValues(const State& s, size_t num_turns);
+
+    /**
+     * Returns the tiles of a seat's that border a tile of anybody else's.
+     *
+     * @param {State} s The position.
+     * @param {size_t} seat The seat.
+     * @returns {unsigned} A bit for every tile.
+     */
+    unsigned getFrontline(const State& s, size_t seat) const;
+
+    /**
+     * Returns how good chances are for a seat: their chance of winning less
+     * everybody else's.
+     *
+     * @param {Values} values The chances.
+     * @param {size_t} seat The seat.
+     * @returns {double} The score, from -1 to 1.
+     */
+    static double getScore(const Values& values, size_t seat);
+
+    /**
+     * Finds whose turn is next.
+     *
+     * @param {unsigned} playing A bit for every seat still playing.
+     * @param {size_t} seat The seat whose turn it was.
+     * @returns {std::uint8_t} The next seat after it that is still playing,
+     * which may be itself.
+     */
+    static std::uint8_t getNextSeat(unsigned playing, size_t seat);
+
+    /**
+     * Returns how many tiles are in a seat's largest group of touching tiles.
+     *
+     * @param {State} s The position.
+     * @param {size_t} seat The seat.
+     * @returns {size_t} The number of tiles.
+     */
+    size_t getLargestRegion(const State& s, size_t seat) const;
+
+    /**
+     * Packs a position exactly into two words.
+     *
+     * @param {State} s The position.
+     * @param {size_t} num_turns How many turns are left.
+     * @param {std::uint64_t*} key Where the two words are stored.
+     */
+    void getKey(const State& s, size_t num_turns, std::uint64_t* key) const;
+
+    /**
+     * Returns where a position is remembered in the table.
+     *
+     * @param {std::uint64_t*} key The position's key.
+     * @returns {Entry&} Its entry, which may hold another position.
+     */
+    Entry& getEntry(const std::uint64_t* key);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    Limits limits_;
+
+    // The position being solved, and the board id of each tile looked at.
+    // The table is kept while the shape stays the same.
+    Shape shape_ {};
+    std::array<tile_id_t, MAX_TILES> ids_ {};
+
+    // What numbering the tiles works in, indexed by board id, and kept so
+    // that solving does not allocate
+    std::vector<std::uint8_t> index_;
+    std::vector<tile_id_t> stack_;
+
+    std::vector<Entry> table_;
+
+    // The attacks being looked at, kept so that solving does not allocate
+    std::vector<Move> moves_;
+
+    // How many positions have been looked at for this solve, and whether
+    // there were too many to finish
+    size_t num_positions_ = 0;
+    bool aborted_ = false;
+
+    // The ways dice can be handed out and their chances, as a number of dice
+    // for every tile with room packed four bits each. Two lists for every
+    // turn being looked at, kept so that solving does not allocate once it
+    // has looked as far once.
+    std::vector<std::vector<std::pair<std::uint32_t, double>>> outcomes_;
+
+};
+
+#endif
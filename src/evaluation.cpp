@@ -0,0 +1,427 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <cmath>
+#include "adjacency.h"
+#include "board.h"
+#include "evaluation.h"
+#include "fight_odds.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t Evaluation::EXPOSURE_SCALE;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Evaluation::Features Evaluation::getFeatures(
+  const Board& b
+  , Tile::owner_t owner) const
+{
+  Features features = { 0, 0, 0, 0 };
+  if (owner >= GameRules::MAX_NUM_PLAYERS) { return features; }
+
+  features.num_tiles = b.getNumTiles(owner);
+  features.largest_region = largest_region_[owner];
+  features.frontline_dice = frontline_dice_[owner];
+  features.exposure = exposure_[owner];
+
+  return features;
+}
+
+
+Evaluation::Features Evaluation::getFeaturesAfterFight(
+  const Board& b
+  , size_t attacker_id
+  , size_t defender_id
+  , bool won) const
+{
+  Board::tile_iterator tiles = b.getTiles();
+  const Adjacency& adjacency = b.getAdjacency();
+
+  Tile::owner_t owner = (tiles + attacker_id)->getOwner();
+  Features features = getFeatures(b, owner);
+  if (owner == Tile::NO_OWNER) { return features; }
+
+  won = won && (tiles + defender_id)->getOwner() != owner;
+
+  // The attacker is left with one die, and if it wins, the rest move in
+  Changes changes;
+  changes.num_changes = won ? 2 : 1;
+  changes.ids[0] = attacker_id;
+  changes.states[0].owner = owner;
+  changes.states[0].num_dice = 1;
+  changes.ids[1] = defender_id;
+  changes.states[1].owner = owner;
+  changes.states[1].num_dice = static_cast<std::uint8_t> (std::min(
+    (tiles + attacker_id)->getNumDice() - 1
+    , Tile::MAX_DICE_PER_TILE));
+
+  // Only what a tile of the attacker's adds can change, and only for tiles
+  // next to one that changes
+  auto recount_for_owner = [&](size_t id)
+  {
+    if (counted_owner_[id] == owner) {
+      features.frontline_dice -= frontline_of_[id];
+      features.exposure -= exposure_of_[id];
+    }
+
+    if (changes.get(tiles, id).owner == owner) {
+      size_t frontline, exposure;
+      countTile(b, changes, id, frontline, exposure);
+      features.frontline_dice += frontline;
+      features.exposure += exposure;
+    }
+  };
+
+  const tile_id_t* neighbors = adjacency.getNeighbors(attacker_id);
+  size_t degree = adjacency.getDegree(attacker_id);
+  recount_for_owner(attacker_id);
+  for (size_t i = 0; i < degree; ++i)
+  {
+    recount_for_owner(neighbors[i]);
+  }
+
+  if (!won) { return features; }
+
+  // The defender is one of the attacker's neighbors, so only its neighbors
+  // that are not are left
+  neighbors = adjacency.getNeighbors(defender_id);
+  degree = adjacency.getDegree(defender_id);
+  for (size_t i = 0; i < degree; ++i)
+  {
+    size_t id = neighbors[i];
+    if (id != attacker_id && !adjacency.areAdjacent(id, attacker_id)) {
+      recount_for_owner(id);
+    }
+  }
+
+  // The defender joins up every group of the attacker's that it touches
+  size_t joined = 1;
+  for (size_t i = 0; i < degree; ++i)
+  {
+    if ((tiles + neighbors[i])->getOwner() != owner) { continue; }
+
+    tile_id_t region = region_[neighbors[i]];
+    bool counted = false;
+    for (size_t j = 0; j < i && !counted; ++j)
+    {
+      counted = (tiles + neighbors[j])->getOwner() == owner
+        && region_[neighbors[j]] == region;
+    }
+    if (!counted) { joined += region_size_[region]; }
+  }
+
+  ++features.num_tiles;
+  features.largest_region = std::max(features.largest_region, joined);
+
+  return features;
+}
+
+
+void Evaluation::reset(const Board& b)
+{
+  num_tiles_ = b.getTilesEnd() - b.getTiles();
+
+  counted_owner_.assign(num_tiles_, Tile::NO_OWNER);
+  frontline_of_.assign(num_tiles_, 0);
+  exposure_of_.assign(num_tiles_, 0);
+  frontline_dice_.fill(0);
+  exposure_.fill(0);
+  largest_region_.fill(0);
+
+  region_.assign(num_tiles_, TileGrid::NO_TILE);
+  region_size_.assign(num_tiles_, 0);
+  num_regions_.assign(GameRules::MAX_NUM_PLAYERS * (num_tiles_ + 1), 0);
+
+  stack_.reserve(num_tiles_);
+  marks_.assign(num_tiles_, 0);
+  mark_ = 0;
+
+  for (size_t id = 0; id < num_tiles_; ++id)
+  {
+    recount(b, id);
+  }
+
+  // Every group is found by flooding from the first of its tiles
+  nextMark();
+  Board::tile_iterator tiles = b.getTiles();
+  for (size_t id = 0; id < num_tiles_; ++id)
+  {
+    Tile::owner_t owner = (tiles + id)->getOwner();
+    if (owner == Tile::NO_OWNER || marks_[id] == mark_) { continue; }
+
+    tile_id_t region = static_cast<tile_id_t> (id);
+    region_size_[region] = static_cast<tile_id_t> (
+      flood(b, id, owner, region));
+    countRegion(owner, region_size_[region], true);
+  }
+}
+
+
+void Evaluation::update(const Board& b, size_t id, Tile::owner_t old_owner)
+{
+  Tile::owner_t owner = (b.getTiles() + id)->getOwner();
+  if (owner != old_owner) {
+    if (old_owner != Tile::NO_OWNER) { leaveRegion(b, id, old_owner); }
+    if (owner != Tile::NO_OWNER) { joinRegion(b, id, owner); }
+  }
+
+  // What a tile adds depends on its neighbors too
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(id);
+  size_t degree = adjacency.getDegree(id);
+  recount(b, id);
+  for (size_t i = 0; i < degree; ++i)
+  {
+    recount(b, neighbors[i]);
+  }
+}
+
+
+TileState Evaluation::Changes::get(
+  std::vector<Tile>::const_iterator tiles
+  , size_t id) const
+{
+  for (size_t i = 0; i < num_changes; ++i)
+  {
+    if (ids[i] == id) { return states[i]; }
+  }
+
+  TileState state;
+  state.owner = (tiles + id)->getOwner();
+  state.num_dice = static_cast<std::uint8_t> ((tiles + id)->getNumDice());
+
+  return state;
+}
+
+
+void Evaluation::countTile(
+  const Board& b
+  , const Changes& changes
+  , size_t id
+  , size_t& frontline
+  , size_t& exposure)
+{
+  frontline = 0;
+  exposure = 0;
+
+  Board::tile_iterator tiles = b.getTiles();
+  TileState state = changes.get(tiles, id);
+  if (state.owner == Tile::NO_OWNER) { return; }
+
+  // Tiles nobody owns make a frontline, but cannot attack
+  bool borders_enemy = false;
+  size_t strongest = 0;
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(id);
+  size_t degree = adjacency.getDegree(id);
+  for (size_t i = 0; i < degree; ++i)
+  {
+    TileState neighbor = changes.get(tiles, neighbors[i]);
+    if (neighbor.owner == state.owner) { continue; }
+
+    borders_enemy = true;
+    if (neighbor.owner != Tile::NO_OWNER) {
+      strongest = std::max<size_t>(strongest, neighbor.num_dice);
+    }
+  }
+
+  if (borders_enemy) { frontline = state.num_dice; }
+  if (strongest != 0) {
+    exposure = static_cast<size_t> (std::lround(
+      EXPOSURE_SCALE
+      * FightOdds<GameRules>::get().getWinChance(strongest, state.num_dice)));
+  }
+}
+
+
+void Evaluation::recount(const Board& b, size_t id)
+{
+  Tile::owner_t old_owner = counted_owner_[id];
+  if (old_owner != Tile::NO_OWNER) {
+    frontline_dice_[old_owner] -= frontline_of_[id];
+    exposure_[old_owner] -= exposure_of_[id];
+  }
+
+  Changes none;
+  none.num_changes = 0;
+  size_t frontline, exposure;
+  countTile(b, none, id, frontline, exposure);
+
+  Tile::owner_t owner = (b.getTiles() + id)->getOwner();
+  counted_owner_[id] = owner;
+  frontline_of_[id] = static_cast<std::uint8_t> (frontline);
+  exposure_of_[id] = static_cast<std::uint8_t> (exposure);
+  if (owner != Tile::NO_OWNER) {
+    frontline_dice_[owner] += frontline;
+    exposure_[owner] += exposure;
+  }
+}
+
+
+void Evaluation::leaveRegion(const Board& b, size_t id, Tile::owner_t owner)
+{
+  tile_id_t region = region_[id];
+  size_t old_size = region_size_[region];
+  region_[id] = TileGrid::NO_TILE;
+  region_size_[region] = 0;
+
+  Board::tile_iterator tiles = b.getTiles();
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(id);
+  size_t degree = adjacency.getDegree(id);
+  size_t num_kept = 0;
+  for (size_t i = 0; i < degree; ++i)
+  {
+    if ((tiles + neighbors[i])->getOwner() == owner) { ++num_kept; }
+  }
+
+  if (num_kept == 1 && region != id) {
+    // With only one way in, taking the tile away cannot split the group, and
+    // the group is still named after a tile in it
+    region_size_[region] = static_cast<tile_id_t> (old_size - 1);
+    countRegion(owner, old_size - 1, true);
+  }
+  else {
+    // Each piece it may have split into is named after the first tile of it
+    // next to the one taken away
+    nextMark();
+    for (size_t i = 0; i < degree; ++i)
+    {
+      size_t start = neighbors[i];
+      if ((tiles + start)->getOwner() != owner || marks_[start] == mark_) {
+        continue;
+      }
+
+      tile_id_t piece = static_cast<tile_id_t> (start);
+      region_size_[piece] = static_cast<tile_id_t> (
+        flood(b, start, owner, piece));
+      countRegion(owner, region_size_[piece], true);
+    }
+  }
+
+  // Taken away last, so the largest group is never looked for further down
+  // than it has to be
+  countRegion(owner, old_size, false);
+}
+
+
+void Evaluation::joinRegion(const Board& b, size_t id, Tile::owner_t owner)
+{
+  Board::tile_iterator tiles = b.getTiles();
+  const Adjacency& adjacency = b.getAdjacency();
+  const tile_id_t* neighbors = adjacency.getNeighbors(id);
+  size_t degree = adjacency.getDegree(id);
+
+  // The largest group it touches keeps its name, so the fewest tiles have to
+  // be renamed
+  tile_id_t kept = static_cast<tile_id_t> (id);
+  region_size_[kept] = 0;
+  for (size_t i = 0; i < degree; ++i)
+  {
+    if ((tiles + neighbors[i])->getOwner() != owner) { continue; }
+
+    tile_id_t region = region_[neighbors[i]];
+    if (region_size_[region] > region_size_[kept]) { kept = region; }
+  }
+
+  size_t old_size = region_size_[kept];
+  size_t size = old_size + 1;
+  region_[id] = kept;
+
+  // The tile itself is marked, so renaming a group does not go through it
+  // into the others
+  nextMark();
+  marks_[id] = mark_;
+  for (size_t i = 0; i < degree; ++i)
+  {
+    size_t start = neighbors[i];
+    if ((tiles + start)->getOwner() != owner
+        || region_[start] == kept
+        || marks_[start] == mark_) {
+      continue;
+    }
+
+    tile_id_t region = region_[start];
+    size_t joined = flood(b, start, owner, kept);
+    region_size_[region] = 0;
+    size += joined;
+    countRegion(owner, joined, false);
+  }
+
+  region_size_[kept] = static_cast<tile_id_t> (size);
+  countRegion(owner, size, true);
+  if (old_size != 0) { countRegion(owner, old_size, false); }
+}
+
+
+size_t Evaluation::flood(
+  const Board& b
+  , size_t start
+  , Tile::owner_t owner
+  , tile_id_t region)
+{
+  Board::tile_iterator tiles = b.getTiles();
+  const Adjacency& adjacency = b.getAdjacency();
+
+  size_t num_reached = 0;
+  stack_.clear();
+  stack_.push_back(static_cast<tile_id_t> (start));
+  marks_[start] = mark_;
+  while (!stack_.empty())
+  {
+    tile_id_t id = stack_.back();
+    stack_.pop_back();
+    region_[id] = region;
+    ++num_reached;
+
+    const tile_id_t* neighbors = adjacency.getNeighbors(id);
+    size_t degree = adjacency.getDegree(id);
+    for (size_t i = 0; i < degree; ++i)
+    {
+      tile_id_t neighbor = neighbors[i];
+      if (marks_[neighbor] != mark_
+          && (tiles + neighbor)->getOwner() == owner) {
+        marks_[neighbor] = mark_;
+        stack_.push_back(neighbor);
+      }
+    }
+  }
+
+  return num_reached;
+}
+
+
+void Evaluation::nextMark()
+{
+  // Marks left over from 2^32 rounds ago would look new
+  if (++mark_ == 0) {
+    std::fill(std::begin(marks_), std::end(marks_), 0);
+    mark_ = 1;
+  }
+}
+
+
+void Evaluation::countRegion(Tile::owner_t owner, size_t size, bool add)
+{
+  tile_id_t* counts = &num_regions_[owner * (num_tiles_ + 1)];
+  size_t& largest = largest_region_[owner];
+
+  if (add) {
+    ++counts[size];
+    largest = std::max(largest, size);
+  }
+  else {
+    --counts[size];
+    while (largest > 0 && counts[largest] == 0) { --largest; }
+  }
+}
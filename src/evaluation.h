@@ -0,0 +1,266 @@
+#ifndef EVALUATION_H
+#define EVALUATION_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "frame.h"
+#include "rules.h"
+#include "tile.h"
+#include "tile_grid.h"
+
+class Board;
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * What the AIs judge a position by, for every player: how many tiles they
+ * hold, how big their largest group of touching tiles is, how many dice they
+ * have on their frontline, and how exposed they are to stronger neighbors.
+ *
+ * A board keeps one up to date as tiles change hands. Rather than being
+ * worked out again, each feature is kept per tile and adjusted for the tiles
+ * around a change, so the cost of a fight does not grow with the board. The
+ * features a fight would leave are worked out the same way without making
+ * it, so an AI can weigh every attack it has.
+ */
+class Evaluation
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * How a player stands.
+     */
+    struct Features
+    {
+      size_t num_tiles;
+
+      // The most tiles that touch one another
+      size_t largest_region;
+
+      // Dice on tiles that border somebody else's
+      size_t frontline_dice;
+
+      // The chance of each tile falling to its strongest enemy neighbor,
+      // added up over the tiles, in EXPOSURE_SCALE for every tile sure to
+      // fall
+      size_t exposure;
+    };
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // What exposure is measured in, so that it can be added up exactly
+    static const size_t EXPOSURE_SCALE = 255;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    /**
+     * Returns how a player stands.
+     *
+     * @param {Board} b The board.
+     * @param {Tile::owner_t} owner The player's id.
+     * @returns {Features} Their features, or none for an id without a player.
+     */
+    Features getFeatures(const Board& b, Tile::owner_t owner) const;
+
+    /**
+     * Returns how the attacker would stand after a fight, without making it.
+     * Only the tiles around the fight are looked at.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} attacker_id The attacking tile's id.
+     * @param {size_t} defender_id The defending tile's id.
+     * @param {bool} won Whether the attacker wins.
+     * @returns {Features} The attacking player's features afterwards.
+     */
+    Features getFeaturesAfterFight(
+      const Board& b
+      , size_t attacker_id
+      , size_t defender_id
+      , bool won) const;
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Works every feature out from scratch, such as once a board has been
+     * set up.
+     *
+     * @param {Board} b The board.
+     */
+    void reset(const Board& b);
+
+    /**
+     * Catches up with a tile whose owner or dice have changed.
+     *
+     * @param {Board} b The board, already changed.
+     * @param {size_t} id The tile's id.
+     * @param {Tile::owner_t} old_owner Who owned it before, which may be who
+     * owns it now.
+     */
+    void update(const Board& b, size_t id, Tile::owner_t old_owner);
+
+
+  private:
+
+    /*********
+     * TYPES *
+     *********/
+
+    using tile_id_t = TileGrid::tile_id_t;
+
+    /**
+     * Tiles that are to be looked at as if they were different, so that a
+     * fight can be judged without making it.
+     */
+    struct Changes
+    {
+      size_t num_changes;
+      size_t ids[2];
+      TileState states[2];
+
+      /**
+       * Returns the state of a tile, as if the changes had been made.
+       *
+       * @param {std::vector<Tile>::const_iterator} tiles The board's tiles.
+       * @param {size_t} id The tile's id.
+       * @returns {TileState} Its state.
+       */
+      TileState get(std::vector<Tile>::const_iterator tiles, size_t id) const;
+    };
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Works out what a tile adds to its owner's frontline dice and exposure.
+     *
+     * @param {Board} b The board.
+     * @param {Changes} changes Tiles to look at as if they were different.
+     * @param {size_t} id The tile's id.
+     * @param {size_t&} frontline Where its frontline dice are stored.
+     * @param {size_t&} exposure Where its exposure is stored.
+     */
+    static void countTile(
+      const Board& b
+      , const Changes& changes
+      , size_t id
+      , size_t& frontline
+      , size_t& exposure);
+
+    /**
+     * Works out again what a tile adds to its owner's frontline dice and
+     * exposure.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} id The tile's id.
+     */
+    void recount(const Board& b, size_t id);
+
+    /**
+     * Takes a tile out of the group its old owner had it in, which may split
+     * that group in pieces.
+     *
+     * @param {Board} b The board, already changed.
+     * @param {size_t} id The tile's id.
+     * @param {Tile::owner_t} owner The old owner.
+     */
+    void leaveRegion(const Board& b, size_t id, Tile::owner_t owner);
+
+    /**
+     * Puts a tile into a group of its new owner's, joining up any groups it
+     * touches.
+     *
+     * @param {Board} b The board, already changed.
+     * @param {size_t} id The tile's id.
+     * @param {Tile::owner_t} owner The new owner.
+     */
+    void joinRegion(const Board& b, size_t id, Tile::owner_t owner);
+
+    /**
+     * Puts every tile of a player's that can be reached from one of theirs
+     * in a group, going only through tiles not marked since the last call to
+     * nextMark, and marks them.
+     *
+     * @param {Board} b The board.
+     * @param {size_t} start Where to start.
+     * @param {Tile::owner_t} owner Whose tiles to go through.
+     * @param {tile_id_t} region The group to put them in.
+     * @returns {size_t} How many tiles were reached.
+     */
+    size_t flood(
+      const Board& b
+      , size_t start
+      , Tile::owner_t owner
+      , tile_id_t region);
+
+    /**
+     * Starts a new round of flooding, in which no tile is marked yet.
+     */
+    void nextMark();
+
+    /**
+     * Counts one more or one fewer group of a size for a player, keeping
+     * their largest group's size right.
+     *
+     * @param {Tile::owner_t} owner The player's id.
+     * @param {size_t} size How many tiles are in the group.
+     * @param {bool} add Whether the group is new, rather than gone.
+     */
+    void countRegion(Tile::owner_t owner, size_t size, bool add);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    size_t num_tiles_ = 0;
+
+    // Indexed by tile id: who each tile is counted for, and what it adds to
+    // their frontline dice and exposure
+    std::vector<Tile::owner_t> counted_owner_;
+    std::vector<std::uint8_t> frontline_of_, exposure_of_;
+
+    // Indexed by player id
+    std::array<size_t, GameRules::MAX_NUM_PLAYERS>
+      frontline_dice_, exposure_, largest_region_;
+
+    // Which group each tile is in, named after one of its tiles, or NO_TILE
+    // for tiles nobody owns, and how many tiles each group has, indexed by
+    // that name
+    std::vector<tile_id_t> region_, region_size_;
+
+    // How many groups of each size every player has, a row per player
+    std::vector<tile_id_t> num_regions_;
+
+    // What flooding works in, kept so that a fight does not allocate
+    std::vector<tile_id_t> stack_;
+    std::vector<std::uint32_t> marks_;
+    std::uint32_t mark_ = 0;
+
+};
+
+#endif
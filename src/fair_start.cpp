@@ -0,0 +1,230 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include "fair_start.h"
+#include "playout.h"
+#include "rules.h"
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Mixes the seed of a set of rollouts with the number of one of them, so every
+ * rollout gets its own generator without the allocation a std::seed_seq
+ * makes.
+ *
+ * @param {std::uint64_t} seed Decides every rollout.
+ * @param {size_t} rollout Which rollout it is.
+ * @returns {std::uint32_t} The seed for that rollout's generator.
+ */
+std::uint32_t mix_seed(std::uint64_t seed, size_t rollout);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t FairStart::DEFAULT_MAX_CANDIDATES = 32;
+const size_t FairStart::DEFAULT_TURN_LIMIT = 300;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+FairStart::FairStart(size_t num_rollouts, double tolerance, size_t num_threads)
+  : num_rollouts_(num_rollouts)
+  , tolerance_(tolerance)
+  , num_threads_(std::max<size_t>(num_threads, 1))
+  , max_candidates_(DEFAULT_MAX_CANDIDATES)
+  , turn_limit_(DEFAULT_TURN_LIMIT)
+{ }
+
+
+bool FairStart::balance(
+  std::mt19937& rng
+  , const Adjacency& adjacency
+  , std::vector<TileState>& states
+  , const std::vector<Tile::owner_t>& seats) const
+{
+  std::vector<TileState> candidate = states;
+  std::vector<Tile::owner_t> owners (states.size());
+  std::vector<std::uint8_t> dice (states.size());
+  std::vector<size_t> wins;
+  double best = 2;
+
+  // Most positions are far from fair, which a quarter of the rollouts is
+  // enough to show, allowing for how noisy so few are
+  double even = 1.0 / seats.size();
+  size_t num_screening = std::max<size_t>(num_rollouts_ / 4, 1);
+  double noise = 2 * std::sqrt(even * (1 - even) / num_screening);
+
+  for (size_t i = 0; i < max_candidates_; ++i)
+  {
+    // The first candidate is the position as it was dealt
+    if (i > 0) {
+      for (size_t id = 0; id < candidate.size(); ++id)
+      {
+        owners[id] = candidate[id].owner;
+        dice[id] = candidate[id].num_dice;
+      }
+      std::shuffle(std::begin(owners), std::end(owners), rng);
+      std::shuffle(std::begin(dice), std::end(dice), rng);
+      for (size_t id = 0; id < candidate.size(); ++id)
+      {
+        candidate[id].owner = owners[id];
+        candidate[id].num_dice = dice[id];
+      }
+    }
+
+    std::uint64_t seed = (static_cast<std::uint64_t> (rng()) << 32) | rng();
+    wins.assign(seats.size(), 0);
+    playOut(adjacency, candidate, seats, seed, 0, num_screening, wins);
+    double unfairness = getUnfairness(getRates(wins, num_screening));
+
+    // A position that might be fair gets the rest of its rollouts, unless
+    // screening already played them all, in which case it stands as it is
+    if (unfairness - noise <= tolerance_ && num_screening < num_rollouts_) {
+      playOut(
+        adjacency, candidate, seats, seed, num_screening, num_rollouts_, wins);
+      unfairness = getUnfairness(getRates(wins, num_rollouts_));
+    }
+
+    if (unfairness < best) {
+      best = unfairness;
+      states = candidate;
+    }
+    if (best <= tolerance_) { return true; }
+  }
+
+  return false;
+}
+
+
+std::vector<double> FairStart::getWinRates(
+  const Adjacency& adjacency
+  , const std::vector<TileState>& states
+  , const std::vector<Tile::owner_t>& seats
+  , std::uint64_t seed) const
+{
+  std::vector<size_t> wins (seats.size(), 0);
+  playOut(adjacency, states, seats, seed, 0, num_rollouts_, wins);
+
+  return getRates(wins, num_rollouts_);
+}
+
+
+double FairStart::getUnfairness(const std::vector<double>& win_rates)
+{
+  double even = 1.0 / win_rates.size();
+  double worst = 0;
+  for (double rate : win_rates)
+  {
+    worst = std::max(worst, std::fabs(rate - even));
+  }
+
+  return worst;
+}
+
+
+void FairStart::playOut(
+  const Adjacency& adjacency
+  , const std::vector<TileState>& states
+  , const std::vector<Tile::owner_t>& seats
+  , std::uint64_t seed
+  , size_t first
+  , size_t last
+  , std::vector<size_t>& wins) const
+{
+  // Tiles of somebody who is not playing belong to no seat
+  std::array<std::uint8_t, 0x100> seat_of;
+  seat_of.fill(Playout<GameRules>::NO_SEAT);
+  for (size_t seat = 0; seat < seats.size(); ++seat)
+  {
+    seat_of[seats[seat]] = static_cast<std::uint8_t> (seat);
+  }
+
+  std::vector<std::uint8_t> owners (states.size());
+  std::vector<std::uint8_t> dice (states.size());
+  for (size_t id = 0; id < states.size(); ++id)
+  {
+    owners[id] = seat_of[states[id].owner];
+    dice[id] = states[id].num_dice;
+  }
+
+  // Each rollout has its own generator, so the threads cannot change the
+  // result
+  std::vector<int> winners (last - first);
+  std::atomic<size_t> next (0);
+  auto work = [&]()
+  {
+    // Sized for the worst case up front, so no rollout has to grow it
+    Playout<GameRules> playout;
+    playout.reserve(owners.size());
+    std::mt19937 rng;
+    for (size_t i = next++; i < winners.size(); i = next++)
+    {
+      rng.seed(mix_seed(seed, first + i));
+      winners[i] = playout.play(
+        rng, adjacency, owners, dice, seats.size(), turn_limit_);
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (size_t i = 1; i < num_threads_; ++i)
+  {
+    threads.emplace_back(work);
+  }
+  work();
+
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (int winner : winners)
+  {
+    if (winner >= 0) { ++wins[winner]; }
+  }
+}
+
+
+std::vector<double> FairStart::getRates(
+  const std::vector<size_t>& wins
+  , size_t num_rollouts)
+{
+  std::vector<double> rates (wins.size());
+  for (size_t seat = 0; seat < wins.size(); ++seat)
+  {
+    rates[seat] = static_cast<double> (wins[seat]) / num_rollouts;
+  }
+
+  return rates;
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+std::uint32_t mix_seed(std::uint64_t seed, size_t rollout)
+{
+  // SplitMix64's finalizer, which spreads every bit of its input over the
+  // whole output
+  std::uint64_t z = seed + (rollout + 1) * 0x9E3779B97F4A7C15ULL;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  z ^= z >> 31;
+
+  return static_cast<std::uint32_t> (z ^ (z >> 32));
+}
+
@@ -0,0 +1,170 @@
+#ifndef FAIR_START_H
+#define FAIR_START_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <random>
+#include <vector>
+#include "adjacency.h"
+#include "frame.h"
+#include "tile.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Judges how fair a starting position is by playing it out many times, and
+ * deals the tiles and dice out again until every seat stands about the same
+ * chance of winning. Every seat plays like the easy AI in these rollouts, so
+ * a rollout is only a few microseconds and many of them can be run on every
+ * core when a game starts.
+ */
+class FairStart
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {size_t} num_rollouts How many times to play each position out.
+     * @param {double} tolerance How far from an even share a seat's chance of
+     * winning may be, such as 0.05 for five percentage points.
+     * @param {size_t} num_threads How many rollouts to run at once.
+     */
+    FairStart(size_t num_rollouts, double tolerance, size_t num_threads);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** SETTERS ***/
+
+    /**
+     * Limits how many positions are tried before settling for the fairest one
+     * found.
+     *
+     * @param {size_t} max_candidates The most positions to try.
+     */
+    void setMaxCandidates(size_t max_candidates)
+    {
+      max_candidates_ = max_candidates;
+    }
+
+    /**
+     * Limits how long a rollout lasts. A rollout that reaches the limit is won
+     * by whoever holds the most tiles.
+     *
+     * @param {size_t} max_turns The most turns to play out.
+     */
+    void setTurnLimit(size_t max_turns) { turn_limit_ = max_turns; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Deals the tiles and dice out again until the position is fair. The
+     * seats keep the same number of tiles and the board the same dice.
+     *
+     * @param {std::mt19937&} rng Used to deal and to seed the rollouts.
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @param {std::vector<TileState>&} states The starting position, changed
+     * to the fairest one found.
+     * @param {std::vector<Tile::owner_t>} seats The ids of the players, in
+     * the order they take their turns.
+     * @returns {bool} True if the position is within the tolerance.
+     */
+    bool balance(
+      std::mt19937& rng
+      , const Adjacency& adjacency
+      , std::vector<TileState>& states
+      , const std::vector<Tile::owner_t>& seats) const;
+
+    /**
+     * Plays a position out over and over.
+     *
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @param {std::vector<TileState>} states The starting position.
+     * @param {std::vector<Tile::owner_t>} seats The ids of the players, in
+     * the order they take their turns.
+     * @param {std::uint64_t} seed Decides every rollout.
+     * @returns {std::vector<double>} How often each seat won.
+     */
+    std::vector<double> getWinRates(
+      const Adjacency& adjacency
+      , const std::vector<TileState>& states
+      , const std::vector<Tile::owner_t>& seats
+      , std::uint64_t seed) const;
+
+    /**
+     * Finds how far the least fairly treated seat is from an even share.
+     *
+     * @param {std::vector<double>} win_rates How often each seat won.
+     * @returns {double} The largest difference from an even share.
+     */
+    static double getUnfairness(const std::vector<double>& win_rates);
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Plays some of the rollouts of a position and counts who won them.
+     *
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @param {std::vector<TileState>} states The starting position.
+     * @param {std::vector<Tile::owner_t>} seats The ids of the players, in
+     * the order they take their turns.
+     * @param {std::uint64_t} seed Decides every rollout.
+     * @param {size_t} first The first rollout to play.
+     * @param {size_t} last One past the last rollout to play.
+     * @param {std::vector<size_t>&} wins Where each seat's wins are added.
+     */
+    void playOut(
+      const Adjacency& adjacency
+      , const std::vector<TileState>& states
+      , const std::vector<Tile::owner_t>& seats
+      , std::uint64_t seed
+      , size_t first
+      , size_t last
+      , std::vector<size_t>& wins) const;
+
+    /**
+     * Turns win counts into win rates.
+     *
+     * @param {std::vector<size_t>} wins How many rollouts each seat won.
+     * @param {size_t} num_rollouts How many rollouts there were.
+     * @returns {std::vector<double>} How often each seat won.
+     */
+    static std::vector<double> getRates(
+      const std::vector<size_t>& wins
+      , size_t num_rollouts);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const size_t DEFAULT_MAX_CANDIDATES;
+    static const size_t DEFAULT_TURN_LIMIT;
+
+    size_t num_rollouts_;
+    double tolerance_;
+    size_t num_threads_;
+    size_t max_candidates_;
+    size_t turn_limit_;
+
+};
+
+#endif
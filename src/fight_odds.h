@@ -0,0 +1,123 @@
+#ifndef FIGHT_ODDS_H
+#define FIGHT_ODDS_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <cstddef>
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * The chance of every attack winning, for one variant of the rules. An
+ * attack wins if the attacker rolls a higher total than the defender, so
+ * ties go to the defender. There is one table per variant, worked out the
+ * first time it is asked for.
+ *
+ * @param {Rules} Rules The variant, such as ClassicRules.
+ */
+template <typename Rules>
+class FightOdds
+{
+
+  public:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    /**
+     * Returns the table for this variant.
+     *
+     * @returns {const FightOdds&} The table.
+     */
+    static const FightOdds& get()
+    {
+      static const FightOdds odds;
+
+      return odds;
+    }
+
+    /**
+     * Returns the chance that an attack wins.
+     *
+     * @param {size_t} attacker_dice The dice on the attacking tile.
+     * @param {size_t} defender_dice The dice on the defending tile.
+     * @returns {double} The chance, from 0 to 1.
+     */
+    double getWinChance(size_t attacker_dice, size_t defender_dice) const
+    {
+      return win_chances_[attacker_dice * STRIDE + defender_dice];
+    }
+
+
+  private:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    FightOdds()
+    {
+      // How likely each total is, for every number of dice, built up one die
+      // at a time
+      std::array<std::array<double, NUM_TOTALS>, STRIDE> totals;
+      for (std::array<double, NUM_TOTALS>& chances : totals)
+      {
+        chances.fill(0);
+      }
+      totals[0][0] = 1;
+
+      for (size_t num_dice = 1; num_dice < STRIDE; ++num_dice)
+      {
+        for (size_t total = 0; total < NUM_TOTALS; ++total)
+        {
+          if (totals[num_dice - 1][total] == 0) { continue; }
+
+          for (size_t side = 1; side <= Rules::NUM_SIDES; ++side)
+          {
+            totals[num_dice][total + side] +=
+              totals[num_dice - 1][total] / Rules::NUM_SIDES;
+          }
+        }
+      }
+
+      for (size_t attacker = 0; attacker < STRIDE; ++attacker)
+      {
+        for (size_t defender = 0; defender < STRIDE; ++defender)
+        {
+          // Add up the chance of each defender total times the chance of
+          // the attacker beating it
+          double win = 0, at_most = 0;
+          for (size_t total = 0; total < NUM_TOTALS; ++total)
+          {
+            double above = 1 - at_most - totals[attacker][total];
+            win += totals[defender][total] * above;
+            at_most += totals[attacker][total];
+          }
+          win_chances_[attacker * STRIDE + defender] = win;
+        }
+      }
+    }
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // From no dice up to the most a tile can hold
+    static const size_t STRIDE = Rules::MAX_DICE_PER_TILE + 1;
+    static const size_t NUM_TOTALS = Rules::MAX_TOTAL + 1;
+
+    std::array<double, STRIDE * STRIDE> win_chances_;
+
+};
+
+#endif
@@ -0,0 +1,36 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include "fixture.h"
+#include "tile.h"
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Board make_fixture(
+  std::mt19937& rng
+  , Display& d
+  , size_t width
+  , size_t height
+  , Board::Generator generator
+  , size_t num_tiles
+  , size_t num_players)
+{
+  Board board (rng, d, width, height, generator, num_tiles);
+
+  size_t turn = 0;
+  for (Board::tile_iterator tile = board.getTiles()
+      ; tile != board.getTilesEnd()
+      ; ++tile)
+  {
+    board.setTileOwner(
+      tile->getId()
+      , static_cast<Tile::owner_t> (turn++ % num_players));
+  }
+
+  return board;
+}
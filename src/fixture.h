@@ -0,0 +1,52 @@
+#ifndef FIXTURE_H
+#define FIXTURE_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstddef>
+#include <random>
+#include "board.h"
+#include "display.h"
+#include "rules.h"
+
+
+/*************
+ * CONSTANTS *
+ *************/
+
+// The board turns are timed and checked on as the number of players grows,
+// with a few tiles for each of the most players there can be
+const size_t CROWD_WIDTH = 400, CROWD_HEIGHT = 200;
+const size_t CROWD_NUM_TILES = 3 * GameRules::MAX_NUM_PLAYERS;
+
+
+/*************
+ * FUNCTIONS *
+ *************/
+
+/**
+ * Generates a board and deals its tiles out to players the way a game does:
+ * in id order, one player after another. The benchmarks and the checks both
+ * start from boards made this way.
+ *
+ * @param {std::mt19937&} rng Decides the board.
+ * @param {Display&} d The display to show the board on.
+ * @param {size_t} width The width of the board.
+ * @param {size_t} height The height of the board.
+ * @param {Board::Generator} generator How to divide the board into tiles.
+ * @param {size_t} num_tiles About how many tiles to divide it into.
+ * @param {size_t} num_players How many players to deal to.
+ * @returns {Board} The board.
+ */
+Board make_fixture(
+  std::mt19937& rng
+  , Display& d
+  , size_t width
+  , size_t height
+  , Board::Generator generator
+  , size_t num_tiles
+  , size_t num_players);
+
+#endif
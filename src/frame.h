@@ -0,0 +1,62 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "tile.h"
+#include "tile_grid.h"
+#include "viewport.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * The part of a tile that changes during a game.
+ */
+struct TileState
+{
+  Tile::owner_t owner;
+  std::uint8_t num_dice;
+};
+
+/**
+ * Everything needed to draw one screen of the game. Once published, a frame is
+ * never modified, so the render thread can read it while the game carries on.
+ */
+struct Frame
+{
+  // Which tile is where; shared with the board, never modified
+  std::shared_ptr<const TileGrid> grid;
+
+  // The state of each tile, indexed by id
+  std::vector<TileState> tiles;
+
+  // The camera, not yet fit to the terminal
+  Viewport viewport;
+
+  std::string message;
+
+  // The tile the user is choosing, if any
+  TileGrid::tile_id_t blinking = TileGrid::NO_TILE;
+
+  // Changes whenever anything but the message changes, so that backends can
+  // skip redrawing the board for frames that only show a new message
+  std::uint64_t board_version = 0;
+
+  // Whether to show how long things are taking over the board
+  bool show_perf = false;
+
+  // When the key this frame answers was read, as nanoseconds on the steady
+  // clock, or 0 if it was not read from a terminal
+  std::uint64_t input_time = 0;
+};
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef HEADLESS_DISPLAY_H
+#define HEADLESS_DISPLAY_H
+
+#include "display.h"
+
+/**
+ * Shows nothing and never waits. Used for simulations and batch tools, where
+ * nobody is watching. Any selection asked of a user is answered with enter.
+ */
+class HeadlessDisplay : public Display
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    HeadlessDisplay(size_t width, size_t height) : Display(width, height) { }
+
+
+  protected:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    virtual void wait(int) override { }
+
+    virtual void present(const Frame&) override { }
+
+    virtual InputEvent waitForInput() override
+    {
+      InputEvent enter = { '\n', false, 0, 0 };
+      return enter;
+    }
+
+    virtual void getTerminalSize(size_t& width, size_t& height) const override
+    {
+      width = MINIMUM_WIDTH;
+      height = MINIMUM_HEIGHT;
+    }
+
+};
+
+#endif
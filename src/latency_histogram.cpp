@@ -0,0 +1,110 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <cmath>
+#include "latency_histogram.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t LatencyHistogram::SUB_BUCKET_BITS;
+const size_t LatencyHistogram::MAX_BITS;
+const size_t LatencyHistogram::NUM_BUCKETS;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+LatencyHistogram::LatencyHistogram()
+{
+  clear();
+}
+
+
+double LatencyHistogram::getMean() const
+{
+  std::uint64_t count = count_.load();
+  if (count == 0) { return 0; }
+
+  return static_cast<double> (sum_.load()) / count;
+}
+
+
+std::uint64_t LatencyHistogram::getPercentile(double fraction) const
+{
+  std::uint64_t count = count_.load();
+  if (count == 0) { return 0; }
+
+  // The rank of the duration asked for, counting from one
+  std::uint64_t rank = static_cast<std::uint64_t> (std::ceil(fraction * count));
+  rank = std::min(std::max<std::uint64_t>(rank, 1), count);
+
+  std::uint64_t seen = 0;
+  for (size_t bucket = 0; bucket < NUM_BUCKETS; ++bucket)
+  {
+    seen += getBucketCount(bucket);
+    if (seen >= rank) {
+      return std::min(getBucketLimit(bucket), max_.load());
+    }
+  }
+
+  // Only while another thread is recording
+  return max_.load();
+}
+
+
+std::uint64_t LatencyHistogram::getBucketLimit(size_t bucket)
+{
+  std::uint64_t sub_buckets = std::uint64_t(1) << SUB_BUCKET_BITS;
+  if (bucket < sub_buckets) { return bucket; }
+
+  // Buckets past the first few each cover a slice of a power of two
+  size_t shift = bucket / sub_buckets - 1;
+  std::uint64_t offset = bucket % sub_buckets + sub_buckets;
+
+  return ((offset + 1) << shift) - 1;
+}
+
+
+void LatencyHistogram::record(std::uint64_t ns)
+{
+  buckets_[getBucket(ns)].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_.fetch_add(ns, std::memory_order_relaxed);
+
+  std::uint64_t longest = max_.load(std::memory_order_relaxed);
+  while (ns > longest && !max_.compare_exchange_weak(longest, ns)) { }
+}
+
+
+void LatencyHistogram::clear()
+{
+  for (std::atomic<std::uint64_t>& bucket : buckets_)
+  {
+    bucket.store(0);
+  }
+  count_ = 0;
+  sum_ = 0;
+  max_ = 0;
+}
+
+
+size_t LatencyHistogram::getBucket(std::uint64_t ns)
+{
+  std::uint64_t sub_buckets = std::uint64_t(1) << SUB_BUCKET_BITS;
+  if (ns < sub_buckets) { return static_cast<size_t> (ns); }
+
+  // How far the highest bit is above the sub-bucket bits, and the bits
+  // right below it
+  size_t shift = 0;
+  while ((ns >> shift) >= 2 * sub_buckets) { ++shift; }
+  size_t bucket = (shift + 1) * sub_buckets + ((ns >> shift) - sub_buckets);
+
+  return std::min(bucket, NUM_BUCKETS - 1);
+}
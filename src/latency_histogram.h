@@ -0,0 +1,138 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Counts how long something took, in buckets that get wider as durations get
+ * longer, so every duration from a nanosecond to minutes is kept to within a
+ * few percent in a fixed amount of memory. Recording never locks or
+ * allocates, and one thread may record while others read.
+ */
+class LatencyHistogram
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    std::uint64_t getCount() const { return count_.load(); }
+    std::uint64_t getMax() const { return max_.load(); }
+
+    /**
+     * Returns the average duration.
+     *
+     * @returns {double} The average, in nanoseconds, or 0 if nothing has been
+     * recorded.
+     */
+    double getMean() const;
+
+    /**
+     * Finds the duration that a share of the recorded durations were no longer
+     * than.
+     *
+     * @param {double} fraction The share, such as 0.99 for the 99th
+     * percentile.
+     * @returns {std::uint64_t} The duration, in nanoseconds, rounded up to the
+     * end of its bucket, or 0 if nothing has been recorded.
+     */
+    std::uint64_t getPercentile(double fraction) const;
+
+    /**
+     * Returns how many buckets there are, and how many durations fell into
+     * one, such as for saving the whole histogram.
+     *
+     * @param {size_t} bucket The bucket.
+     * @returns {size_t|std::uint64_t} The number of buckets, or the number of
+     * durations in the bucket.
+     */
+    static size_t getNumBuckets() { return NUM_BUCKETS; }
+    std::uint64_t getBucketCount(size_t bucket) const
+    {
+      return buckets_[bucket].load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns the longest duration that falls into a bucket.
+     *
+     * @param {size_t} bucket The bucket.
+     * @returns {std::uint64_t} The duration, in nanoseconds.
+     */
+    static std::uint64_t getBucketLimit(size_t bucket);
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Counts one duration.
+     *
+     * @param {std::uint64_t} ns How long it took, in nanoseconds.
+     */
+    void record(std::uint64_t ns);
+
+    /**
+     * Forgets every duration.
+     */
+    void clear();
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Finds the bucket a duration falls into.
+     *
+     * @param {std::uint64_t} ns The duration, in nanoseconds.
+     * @returns {size_t} The bucket.
+     */
+    static size_t getBucket(std::uint64_t ns);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    // Each doubling of the duration is split into 2^SUB_BUCKET_BITS buckets,
+    // so a bucket is at most 1/16th wider than the durations in it
+    static const size_t SUB_BUCKET_BITS = 4;
+
+    // Up to 2^40 ns, or about 18 minutes; anything longer goes in the last
+    static const size_t MAX_BITS = 40;
+
+    static const size_t NUM_BUCKETS =
+      (MAX_BITS - SUB_BUCKET_BITS + 1) << SUB_BUCKET_BITS;
+
+    std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> buckets_;
+    std::atomic<std::uint64_t> count_, sum_, max_;
+
+};
+
+#endif
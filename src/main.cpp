@@ -1,29 +1,530 @@
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "board.h"
+#include "curses_display.h"
 #include "dicefeud.h"
+#include "fair_start.h"
+#include "headless_display.h"
+#include "map_pack.h"
+#include "perf_stats.h"
+#include "recording_display.h"
+#include "replay_reader.h"
+#include "replay_writer.h"
+#include "rules.h"
+#include "snapshot.h"
+#include "trace.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * How new games are set up.
+ */
+struct GameSettings
+{
+  size_t num_players;
+  size_t width, height;
+
+  // About how many tiles generated boards are divided into
+  size_t num_tiles;
+
+  bool has_human;
+  size_t max_turns;
+
+  // How boards are generated when they are not taken from a pack
+  Board::Generator generator;
+
+  // Boards generated ahead of time, or nullptr to generate them live
+  const MapPack* maps;
+
+  // The map in the pack to play on, or -1 to pick one by the game's seed
+  long map_index;
+
+  // Deals out a fair start, or nullptr to keep the first one dealt
+  const FairStart* fair_start;
+};
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Plays a game, recording it to a replay if a path is given. Each game gets
+ * its own seed. Boards are taken from a map pack if there is one, and are
+ * otherwise generated from the game's seed; either way, the replay records
+ * the seed that generates the board.
+ *
+ * @param {std::mt19937&} rng Provides the seed for the game.
+ * @param {Display&} d The display to show the game on.
+ * @param {GameSettings} settings How to set up the game.
+ * @param {std::string} replay_path Where to save the replay, or empty.
+ * @param {std::string} save_path Where to save the game if it is stopped.
+ * @returns {bool} True if the user wishes to keep playing.
+ */
+bool play_game(
+  std::mt19937& rng
+  , Display& d
+  , const GameSettings& settings
+  , const std::string& replay_path
+  , const std::string& save_path);
+
+/**
+ * Carries on with a saved game.
+ *
+ * @param {Display&} d The display to show the game on.
+ * @param {Snapshot} snapshot The saved game.
+ * @param {std::string} save_path Where to save the game if it is stopped.
+ * @param {size_t} max_turns The turn to stop at, or 0 for no limit.
+ * @returns {bool} True if the user wishes to keep playing.
+ */
+bool resume_game(
+  Display& d
+  , const Snapshot& snapshot
+  , const std::string& save_path
+  , size_t max_turns);
+
+/**
+ * Shows a replay from the given turn to the end.
+ *
+ * @param {Display&} d The display to show the replay on.
+ * @param {ReplayReader&} replay The replay.
+ * @param {size_t} from_turn The turn to start at.
+ */
+void watch_replay(Display& d, ReplayReader& replay, size_t from_turn);
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
 
 int main(int argc, char** argv)
 {
   std::random_device randomDevice;
-  std::mt19937 rng(randomDevice());
+  std::mt19937::result_type seed = randomDevice();
+
+  // Counting the user, when they play. Games of more than the classic number
+  // of players get more tiles, so that everybody has a few to start with.
+  size_t num_players = ClassicRules::MAX_NUM_PLAYERS;
+  const size_t TILES_PER_PLAYER = 3;
+
+  // The board may be larger than the terminal, since it is shown through a
+  // scrollable viewport.
+  size_t width = Display::MINIMUM_WIDTH;
+  size_t height = Display::MINIMUM_HEIGHT - 1;
 
-  const size_t NUM_PLAYERS = 8;
-  Display d (80, 23);
+  // Recording or running headless plays the given number of games between AI
+  // players only, instead of one game after another with the user.
+  std::string record_path;
+  std::string replay_path, watch_path;
+  std::string save_path, resume_path;
+  std::string maps_path = "dicefeud.maps";
+  std::string perf_path, trace_path;
+  long map_index = -1;
+  size_t fair_rollouts = 0;
+  double fair_tolerance = 0.1;
+  bool has_dimensions = false;
+  bool has_maps_path = false;
+  Board::Generator generator = Board::Generator::RANDOM_WALK;
+  bool has_generator = false;
+  size_t from_turn = 0;
+  bool headless = false;
+  size_t num_games = 1;
+  size_t max_turns = 5000;
 
   try
   {
-    bool done = false;
-
-    while (!done)
+    std::vector<std::string> dimensions;
+    for (int i = 1; i < argc; ++i)
     {
-      DiceFeud game(rng, d, NUM_PLAYERS);
+      bool has_value = i + 1 < argc;
+
+      if (std::strcmp(argv[i], "--record") == 0 && has_value) {
+        record_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--replay") == 0 && has_value) {
+        replay_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--watch") == 0 && has_value) {
+        watch_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--from") == 0 && has_value) {
+        from_turn = std::stoul(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--save") == 0 && has_value) {
+        save_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--resume") == 0 && has_value) {
+        resume_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--maps") == 0 && has_value) {
+        maps_path = argv[++i];
+        has_maps_path = true;
+      }
+      else if (std::strcmp(argv[i], "--map") == 0 && has_value) {
+        map_index = std::stol(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--generator") == 0 && has_value) {
+        generator = Board::parseGenerator(argv[++i]);
+        has_generator = true;
+      }
+      else if (std::strcmp(argv[i], "--fair") == 0 && has_value) {
+        fair_rollouts = std::stoul(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--fair-tolerance") == 0 && has_value) {
+        fair_tolerance = std::stod(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--headless") == 0) {
+        headless = true;
+      }
+      else if (std::strcmp(argv[i], "--games") == 0 && has_value) {
+        num_games = std::stoul(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--turns") == 0 && has_value) {
+        max_turns = std::stoul(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--players") == 0 && has_value) {
+        num_players = std::stoul(argv[++i]);
+        if (num_players < 2 || num_players > GameRules::MAX_NUM_PLAYERS) {
+          throw std::out_of_range("Unsupported number of players.");
+        }
+      }
+      else if (std::strcmp(argv[i], "--seed") == 0 && has_value) {
+        seed = std::stoul(argv[++i]);
+      }
+      else if (std::strcmp(argv[i], "--perf") == 0 && has_value) {
+        perf_path = argv[++i];
+      }
+      else if (std::strcmp(argv[i], "--trace") == 0 && has_value) {
+        trace_path = argv[++i];
+      }
+      else {
+        dimensions.push_back(argv[i]);
+      }
+    }
+
+    if (dimensions.size() == 2) {
+      width = std::stoul(dimensions[0]);
+      height = std::stoul(dimensions[1]);
+      has_dimensions = true;
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Usage: " << argv[0] << " [width height] [--record FILE]"
+      << " [--headless] [--games N] [--turns N] [--players N] [--seed N]"
+      << " [--replay FILE] [--watch FILE [--from TURN]]"
+      << " [--save FILE] [--resume FILE] [--maps FILE] [--map N]"
+      << " [--generator walk|voronoi] [--fair ROLLOUTS [--fair-tolerance T]]"
+      << " [--perf FILE] [--trace FILE]" << std::endl;
+    return 1;
+  }
+
+  if (!trace_path.empty()) {
+    if (!Trace::isCompiledIn()) {
+      std::cout << "Tracing was not compiled in; build with"
+        << " -DDICEFEUD_TRACING=ON to use --trace" << std::endl;
+      return 1;
+    }
+
+    Trace::get().enable();
+    Trace::get().nameThread("game");
+  }
+
+  std::mt19937 rng(seed);
+  bool interactive = record_path.empty() && !headless;
+
+  // The user can always quit and come back later. Batch games are only saved
+  // when asked to, if they reach the turn limit.
+  if (interactive && save_path.empty()) {
+    save_path = "dicefeud.sav";
+  }
+
+  try
+  {
+    // A replay knows the size of its own board
+    std::unique_ptr<ReplayReader> watching;
+    if (!watch_path.empty()) {
+      watching.reset(new ReplayReader(watch_path));
+      width = watching->getWidth();
+      height = watching->getHeight();
+    }
+
+    // So does a saved game
+    std::unique_ptr<Snapshot> resuming;
+    if (!resume_path.empty()) {
+      resuming.reset(new Snapshot(resume_path));
+      width = resuming->getWidth();
+      height = resuming->getHeight();
+      has_dimensions = true;
+    }
+
+    // New games use a map pack if there is one for the right size and kind
+    // of board. A pack that was only found lying around is skipped when it
+    // cannot be read, but one the user named has to load.
+    std::unique_ptr<MapPack> maps;
+    if (!watching && std::ifstream(maps_path).good()) {
+      try
+      {
+        maps.reset(new MapPack(maps_path));
+      }
+      catch (const std::runtime_error& ex)
+      {
+        if (has_maps_path) {
+          throw;
+        }
+        std::cout << "Ignoring " << maps_path << ": " << ex.what()
+          << std::endl;
+      }
+    }
+
+    if (maps) {
+      if (!has_dimensions) {
+        width = maps->getWidth();
+        height = maps->getHeight();
+      }
+      else if (maps->getWidth() != width || maps->getHeight() != height) {
+        maps.reset();
+      }
+
+      if (maps && !has_generator) {
+        generator = maps->getGenerator();
+      }
+      else if (maps && maps->getGenerator() != generator) {
+        maps.reset();
+      }
+
+      // Packs are divided into the usual number of tiles, which is too few
+      // for a game of many players
+      if (TILES_PER_PLAYER * num_players > Board::DEFAULT_NUM_TILES) {
+        maps.reset();
+      }
+    }
+
+    // Starts are only checked for fairness when asked to
+    std::unique_ptr<FairStart> fair_start;
+    if (fair_rollouts > 0) {
+      fair_start.reset(new FairStart(
+        fair_rollouts
+        , fair_tolerance
+        , std::max(std::thread::hardware_concurrency(), 1u)));
+    }
+
+    GameSettings settings;
+    settings.num_players = interactive ? num_players - 1 : num_players;
+    settings.width = width;
+    settings.height = height;
+    settings.num_tiles = std::max(
+      Board::DEFAULT_NUM_TILES
+      , TILES_PER_PLAYER * num_players);
+    settings.has_human = interactive;
+    settings.max_turns = interactive ? 0 : max_turns;
+    settings.generator = generator;
+    settings.maps = maps.get();
+    settings.map_index = map_index;
+    settings.fair_start = fair_start.get();
 
-      done = game.play(rng) == false;
+    std::unique_ptr<Display> d;
+    if (!record_path.empty()) {
+      d.reset(new RecordingDisplay(record_path, width, height));
+    }
+    else if (headless) {
+      d.reset(new HeadlessDisplay(width, height));
+    }
+    else {
+      d.reset(new CursesDisplay(width, height));
+    }
+
+    if (watching) {
+      watch_replay(*d, *watching, from_turn);
+    }
+    else if (resuming && !interactive) {
+      resume_game(
+        *d, *resuming, save_path, resuming->getTurn() + max_turns);
+    }
+    else if (interactive) {
+      bool done = resuming && !resume_game(*d, *resuming, save_path, 0);
+
+      for (size_t i = 0; !done; ++i)
+      {
+        std::string path = replay_path.empty()
+          ? replay_path
+          : replay_path + "." + std::to_string(i);
+
+        done = play_game(rng, *d, settings, path, save_path) == false;
+      }
+    }
+    else {
+      for (size_t i = 0; i < num_games; ++i)
+      {
+        std::string path = (replay_path.empty() || num_games == 1)
+          ? replay_path
+          : replay_path + "." + std::to_string(i);
+
+        std::string game_save_path = (save_path.empty() || num_games == 1)
+          ? save_path
+          : save_path + "." + std::to_string(i);
+
+        play_game(rng, *d, settings, path, game_save_path);
+      }
     }
   }
   catch (const std::exception& ex)
   {
     std::cout << "Error in program: " << ex.what() << std::endl;
   }
+
+  // Once the display is gone, so nothing else is being timed
+  if (!perf_path.empty()) {
+    std::ofstream perf (perf_path);
+    PerfStats::get().writeJson(perf);
+    if (!perf) {
+      std::cout << "Could not write timings to " << perf_path << std::endl;
+      return 1;
+    }
+  }
+
+  if (!trace_path.empty()) {
+    std::ofstream trace (trace_path);
+    Trace::get().writeJson(trace);
+    if (!trace) {
+      std::cout << "Could not write the trace to " << trace_path << std::endl;
+      return 1;
+    }
+  }
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+bool play_game(
+  std::mt19937& rng
+  , Display& d
+  , const GameSettings& settings
+  , const std::string& replay_path
+  , const std::string& save_path)
+{
+  std::mt19937::result_type game_seed = rng();
+  std::mt19937 game_rng(game_seed);
+  std::uint64_t map_seed = game_seed;
+
+  std::unique_ptr<Board> board;
+  if (settings.maps) {
+    size_t index = settings.map_index >= 0
+      ? static_cast<size_t> (settings.map_index)
+      : settings.maps->getIndexForSeed(game_seed);
+    map_seed = settings.maps->getSeed(index);
+
+    board.reset(new Board(
+      d
+      , settings.maps->getGrid(index)
+      , settings.maps->getInitialStates(index)
+      , settings.maps->getAdjacency(index)));
+  }
+  else {
+    board.reset(new Board(
+      game_rng
+      , d
+      , settings.width
+      , settings.height
+      , settings.generator
+      , settings.num_tiles));
+  }
+
+  std::unique_ptr<DiceFeud> game (new DiceFeud(
+    game_rng
+    , d
+    , std::move(*board)
+    , settings.num_players
+    , settings.has_human));
+
+  if (settings.fair_start) {
+    game->balanceStart(game_rng, *settings.fair_start);
+  }
+
+  game->setTurnLimit(settings.max_turns);
+  game->setSavePath(save_path);
+
+  std::unique_ptr<ReplayWriter> replay;
+  if (!replay_path.empty()) {
+    replay.reset(new ReplayWriter(
+      replay_path
+      , map_seed
+      , settings.generator
+      , settings.width
+      , settings.height
+      , settings.num_tiles));
+    game->setReplay(replay.get());
+  }
+
+  return game->play(game_rng);
 }
 
+
+bool resume_game(
+  Display& d
+  , const Snapshot& snapshot
+  , const std::string& save_path
+  , size_t max_turns)
+{
+  std::mt19937 game_rng;
+  snapshot.loadRng(game_rng);
+
+  DiceFeud game(d, snapshot);
+  game.setTurnLimit(max_turns);
+  game.setSavePath(save_path);
+
+  return game.play(game_rng);
+}
+
+
+void watch_replay(Display& d, ReplayReader& replay, size_t from_turn)
+{
+  // The board is the same one the game generated from its seed
+  std::mt19937 map_rng(static_cast<std::mt19937::result_type> (
+    replay.getSeed()));
+  Board board (
+    map_rng
+    , d
+    , replay.getWidth()
+    , replay.getHeight()
+    , replay.getGenerator()
+    , replay.getTargetNumTiles());
+
+  std::vector<TileState> states;
+  replay.seek(std::min(from_turn, replay.getNumTurns()), states);
+  board.setTileStates(states);
+  board.draw();
+
+  ReplayReader::Event event;
+  while (replay.next(event))
+  {
+    if (event.type == ReplayReader::Event::Type::FIGHT) {
+      board.resolveFight(
+        event.attacker_id
+        , event.defender_id
+        , event.attacker_total
+        , event.defender_total);
+    }
+    else if (event.type == ReplayReader::Event::Type::REINFORCE) {
+      board.addDice(event.tile_id, event.num_dice);
+    }
+    else {
+      board.draw();
+    }
+  }
+
+  d.printMessage("End of replay");
+  d.pause(2000);
+}
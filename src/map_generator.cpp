@@ -0,0 +1,211 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include "map_generator.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+// Enough that threads rarely wait on each other at the end of a round
+const size_t MapGenerator::BOARDS_PER_THREAD = 32;
+
+// Rounds in a row without a board worth keeping before giving up
+const size_t MapGenerator::MAX_EMPTY_ROUNDS = 16;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+MapGenerator::MapGenerator(size_t width, size_t height, size_t num_threads)
+  : width_(width)
+  , height_(height)
+  , stats_(std::max<size_t>(num_threads, 1))
+{
+  for (size_t i = 0; i < stats_.size(); ++i)
+  {
+    displays_.emplace_back(new HeadlessDisplay(width, height));
+  }
+}
+
+
+void MapGenerator::generate(
+  std::uint64_t seed
+  , size_t count
+  , const accept_t& accept)
+{
+  std::vector<std::unique_ptr<Board>> boards (
+    displays_.size() * BOARDS_PER_THREAD);
+
+  size_t num_accepted = 0;
+  size_t num_empty_rounds = 0;
+  while (num_accepted < count)
+  {
+    if (num_empty_rounds == MAX_EMPTY_ROUNDS) {
+      throw std::runtime_error("Too few boards meet the criteria.");
+    }
+
+    std::uint64_t first = next_candidate_;
+    size_t num_accepted_before = num_accepted;
+    generateRound(seed, first, boards);
+
+    // Go through the round in order, so the threads cannot change the result
+    for (size_t i = 0; i < boards.size() && num_accepted < count; ++i)
+    {
+      ++next_candidate_;
+
+      const Board& board = *boards[i];
+      if (!meetsCriteria(board)) {
+        ++num_rejected_;
+        continue;
+      }
+      if (!layouts_.insert(hashLayout(board.getGrid())).second) {
+        ++num_duplicates_;
+        continue;
+      }
+
+      accept(getMapSeed(seed, first + i), board);
+      ++num_accepted;
+    }
+
+    num_empty_rounds = num_accepted == num_accepted_before
+      ? num_empty_rounds + 1
+      : 0;
+  }
+}
+
+
+std::uint32_t MapGenerator::getMapSeed(std::uint64_t seed, std::uint64_t index)
+{
+  // SplitMix64, so neighboring candidates get unrelated seeds
+  std::uint64_t z = seed + (index + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  z ^= z >> 31;
+
+  return static_cast<std::uint32_t> (z);
+}
+
+
+std::uint64_t MapGenerator::hashLayout(const TileGrid& grid)
+{
+  // FNV-1a over every space
+  std::uint64_t hash = 0xCBF29CE484222325ull;
+  const TileGrid::tile_id_t* cells = grid.getCells();
+  size_t num_spaces = grid.getWidth() * grid.getHeight();
+
+  for (size_t i = 0; i < num_spaces; ++i)
+  {
+    hash = (hash ^ (cells[i] & 0xFF)) * 0x100000001B3ull;
+    hash = (hash ^ (cells[i] >> 8)) * 0x100000001B3ull;
+  }
+
+  return hash;
+}
+
+
+bool MapGenerator::isConnected(const Adjacency& adjacency)
+{
+  size_t num_tiles = adjacency.getNumTiles();
+  if (num_tiles == 0) { return true; }
+
+  std::vector<bool> seen (num_tiles, false);
+  std::vector<size_t> open (1, 0);
+  seen[0] = true;
+  size_t num_seen = 1;
+
+  while (!open.empty())
+  {
+    size_t id = open.back();
+    open.pop_back();
+
+    const Adjacency::tile_id_t* neighbors = adjacency.getNeighbors(id);
+    for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+    {
+      if (seen[neighbors[i]]) { continue; }
+
+      seen[neighbors[i]] = true;
+      ++num_seen;
+      open.push_back(neighbors[i]);
+    }
+  }
+
+  return num_seen == num_tiles;
+}
+
+
+void MapGenerator::generateRound(
+  std::uint64_t seed
+  , std::uint64_t first
+  , std::vector<std::unique_ptr<Board>>& boards)
+{
+  std::atomic<size_t> next (0);
+  std::vector<std::exception_ptr> errors (displays_.size());
+
+  auto work = [&](size_t thread)
+  {
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    size_t num_generated = 0;
+
+    try
+    {
+      for (size_t i = next++; i < boards.size(); i = next++)
+      {
+        std::mt19937 rng(getMapSeed(seed, first + i));
+        boards[i].reset(new Board(
+          rng, *displays_[thread], width_, height_, generator_));
+        ++num_generated;
+      }
+    }
+    catch (...)
+    {
+      errors[thread] = std::current_exception();
+      next = boards.size();
+    }
+
+    std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+    stats_[thread].num_generated += num_generated;
+    stats_[thread].seconds += elapsed.count();
+  };
+
+  // This thread does its share too
+  std::vector<std::thread> threads;
+  for (size_t thread = 1; thread < displays_.size(); ++thread)
+  {
+    threads.emplace_back(work, thread);
+  }
+  work(0);
+
+  for (std::thread& thread : threads)
+  {
+    thread.join();
+  }
+
+  for (const std::exception_ptr& error : errors)
+  {
+    if (error) { std::rethrow_exception(error); }
+  }
+}
+
+
+bool MapGenerator::meetsCriteria(const Board& board) const
+{
+  const Adjacency& adjacency = board.getAdjacency();
+
+  return adjacency.getNumTiles() >= criteria_.min_tiles
+    && adjacency.getNumTiles() <= criteria_.max_tiles
+    && (!criteria_.connected || isConnected(adjacency));
+}
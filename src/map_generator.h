@@ -0,0 +1,186 @@
+#ifndef MAP_GENERATOR_H
+#define MAP_GENERATOR_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+#include "adjacency.h"
+#include "board.h"
+#include "headless_display.h"
+#include "tile_grid.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Generates boards in bulk on every core, such as for filling a map pack.
+ * Every candidate board gets its own seed, worked out from the batch seed and
+ * its position in the batch, so the boards that come out are the same no
+ * matter how many threads made them. Boards that do not meet the criteria,
+ * or that have the same layout as one already accepted, are skipped.
+ */
+class MapGenerator
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * Told about every accepted board, in order, with the seed that
+     * generates it.
+     */
+    using accept_t = std::function<void(std::uint64_t, const Board&)>;
+
+    /**
+     * What a board needs to be accepted.
+     */
+    struct Criteria
+    {
+      size_t min_tiles = 0;
+      size_t max_tiles = std::numeric_limits<size_t>::max();
+
+      // Whether every tile must be reachable from every other tile
+      bool connected = false;
+    };
+
+    /**
+     * How much work one thread has done.
+     */
+    struct ThreadStats
+    {
+      size_t num_generated = 0;
+      double seconds = 0;
+    };
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {size_t} width The width of every board.
+     * @param {size_t} height The height of every board.
+     * @param {size_t} num_threads How many boards to generate at once.
+     */
+    MapGenerator(size_t width, size_t height, size_t num_threads);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    const std::vector<ThreadStats>& getThreadStats() const { return stats_; }
+    size_t getNumDuplicates() const { return num_duplicates_; }
+    size_t getNumRejected() const { return num_rejected_; }
+
+
+    /*** SETTERS ***/
+
+    void setCriteria(const Criteria& criteria) { criteria_ = criteria; }
+    void setGenerator(Board::Generator generator) { generator_ = generator; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Generates boards until enough of them have been accepted. Boards are
+     * accepted in the order of their candidates, and never twice over calls.
+     * Throws if too few boards meet the criteria to get anywhere.
+     *
+     * @param {std::uint64_t} seed Decides every board in the batch.
+     * @param {size_t} count How many boards to accept.
+     * @param {accept_t} accept Given each accepted board.
+     */
+    void generate(std::uint64_t seed, size_t count, const accept_t& accept);
+
+    /**
+     * Works out the seed of one candidate board in a batch.
+     *
+     * @param {std::uint64_t} seed The batch seed.
+     * @param {std::uint64_t} index The candidate's place in the batch.
+     * @returns {std::uint32_t} The seed to generate the board from.
+     */
+    static std::uint32_t getMapSeed(std::uint64_t seed, std::uint64_t index);
+
+    /**
+     * Hashes the layout of a board, ignoring its dice.
+     *
+     * @param {TileGrid} grid Which tile is where.
+     * @returns {std::uint64_t} The hash.
+     */
+    static std::uint64_t hashLayout(const TileGrid& grid);
+
+    /**
+     * Checks if every tile can be reached from every other tile.
+     *
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @returns {bool} True if the tiles form a single region.
+     */
+    static bool isConnected(const Adjacency& adjacency);
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Generates one round of candidates, a thread per display.
+     *
+     * @param {std::uint64_t} seed The batch seed.
+     * @param {std::uint64_t} first The index of the first candidate.
+     * @param {std::vector<std::unique_ptr<Board>>&} boards Filled with the
+     * candidates, in order.
+     */
+    void generateRound(
+      std::uint64_t seed
+      , std::uint64_t first
+      , std::vector<std::unique_ptr<Board>>& boards);
+
+    /**
+     * Checks a board against the criteria.
+     *
+     * @param {Board} board The board.
+     * @returns {bool} True if it meets them.
+     */
+    bool meetsCriteria(const Board& board) const;
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const size_t BOARDS_PER_THREAD;
+    static const size_t MAX_EMPTY_ROUNDS;
+
+    size_t width_, height_;
+    Criteria criteria_;
+    Board::Generator generator_ = Board::Generator::RANDOM_WALK;
+
+    // Each thread needs its own, since boards show themselves as they are made
+    std::vector<std::unique_ptr<HeadlessDisplay>> displays_;
+
+    std::vector<ThreadStats> stats_;
+    std::unordered_set<std::uint64_t> layouts_;
+    std::uint64_t next_candidate_ = 0;
+    size_t num_duplicates_ = 0;
+    size_t num_rejected_ = 0;
+
+};
+
+#endif
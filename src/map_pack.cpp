@@ -0,0 +1,201 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "map_pack.h"
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Rounds a file offset up to the next 8-byte boundary.
+ *
+ * @param {std::uint64_t} offset The offset.
+ * @returns {std::uint64_t} The aligned offset.
+ */
+inline std::uint64_t align_offset(std::uint64_t offset);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const char MapPack::MAGIC[8] = { 'D', 'F', 'M', 'A', 'P', 'S', 0, 0 };
+const std::uint32_t MapPack::VERSION = 4;
+const std::uint32_t MapPack::BYTE_ORDER_MARK = 0x01020304;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+MapPack::MapPack(const std::string& path)
+  : file_(std::make_shared<MappedFile>(path))
+{
+  const unsigned char* data = file_->getData();
+  std::uint64_t size = file_->getSize();
+
+  if (size < sizeof(MapPackHeader)
+      || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Not a map pack.");
+  }
+
+  header_ = reinterpret_cast<const MapPackHeader*> (data);
+
+  if (header_->version != VERSION) {
+    throw std::runtime_error("Map pack is from another version.");
+  }
+  if (header_->byte_order != BYTE_ORDER_MARK) {
+    throw std::runtime_error("Map pack is from an incompatible machine.");
+  }
+
+  std::uint64_t index_size = header_->num_maps * sizeof(MapPackEntry);
+  bool valid = header_->file_size == size
+    && header_->num_maps > 0
+    && header_->generator
+      <= static_cast<std::uint32_t> (Board::Generator::VORONOI)
+    && header_->index_offset % 8 == 0
+    && header_->index_offset <= size
+    && index_size / sizeof(MapPackEntry) == header_->num_maps
+    && index_size <= size - header_->index_offset;
+
+  if (!valid) {
+    throw std::runtime_error("Map pack is damaged.");
+  }
+
+  index_ = reinterpret_cast<const MapPackEntry*> (
+    data + header_->index_offset);
+}
+
+
+std::shared_ptr<const TileGrid> MapPack::getGrid(size_t index) const
+{
+  const MapPackEntry& entry = getEntry(index);
+
+  std::uint64_t sections[NUM_SECTIONS];
+  getSections(
+    entry.offset
+    , header_->width
+    , header_->height
+    , entry.num_tiles
+    , entry.num_neighbors
+    , sections);
+
+  return std::make_shared<TileGrid>(
+    header_->width
+    , header_->height
+    , reinterpret_cast<const TileGrid::tile_id_t*> (
+      file_->getData() + sections[0])
+    , file_);
+}
+
+
+Adjacency MapPack::getAdjacency(size_t index) const
+{
+  const MapPackEntry& entry = getEntry(index);
+
+  std::uint64_t sections[NUM_SECTIONS];
+  getSections(
+    entry.offset
+    , header_->width
+    , header_->height
+    , entry.num_tiles
+    , entry.num_neighbors
+    , sections);
+
+  Adjacency adjacency (
+    entry.num_tiles
+    , reinterpret_cast<const std::uint32_t*> (file_->getData() + sections[1])
+    , reinterpret_cast<const Adjacency::tile_id_t*> (
+      file_->getData() + sections[2])
+    , file_);
+
+  if (!adjacency.isValid(entry.num_neighbors)) {
+    throw std::runtime_error("Map pack is damaged.");
+  }
+
+  return adjacency;
+}
+
+
+std::vector<TileState> MapPack::getInitialStates(size_t index) const
+{
+  const MapPackEntry& entry = getEntry(index);
+
+  std::uint64_t sections[NUM_SECTIONS];
+  getSections(
+    entry.offset
+    , header_->width
+    , header_->height
+    , entry.num_tiles
+    , entry.num_neighbors
+    , sections);
+
+  const unsigned char* dice = file_->getData() + sections[3];
+
+  std::vector<TileState> states (entry.num_tiles);
+  for (size_t id = 0; id < states.size(); ++id)
+  {
+    states[id].owner = Tile::NO_OWNER;
+    states[id].num_dice = dice[id];
+  }
+
+  return states;
+}
+
+
+void MapPack::getSections(
+  std::uint64_t offset
+  , size_t width
+  , size_t height
+  , size_t num_tiles
+  , size_t num_neighbors
+  , std::uint64_t* starts)
+{
+  starts[0] = offset;
+  starts[1] = align_offset(
+    starts[0] + width * height * sizeof(TileGrid::tile_id_t));
+  starts[2] = align_offset(starts[1] + (num_tiles + 1) * sizeof(std::uint32_t));
+  starts[3] = align_offset(
+    starts[2] + num_neighbors * sizeof(Adjacency::tile_id_t));
+  starts[4] = starts[3] + num_tiles;
+}
+
+
+const MapPackEntry& MapPack::getEntry(size_t index) const
+{
+  if (index >= header_->num_maps) {
+    throw std::out_of_range("No map with the given index exists.");
+  }
+
+  // Only check the map that is actually used, so opening a pack stays cheap
+  const MapPackEntry& entry = index_[index];
+  std::uint64_t sections[NUM_SECTIONS];
+  getSections(
+    entry.offset
+    , header_->width
+    , header_->height
+    , entry.num_tiles
+    , entry.num_neighbors
+    , sections);
+
+  if (entry.offset % 8 != 0
+      || entry.num_tiles == 0
+      || entry.num_tiles >= TileGrid::NO_TILE
+      || sections[4] < entry.offset
+      || sections[4] > header_->index_offset) {
+    throw std::runtime_error("Map pack is damaged.");
+  }
+
+  return entry;
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+inline std::uint64_t align_offset(std::uint64_t offset)
+{
+  return (offset + 7) & ~static_cast<std::uint64_t> (7);
+}
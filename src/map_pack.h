@@ -0,0 +1,207 @@
+#ifndef MAP_PACK_H
+#define MAP_PACK_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "adjacency.h"
+#include "board.h"
+#include "frame.h"
+#include "mapped_file.h"
+#include "tile_grid.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * The start of a map pack file, followed by the maps and then the index.
+ */
+struct MapPackHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t file_size;
+
+  // Every map in a pack is the same size, and made by the same generator
+  std::uint32_t width, height;
+  std::uint32_t generator;
+  std::uint32_t padding;
+
+  std::uint64_t num_maps;
+  std::uint64_t index_offset;
+};
+
+/**
+ * Where to find one map in a pack. The map starts on an 8-byte boundary with
+ * its grid (width * height tile ids), followed by where each tile's neighbors
+ * start (num_tiles + 1 numbers), every tile's neighbors (num_neighbors tile
+ * ids) and the starting dice of every tile (a byte each). The first three
+ * each start on an 8-byte boundary.
+ */
+struct MapPackEntry
+{
+  std::uint64_t seed;
+  std::uint64_t offset;
+  std::uint32_t num_tiles;
+  std::uint32_t num_neighbors;
+};
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * A library of boards generated ahead of time, so that starting a game does
+ * not have to generate one. The pack is mapped into memory, and any map in it
+ * is found in constant time and used without being copied. Every map comes
+ * with the seed it was generated from, which regenerates exactly the same
+ * board, so games on packed maps can still be replayed without the pack.
+ */
+class MapPack
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * Opens a map pack.
+     *
+     * @param {std::string} path The pack file.
+     */
+    explicit MapPack(const std::string& path);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    size_t getNumMaps() const { return header_->num_maps; }
+    size_t getWidth() const { return header_->width; }
+    size_t getHeight() const { return header_->height; }
+
+    Board::Generator getGenerator() const
+    {
+      return static_cast<Board::Generator> (header_->generator);
+    }
+
+    /**
+     * Picks a map for a game seed, so that the same seed always gets the same
+     * map.
+     *
+     * @param {std::uint64_t} seed The seed.
+     * @returns {size_t} The index of the map.
+     */
+    size_t getIndexForSeed(std::uint64_t seed) const
+    {
+      return seed % header_->num_maps;
+    }
+
+    /**
+     * Returns the seed a map was generated from.
+     *
+     * @param {size_t} index The map.
+     * @returns {std::uint64_t} The seed.
+     */
+    std::uint64_t getSeed(size_t index) const { return getEntry(index).seed; }
+
+    /**
+     * Returns which tile is where on a map. The grid uses the pack directly.
+     *
+     * @param {size_t} index The map.
+     * @returns {std::shared_ptr<const TileGrid>} The grid.
+     */
+    std::shared_ptr<const TileGrid> getGrid(size_t index) const;
+
+    /**
+     * Returns which tiles border each other on a map. The lists are used from
+     * the pack directly.
+     *
+     * @param {size_t} index The map.
+     * @returns {Adjacency} The neighbors of every tile.
+     */
+    Adjacency getAdjacency(size_t index) const;
+
+    /**
+     * Returns how many dice every tile starts with. Tiles do not belong to
+     * anyone yet, so their colors mean nothing.
+     *
+     * @param {size_t} index The map.
+     * @returns {std::vector<TileState>} The state of every tile, by id.
+     */
+    std::vector<TileState> getInitialStates(size_t index) const;
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Finds where each part of a map starts.
+     *
+     * @param {std::uint64_t} offset Where the map starts.
+     * @param {size_t} width The width of the maps.
+     * @param {size_t} height The height of the maps.
+     * @param {size_t} num_tiles How many tiles the map has.
+     * @param {size_t} num_neighbors How many neighbors the map has in total.
+     * @param {std::uint64_t*} starts Where the four offsets (grid, neighbor
+     * starts, neighbors, dice) are stored, followed by where the map ends.
+     */
+    static void getSections(
+      std::uint64_t offset
+      , size_t width
+      , size_t height
+      , size_t num_tiles
+      , size_t num_neighbors
+      , std::uint64_t* starts);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const char MAGIC[8];
+    static const std::uint32_t VERSION;
+    static const std::uint32_t BYTE_ORDER_MARK;
+
+    // How many offsets getSections stores
+    static const size_t NUM_SECTIONS = 5;
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Looks up a map in the index.
+     *
+     * @param {size_t} index The map.
+     * @returns {const MapPackEntry&} Where to find it.
+     */
+    const MapPackEntry& getEntry(size_t index) const;
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    std::shared_ptr<const MappedFile> file_;
+    const MapPackHeader* header_;
+    const MapPackEntry* index_;
+
+};
+
+#endif
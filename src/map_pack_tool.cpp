@@ -0,0 +1,387 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include "adjacency.h"
+#include "board.h"
+#include "display.h"
+#include "fair_start.h"
+#include "frame.h"
+#include "headless_display.h"
+#include "map_generator.h"
+#include "map_pack_writer.h"
+#include "voronoi_generator.h"
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Times every generator on the same seeds, one board at a time, and prints
+ * how long a board takes and what the boards are like.
+ *
+ * @param {size_t} width The width of every board.
+ * @param {size_t} height The height of every board.
+ * @param {size_t} num_boards How many boards each generator makes.
+ * @param {std::uint64_t} seed Decides every board.
+ */
+void compare_generators(
+  size_t width
+  , size_t height
+  , size_t num_boards
+  , std::uint64_t seed);
+
+/**
+ * Divides a board into many small tiles and times walking every tile's
+ * neighbors and playing rollouts with the tiles numbered in different orders:
+ * as generated, shuffled like the random walk leaves them, and along a
+ * Hilbert curve like Board does.
+ *
+ * @param {size_t} width The width of the board.
+ * @param {size_t} height The height of the board.
+ * @param {size_t} num_rollouts How many rollouts to time for each order.
+ * @param {std::uint64_t} seed Decides the board and the rollouts.
+ */
+void compare_orders(
+  size_t width
+  , size_t height
+  , size_t num_rollouts
+  , std::uint64_t seed);
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+/**
+ * Generates boards ahead of time on every core and stores them in a map pack,
+ * so the game can start without generating one. Can also compare how fast the
+ * generators are instead.
+ */
+int main(int argc, char** argv)
+{
+  std::random_device randomDevice;
+  std::mt19937::result_type seed = randomDevice();
+
+  std::string path;
+  size_t num_maps = 256;
+  size_t width = Display::MINIMUM_WIDTH;
+  size_t height = Display::MINIMUM_HEIGHT - 1;
+  size_t num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+  MapGenerator::Criteria criteria;
+  Board::Generator generator = Board::Generator::RANDOM_WALK;
+  size_t num_compared = 0;
+  size_t num_rollouts = 0;
+
+  try
+  {
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+      bool has_value = i + 1 < argc;
+
+      if (std::string(argv[i]) == "--maps" && has_value) {
+        num_maps = std::stoul(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--seed" && has_value) {
+        seed = std::stoul(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--threads" && has_value) {
+        num_threads = std::stoul(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--min-tiles" && has_value) {
+        criteria.min_tiles = std::stoul(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--max-tiles" && has_value) {
+        criteria.max_tiles = std::stoul(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--connected") {
+        criteria.connected = true;
+      }
+      else if (std::string(argv[i]) == "--generator" && has_value) {
+        generator = Board::parseGenerator(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--compare" && has_value) {
+        num_compared = std::stoul(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--locality" && has_value) {
+        num_rollouts = std::stoul(argv[++i]);
+      }
+      else {
+        positional.push_back(argv[i]);
+      }
+    }
+
+    // Comparing generators or orders does not write a pack
+    if (num_compared == 0 && num_rollouts == 0) {
+      if (positional.empty()) {
+        throw std::invalid_argument("No map pack given.");
+      }
+      path = positional[0];
+      positional.erase(std::begin(positional));
+    }
+
+    if (positional.size() == 2) {
+      width = std::stoul(positional[0]);
+      height = std::stoul(positional[1]);
+    }
+    else if (!positional.empty()) {
+      throw std::invalid_argument("Wrong number of arguments.");
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Usage: " << argv[0] << " FILE [width height]"
+      << " [--maps N] [--seed N] [--threads N] [--generator walk|voronoi]"
+      << " [--min-tiles N] [--max-tiles N] [--connected]" << std::endl
+      << "       " << argv[0] << " --compare N [width height] [--seed N]"
+      << std::endl
+      << "       " << argv[0] << " --locality ROLLOUTS [width height]"
+      << " [--seed N]" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    if (num_compared > 0) {
+      compare_generators(width, height, num_compared, seed);
+      return 0;
+    }
+    if (num_rollouts > 0) {
+      compare_orders(width, height, num_rollouts, seed);
+      return 0;
+    }
+
+    MapPackWriter writer (path, width, height, generator);
+    MapGenerator batch (width, height, num_threads);
+    batch.setCriteria(criteria);
+    batch.setGenerator(generator);
+
+    batch.generate(
+      seed
+      , num_maps
+      , [&](std::uint64_t map_seed, const Board& board)
+      {
+        writer.add(map_seed, board);
+      });
+
+    writer.finish();
+
+    // Show how well generation scales over threads
+    const std::vector<MapGenerator::ThreadStats>& stats =
+      batch.getThreadStats();
+    size_t total = 0;
+    double longest = 0;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < stats.size(); ++i)
+    {
+      total += stats[i].num_generated;
+      longest = std::max(longest, stats[i].seconds);
+      std::cout << "Thread " << i << ": " << stats[i].num_generated
+        << " maps, " << stats[i].num_generated / stats[i].seconds
+        << " maps/s" << std::endl;
+    }
+    std::cout << "Generated " << total << " maps, "
+      << total / longest << " maps/s" << std::endl
+      << "Kept " << num_maps << ", skipped "
+      << batch.getNumDuplicates() << " duplicates and "
+      << batch.getNumRejected() << " that did not meet the criteria"
+      << std::endl;
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Error in program: " << ex.what() << std::endl;
+    return 1;
+  }
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+void compare_generators(
+  size_t width
+  , size_t height
+  , size_t num_boards
+  , std::uint64_t seed)
+{
+  HeadlessDisplay d (width, height);
+  const Board::Generator GENERATORS[] = {
+    Board::Generator::RANDOM_WALK
+    , Board::Generator::VORONOI
+  };
+  const char* NAMES[] = { "walk", "voronoi" };
+
+  std::cout << std::fixed << std::setprecision(3);
+  for (size_t g = 0; g < 2; ++g)
+  {
+    double sum = 0, sum_squares = 0, slowest = 0;
+    size_t num_tiles = 0, num_spaces = 0;
+
+    for (size_t i = 0; i < num_boards; ++i)
+    {
+      std::mt19937 rng(MapGenerator::getMapSeed(seed, i));
+
+      std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+      Board board (rng, d, width, height, GENERATORS[g]);
+      std::chrono::duration<double, std::milli> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+      sum += elapsed.count();
+      sum_squares += elapsed.count() * elapsed.count();
+      slowest = std::max(slowest, elapsed.count());
+
+      for (Board::tile_iterator tile = board.getTiles()
+          ; tile != board.getTilesEnd()
+          ; ++tile)
+      {
+        ++num_tiles;
+        num_spaces += tile->getCoordinates().size();
+      }
+    }
+
+    double mean = sum / num_boards;
+    double deviation =
+      std::sqrt(std::max(sum_squares / num_boards - mean * mean, 0.0));
+    std::cout << NAMES[g] << ": " << mean << " ms/board (sd " << deviation
+      << ", max " << slowest << "), "
+      << static_cast<double> (num_tiles) / num_boards << " tiles, "
+      << 100.0 * num_spaces / (num_boards * width * height) << "% covered"
+      << std::endl;
+  }
+}
+
+
+void compare_orders(
+  size_t width
+  , size_t height
+  , size_t num_rollouts
+  , std::uint64_t seed)
+{
+  // Game boards only have a couple dozen tiles, which all fit in the cache
+  // however they are numbered
+  VoronoiGenerator generator (width, height, 16, 24);
+  std::mt19937 rng(seed);
+  std::vector<Adjacency::tile_id_t> cells;
+  std::vector<Adjacency::border_t> borders;
+  size_t num_tiles = generator.generate(rng, cells, borders);
+  Adjacency generated (num_tiles, std::move(borders));
+
+  std::vector<std::pair<double, double>> centroids (num_tiles);
+  std::vector<size_t> sizes (num_tiles, 0);
+  for (size_t space = 0; space < cells.size(); ++space)
+  {
+    if (cells[space] == TileGrid::NO_TILE) { continue; }
+    centroids[cells[space]].first += space % width;
+    centroids[cells[space]].second += space / width;
+    ++sizes[cells[space]];
+  }
+  for (size_t id = 0; id < num_tiles; ++id)
+  {
+    centroids[id].first /= sizes[id];
+    centroids[id].second /= sizes[id];
+  }
+
+  const std::vector<Tile::owner_t> seats = { 0, 1, 2, 3 };
+  std::vector<TileState> states (num_tiles);
+  for (TileState& state : states)
+  {
+    state.owner = seats[rng() % seats.size()];
+    state.num_dice = static_cast<std::uint8_t> (rng() % 8 + 1);
+  }
+
+  std::vector<Adjacency::tile_id_t> as_generated (num_tiles);
+  for (size_t id = 0; id < num_tiles; ++id)
+  {
+    as_generated[id] = static_cast<Adjacency::tile_id_t> (id);
+  }
+  std::vector<Adjacency::tile_id_t> shuffled = as_generated;
+  std::shuffle(std::begin(shuffled), std::end(shuffled), rng);
+
+  const std::vector<Adjacency::tile_id_t> ORDERS[] = {
+    as_generated
+    , shuffled
+    , Board::orderAlongCurve(width, height, centroids)
+  };
+  const char* NAMES[] = { "generated", "shuffled", "hilbert" };
+
+  std::cout << num_tiles << " tiles, "
+    << static_cast<double> (generated.getNumNeighbors()) / num_tiles
+    << " neighbors each" << std::endl << std::fixed << std::setprecision(3);
+  for (size_t o = 0; o < 3; ++o)
+  {
+    Adjacency adjacency = generated.renumber(ORDERS[o]);
+    std::vector<TileState> renumbered (num_tiles);
+    for (size_t id = 0; id < num_tiles; ++id)
+    {
+      renumbered[ORDERS[o][id]] = states[id];
+    }
+
+    // How far apart neighbors are in id, and so in memory, and how many are
+    // close enough to share a cache line
+    double gap = 0;
+    size_t num_close = 0;
+    size_t per_line = 64 / sizeof(TileState);
+    for (size_t id = 0; id < num_tiles; ++id)
+    {
+      const Adjacency::tile_id_t* neighbors = adjacency.getNeighbors(id);
+      for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+      {
+        gap += std::fabs(static_cast<double> (neighbors[i]) - id);
+        if (neighbors[i] / per_line == id / per_line) { ++num_close; }
+      }
+    }
+    gap /= adjacency.getNumNeighbors();
+
+    // Count the dice next to every tile that could attack it, the way the AI
+    // looks over the board, for long enough to time reliably
+    size_t num_walks = 0, sum = 0;
+    std::chrono::steady_clock::time_point start =
+      std::chrono::steady_clock::now();
+    std::chrono::duration<double, std::nano> walking (0);
+    while (walking.count() < 2e8)
+    {
+      for (size_t id = 0; id < num_tiles; ++id)
+      {
+        const Adjacency::tile_id_t* neighbors = adjacency.getNeighbors(id);
+        for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+        {
+          const TileState& neighbor = renumbered[neighbors[i]];
+          if (neighbor.owner != renumbered[id].owner) {
+            sum += neighbor.num_dice;
+          }
+        }
+      }
+      ++num_walks;
+      walking = std::chrono::steady_clock::now() - start;
+    }
+
+    FairStart fair_start (num_rollouts, 0, 1);
+    start = std::chrono::steady_clock::now();
+    fair_start.getWinRates(adjacency, renumbered, seats, seed);
+    std::chrono::duration<double> rolling =
+      std::chrono::steady_clock::now() - start;
+
+    std::cout << NAMES[o] << ": " << gap << " ids between neighbors, "
+      << 100.0 * num_close / adjacency.getNumNeighbors() << "% in the same "
+      << "cache line, "
+      << walking.count() / (num_walks * adjacency.getNumNeighbors())
+      << " ns/neighbor walked, " << num_rollouts / rolling.count()
+      << " rollouts/s (checksum " << sum / num_walks << ")" << std::endl;
+  }
+}
@@ -0,0 +1,143 @@
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include "map_pack_writer.h"
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+MapPackWriter::MapPackWriter(
+  const std::string& path
+  , size_t width
+  , size_t height
+  , Board::Generator generator)
+  : out_(path, std::ios::out | std::ios::binary | std::ios::trunc)
+  , width_(width)
+  , height_(height)
+  , generator_(generator)
+{
+  if (!out_) {
+    throw std::runtime_error("Could not open map pack file.");
+  }
+
+  // Filled in properly once the index is written
+  MapPackHeader header;
+  std::memset(&header, 0, sizeof(header));
+  write(&header, sizeof(header));
+}
+
+
+MapPackWriter::~MapPackWriter()
+{
+  if (finished_) { return; }
+
+  // Destructors must not throw; call finish directly to hear about errors
+  try
+  {
+    finish();
+  }
+  catch (const std::exception& ex)
+  { }
+}
+
+
+void MapPackWriter::add(std::uint64_t seed, const Board& board)
+{
+  if (finished_) {
+    throw std::logic_error("Map pack has already been finished.");
+  }
+  if (board.getWidth() != width_ || board.getHeight() != height_) {
+    throw std::invalid_argument("Every map in a pack must be the same size.");
+  }
+
+  const Adjacency& adjacency = board.getAdjacency();
+  size_t num_tiles = adjacency.getNumTiles();
+
+  MapPackEntry entry;
+  entry.seed = seed;
+  entry.offset = (written_ + 7) & ~static_cast<std::uint64_t> (7);
+  entry.num_tiles = static_cast<std::uint32_t> (num_tiles);
+  entry.num_neighbors = static_cast<std::uint32_t> (
+    adjacency.getNumNeighbors());
+
+  std::uint64_t sections[MapPack::NUM_SECTIONS];
+  MapPack::getSections(
+    entry.offset
+    , width_
+    , height_
+    , num_tiles
+    , entry.num_neighbors
+    , sections);
+
+  padTo(sections[0]);
+  write(
+    board.getGrid().getCells()
+    , width_ * height_ * sizeof(TileGrid::tile_id_t));
+
+  padTo(sections[1]);
+  write(adjacency.getStarts(), (num_tiles + 1) * sizeof(std::uint32_t));
+
+  padTo(sections[2]);
+  write(
+    adjacency.getAllNeighbors()
+    , entry.num_neighbors * sizeof(Adjacency::tile_id_t));
+
+  padTo(sections[3]);
+  std::vector<unsigned char> dice (num_tiles);
+  for (Board::tile_iterator tile = board.getTiles()
+      ; tile != board.getTilesEnd()
+      ; ++tile)
+  {
+    dice[tile->getId()] = static_cast<unsigned char> (tile->getNumDice());
+  }
+  write(dice.data(), dice.size());
+
+  index_.push_back(entry);
+}
+
+
+void MapPackWriter::finish()
+{
+  finished_ = true;
+
+  MapPackHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MapPack::MAGIC, sizeof(MapPack::MAGIC));
+  header.version = MapPack::VERSION;
+  header.byte_order = MapPack::BYTE_ORDER_MARK;
+  header.width = static_cast<std::uint32_t> (width_);
+  header.height = static_cast<std::uint32_t> (height_);
+  header.generator = static_cast<std::uint32_t> (generator_);
+  header.num_maps = index_.size();
+  header.index_offset = (written_ + 7) & ~static_cast<std::uint64_t> (7);
+
+  padTo(header.index_offset);
+  write(index_.data(), index_.size() * sizeof(MapPackEntry));
+  header.file_size = written_;
+
+  // Now that everything is known, fill in the header
+  out_.seekp(0);
+  out_.write(reinterpret_cast<const char*> (&header), sizeof(header));
+  out_.flush();
+
+  if (!out_) {
+    throw std::runtime_error("Could not write map pack.");
+  }
+}
+
+
+void MapPackWriter::write(const void* data, size_t size)
+{
+  out_.write(
+    static_cast<const char*> (data)
+    , static_cast<std::streamsize> (size));
+  written_ += size;
+}
+
+
+void MapPackWriter::padTo(std::uint64_t offset)
+{
+  static const char ZEROS[8] = { 0 };
+  write(ZEROS, offset - written_);
+}
@@ -0,0 +1,96 @@
+#ifndef MAP_PACK_WRITER_H
+#define MAP_PACK_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "map_pack.h"
+
+/**
+ * Writes boards into a map pack (see map_pack.h) one at a time, so a pack
+ * can hold more maps than fit in memory. The index is written once every map
+ * has been added.
+ */
+class MapPackWriter
+{
+
+  public:
+
+    /******************************
+     * CONSTRUCTORS & DESTRUCTORS *
+     ******************************/
+
+    /**
+     * @param {std::string} path The file to write to. Overwritten.
+     * @param {size_t} width The width of every map.
+     * @param {size_t} height The height of every map.
+     * @param {Board::Generator} generator What generates every map.
+     */
+    MapPackWriter(
+      const std::string& path
+      , size_t width
+      , size_t height
+      , Board::Generator generator = Board::Generator::RANDOM_WALK);
+
+    /**
+     * Finishes the pack, if finish has not been called.
+     */
+    ~MapPackWriter();
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Adds a freshly generated board to the pack.
+     *
+     * @param {std::uint64_t} seed The seed the board was generated from.
+     * @param {Board} board The board, before anyone has moved.
+     */
+    void add(std::uint64_t seed, const Board& board);
+
+    /**
+     * Writes the index. Nothing can be added afterwards.
+     */
+    void finish();
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Writes bytes at the end of the file.
+     *
+     * @param {const void*} data The bytes.
+     * @param {size_t} size How many there are.
+     */
+    void write(const void* data, size_t size);
+
+    /**
+     * Writes zeros until the file reaches an offset.
+     *
+     * @param {std::uint64_t} offset The offset.
+     */
+    void padTo(std::uint64_t offset);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    std::ofstream out_;
+    size_t width_, height_;
+    Board::Generator generator_;
+    std::uint64_t written_ = 0;
+    std::vector<MapPackEntry> index_;
+    bool finished_ = false;
+
+};
+
+#endif
@@ -0,0 +1,48 @@
+#include <fcntl.h>
+#include <stdexcept>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+MappedFile::MappedFile(const std::string& path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    throw std::runtime_error("Could not open " + path + ".");
+  }
+
+  struct stat info;
+  if (fstat(fd, &info) != 0) {
+    close(fd);
+    throw std::runtime_error("Could not read the size of " + path + ".");
+  }
+
+  size_ = static_cast<size_t> (info.st_size);
+
+  // An empty file cannot be mapped, but there is nothing to read anyway
+  if (size_ > 0) {
+    void* mapped = mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+    if (mapped == MAP_FAILED) {
+      close(fd);
+      throw std::runtime_error("Could not map " + path + " into memory.");
+    }
+    data_ = static_cast<const unsigned char*> (mapped);
+  }
+
+  // The mapping stays valid once the file is closed
+  close(fd);
+}
+
+
+MappedFile::~MappedFile()
+{
+  if (data_) {
+    munmap(const_cast<unsigned char*> (data_), size_);
+  }
+}
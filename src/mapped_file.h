@@ -0,0 +1,53 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A file mapped read-only into memory. Nothing is read until it is touched,
+ * so opening even a very large file is instant, and the pages are shared with
+ * every other process that maps the same file.
+ */
+class MappedFile
+{
+
+  public:
+
+    /******************************
+     * CONSTRUCTORS & DESTRUCTORS *
+     ******************************/
+
+    /**
+     * @param {std::string} path The file to map.
+     */
+    explicit MappedFile(const std::string& path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    const unsigned char* getData() const { return data_; }
+    size_t getSize() const { return size_; }
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+
+};
+
+#endif
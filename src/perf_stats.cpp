@@ -0,0 +1,159 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <iomanip>
+#include <sstream>
+#include "perf_stats.h"
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Writes a duration with units that keep it short, or a count as it is.
+ *
+ * @param {std::ostream&} out Where to write.
+ * @param {std::uint64_t} value The duration in nanoseconds, or the count.
+ * @param {bool} is_count Whether the value is a count.
+ */
+void write_value(std::ostream& out, std::uint64_t value, bool is_count);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t PerfStats::NUM_METRICS;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+PerfStats& PerfStats::get()
+{
+  static PerfStats stats;
+
+  return stats;
+}
+
+
+const char* PerfStats::getName(Metric metric)
+{
+  switch (metric)
+  {
+    case Metric::TURN_AI_EASY: return "turn_ai_easy";
+    case Metric::TURN_AI_MEDIUM: return "turn_ai_medium";
+    case Metric::TURN_AI_HARD: return "turn_ai_hard";
+    case Metric::BOARD_GENERATION: return "board_generation";
+    case Metric::FRAME_RENDER: return "frame_render";
+    case Metric::INPUT_TO_PAINT: return "input_to_paint";
+    case Metric::TURN_ALLOCATIONS: return "turn_allocations";
+    default: return "unknown";
+  }
+}
+
+
+void PerfStats::getSummary(std::vector<std::string>& lines) const
+{
+  lines.clear();
+  for (size_t i = 0; i < NUM_METRICS; ++i)
+  {
+    const LatencyHistogram& histogram = histograms_[i];
+    if (histogram.getCount() == 0) { continue; }
+
+    Metric metric = static_cast<Metric> (i);
+    std::ostringstream line;
+    line << std::left << std::setw(17) << getName(metric) << " p50 ";
+    write_value(line, histogram.getPercentile(0.5), isCount(metric));
+    line << " p99 ";
+    write_value(line, histogram.getPercentile(0.99), isCount(metric));
+    line << " n " << histogram.getCount();
+    lines.push_back(line.str());
+  }
+
+  if (lines.empty()) { lines.push_back("Nothing timed yet"); }
+}
+
+
+void PerfStats::record(
+  Metric metric
+  , std::chrono::steady_clock::time_point start)
+{
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+  record(metric, static_cast<std::uint64_t> (elapsed.count()));
+}
+
+
+void PerfStats::clear()
+{
+  for (LatencyHistogram& histogram : histograms_)
+  {
+    histogram.clear();
+  }
+}
+
+
+void PerfStats::writeJson(std::ostream& out) const
+{
+  out << "{";
+  for (size_t i = 0; i < NUM_METRICS; ++i)
+  {
+    const LatencyHistogram& histogram = histograms_[i];
+    Metric metric = static_cast<Metric> (i);
+
+    out << (i == 0 ? "" : ",") << std::endl
+      << "  \"" << getName(metric) << "\": {"
+      << "\"unit\": \"" << (isCount(metric) ? "count" : "ns") << "\""
+      << ", \"count\": " << histogram.getCount()
+      << ", \"mean\": " << static_cast<std::uint64_t> (histogram.getMean())
+      << ", \"p50\": " << histogram.getPercentile(0.5)
+      << ", \"p90\": " << histogram.getPercentile(0.9)
+      << ", \"p99\": " << histogram.getPercentile(0.99)
+      << ", \"max\": " << histogram.getMax()
+      << ", \"buckets\": [";
+
+    // Each bucket as the largest value in it and how many fell in it
+    bool first = true;
+    size_t num_buckets = LatencyHistogram::getNumBuckets();
+    for (size_t bucket = 0; bucket < num_buckets; ++bucket)
+    {
+      std::uint64_t count = histogram.getBucketCount(bucket);
+      if (count == 0) { continue; }
+
+      out << (first ? "" : ", ") << "["
+        << LatencyHistogram::getBucketLimit(bucket) << ", " << count << "]";
+      first = false;
+    }
+    out << "]}";
+  }
+  out << std::endl << "}" << std::endl;
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+void write_value(std::ostream& out, std::uint64_t value, bool is_count)
+{
+  out << std::fixed << std::setprecision(1) << std::right << std::setw(6);
+  if (is_count) {
+    out << value << "  ";
+  }
+  else if (value < 1000) {
+    out << value << "ns";
+  }
+  else if (value < 1000000) {
+    out << value / 1e3 << "us";
+  }
+  else if (value < 1000000000) {
+    out << value / 1e6 << "ms";
+  }
+  else {
+    out << value / 1e9 << "s ";
+  }
+}
@@ -0,0 +1,170 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "latency_histogram.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * How long the parts of the game that the user waits on take, and how much
+ * they allocate, kept for the whole run so they can be shown while playing and
+ * saved when the game ends. There is one for the whole program, since the
+ * game, the AIs and the render thread all add to it.
+ */
+class PerfStats
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * What is timed.
+     */
+    enum class Metric : std::uint8_t
+    {
+      TURN_AI_EASY = 0 // One call to takeTurn, per kind of AI
+      , TURN_AI_MEDIUM
+      , TURN_AI_HARD
+      , BOARD_GENERATION
+      , FRAME_RENDER // Composing and drawing a frame on the render thread
+      , INPUT_TO_PAINT // From reading a key to showing what it did
+      , TURN_ALLOCATIONS // Allocations per AI turn, if they are counted
+      , NUM_METRICS
+    };
+
+    /**
+     * Times from when it is made to when it goes out of scope.
+     */
+    class Timer
+    {
+
+      public:
+
+        Timer(Metric metric)
+          : metric_(metric)
+          , start_(std::chrono::steady_clock::now())
+        { }
+
+        ~Timer() { PerfStats::get().record(metric_, start_); }
+
+      private:
+
+        Metric metric_;
+        std::chrono::steady_clock::time_point start_;
+
+    };
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    /**
+     * Returns the stats for the whole program.
+     *
+     * @returns {PerfStats&} The stats.
+     */
+    static PerfStats& get();
+
+    const LatencyHistogram& getHistogram(Metric metric) const
+    {
+      return histograms_[static_cast<size_t> (metric)];
+    }
+
+    /**
+     * Returns what a metric is called, such as in saved stats.
+     *
+     * @param {Metric} metric The metric.
+     * @returns {const char*} Its name.
+     */
+    static const char* getName(Metric metric);
+
+    /**
+     * Returns whether a metric counts something rather than timing it.
+     *
+     * @param {Metric} metric The metric.
+     * @returns {bool} True if it is a count; otherwise it is in nanoseconds.
+     */
+    static bool isCount(Metric metric)
+    {
+      return metric == Metric::TURN_ALLOCATIONS;
+    }
+
+    /**
+     * Describes every metric that has been recorded in one short line each,
+     * such as for showing over the board.
+     *
+     * @param {std::vector<std::string>&} lines Where the lines are stored.
+     */
+    void getSummary(std::vector<std::string>& lines) const;
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Counts how long something took, or how many of something there were.
+     *
+     * @param {Metric} metric What took that long.
+     * @param {std::uint64_t|std::chrono::steady_clock::time_point} ns How
+     * long it took in nanoseconds (or how many there were), or when it
+     * started if it just finished.
+     */
+    void record(Metric metric, std::uint64_t ns)
+    {
+      histograms_[static_cast<size_t> (metric)].record(ns);
+    }
+    void record(Metric metric, std::chrono::steady_clock::time_point start);
+
+    /**
+     * Writes every histogram as JSON, with its unit, its percentiles and the
+     * counts of every bucket that is not empty.
+     *
+     * @param {std::ostream&} out Where to write.
+     */
+    void writeJson(std::ostream& out) const;
+
+    /**
+     * Forgets everything recorded, such as between runs that are compared.
+     */
+    void clear();
+
+
+  private:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    PerfStats() = default;
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const size_t NUM_METRICS =
+      static_cast<size_t> (Metric::NUM_METRICS);
+
+    std::array<LatencyHistogram, NUM_METRICS> histograms_;
+
+};
+
+#endif
@@ -13,8 +13,8 @@ class Board;
  ************/
 
 #include <random>
-#include "color.h"
 #include "display.h"
+#include "tile.h"
 
 
 /**********
@@ -30,7 +30,7 @@ class Player
      * CONSTRUCTORS *
      ****************/
 
-    Player(Color c) : color_(c) { }
+    Player(Tile::owner_t id) : id_(id) { }
 
 
     /***************
@@ -47,9 +47,10 @@ class Player
     /*** GETTERS ***/
 
     /**
-     * Returns the color that this player has been assigned.
+     * Returns the id this player owns tiles under. The display decides what
+     * color that is.
      */
-    Color getColor() const { return color_; };
+    Tile::owner_t getId() const { return id_; };
 
 
     /*** UTILITY ***/
@@ -63,10 +64,18 @@ class Player
      */
     virtual bool takeTurn(std::mt19937& rng, Display& d, Board& b) = 0;
 
+    /**
+     * Returns whether the player asked to stop playing during their last
+     * turn, in which case the turn was not taken.
+     *
+     * @returns {bool} True if the game should be saved and closed.
+     */
+    virtual bool hasQuit() const { return false; }
+
 
   protected:
 
-    Color color_;
+    Tile::owner_t id_;
 
 };
 
@@ -0,0 +1,312 @@
+#ifndef PLAYOUT_H
+#define PLAYOUT_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+#include "adjacency.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Plays a position out to the end, with every seat attacking like the easy
+ * AI: a random tile of theirs that borders an enemy attacks a random enemy
+ * next to it, and is then reinforced. This has to follow the same rules as
+ * Board::resolveFight and Board::reinforce.
+ *
+ * It keeps what it works in from one playout to the next, so playing one out
+ * does not allocate, and which seats are still in the game is one word with a
+ * bit per seat.
+ *
+ * @param {Rules} Rules The variant of the rules, such as ClassicRules.
+ */
+template <typename Rules>
+class Playout
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    using seat_t = std::uint8_t;
+    using seat_mask_t = typename Rules::player_mask_t;
+
+    static_assert(
+      Rules::MAX_NUM_PLAYERS <= 0xFF
+      , "Every seat and no seat at all have to fit in a seat_t.");
+
+    // The owner of tiles that belong to nobody playing
+    static const seat_t NO_SEAT = 0xFF;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Plays a position out once.
+     *
+     * @param {std::mt19937&} rng Rolls the dice and picks the attacks.
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @param {std::vector<seat_t>} owners The seat owning each tile, or
+     * NO_SEAT.
+     * @param {std::vector<std::uint8_t>} dice The dice on each tile.
+     * @param {size_t} num_seats How many seats there are, at most
+     * Rules::MAX_NUM_PLAYERS.
+     * @param {size_t} turn_limit The most turns to play.
+     * @returns {int} The seat that won, or -1 if nobody did.
+     */
+    int play(
+      std::mt19937& rng
+      , const Adjacency& adjacency
+      , const std::vector<seat_t>& owners
+      , const std::vector<std::uint8_t>& dice
+      , size_t num_seats
+      , size_t turn_limit)
+    {
+      if (num_seats > Rules::MAX_NUM_PLAYERS) {
+        throw std::invalid_argument("Too many seats for these rules.");
+      }
+
+      owners_.assign(std::begin(owners), std::end(owners));
+      dice_.assign(std::begin(dice), std::end(dice));
+      banked_.fill(0);
+
+      // Every seat starts out playing, and takes their turn in seat order
+      seat_mask_t playing = static_cast<seat_mask_t> (
+        num_seats == 8 * sizeof(seat_mask_t)
+          ? ~seat_mask_t(0)
+          : (seat_mask_t(1) << num_seats) - 1);
+      size_t num_playing = num_seats;
+      seat_t seat = 0;
+
+      for (size_t turn = 0; num_playing > 1 && turn < turn_limit; ++turn)
+      {
+        if (!attack(rng, adjacency, seat)) {
+          // Nowhere left to attack from, so this seat is out
+          playing &= static_cast<seat_mask_t> (~(seat_mask_t(1) << seat));
+          --num_playing;
+        }
+        else {
+          reinforce(rng, adjacency, seat);
+        }
+
+        seat = getNextSeat(playing, seat, num_seats);
+      }
+
+      if (num_playing == 1) { return getNextSeat(playing, seat, num_seats); }
+      if (num_playing == 0) { return -1; }
+
+      // Out of turns, so whoever holds the most tiles wins, unless that is
+      // shared
+      num_tiles_.assign(num_seats, 0);
+      for (seat_t owner : owners_)
+      {
+        if (owner < num_seats) { ++num_tiles_[owner]; }
+      }
+
+      std::vector<size_t>::iterator most =
+        std::max_element(std::begin(num_tiles_), std::end(num_tiles_));
+      if (std::count(std::begin(num_tiles_), std::end(num_tiles_), *most) > 1) {
+        return -1;
+      }
+
+      return static_cast<int> (most - std::begin(num_tiles_));
+    }
+
+    /**
+     * Makes room for positions of a size, so the first playouts do not have
+     * to.
+     *
+     * @param {size_t} num_tiles How many tiles the positions have.
+     */
+    void reserve(size_t num_tiles)
+    {
+      owners_.reserve(num_tiles);
+      dice_.reserve(num_tiles);
+      frontline_.reserve(num_tiles);
+      enemies_.reserve(num_tiles);
+      stack_.reserve(num_tiles);
+      room_.reserve(num_tiles);
+      reached_.reserve(num_tiles);
+      num_tiles_.reserve(Rules::MAX_NUM_PLAYERS);
+    }
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Makes one attack for a seat.
+     *
+     * @param {std::mt19937&} rng Rolls the dice and picks the attack.
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @param {seat_t} seat The seat attacking.
+     * @returns {bool} False if the seat had nowhere to attack from.
+     */
+    bool attack(std::mt19937& rng, const Adjacency& adjacency, seat_t seat)
+    {
+      frontline_.clear();
+      for (size_t id = 0; id < owners_.size(); ++id)
+      {
+        if (owners_[id] != seat) { continue; }
+
+        const Adjacency::tile_id_t* neighbors = adjacency.getNeighbors(id);
+        for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+        {
+          if (owners_[neighbors[i]] != seat) {
+            frontline_.push_back(id);
+            break;
+          }
+        }
+      }
+
+      if (frontline_.empty()) { return false; }
+
+      size_t attacker = frontline_[
+        std::uniform_int_distribution<size_t>(0, frontline_.size() - 1)(rng)];
+
+      enemies_.clear();
+      const Adjacency::tile_id_t* neighbors = adjacency.getNeighbors(attacker);
+      for (size_t i = 0; i < adjacency.getDegree(attacker); ++i)
+      {
+        if (owners_[neighbors[i]] != seat) {
+          enemies_.push_back(neighbors[i]);
+        }
+      }
+      size_t defender = enemies_[
+        std::uniform_int_distribution<size_t>(0, enemies_.size() - 1)(rng)];
+
+      size_t attacker_total = Rules::roll(rng, dice_[attacker]);
+      size_t defender_total = Rules::roll(rng, dice_[defender]);
+
+      if (attacker_total > defender_total) {
+        dice_[defender] = dice_[attacker] - 1;
+        owners_[defender] = seat;
+      }
+      dice_[attacker] = 1;
+
+      return true;
+    }
+
+    /**
+     * Gives a seat as many dice as its largest group of touching tiles has,
+     * plus what it had banked, spread at random over its tiles that have
+     * room. What does not fit is banked for its next turn.
+     *
+     * @param {std::mt19937&} rng Picks where the dice go.
+     * @param {Adjacency} adjacency Which tiles border each other.
+     * @param {seat_t} seat The seat to reinforce.
+     */
+    void reinforce(std::mt19937& rng, const Adjacency& adjacency, seat_t seat)
+    {
+      // Flood each group of the seat's in turn, keeping the largest
+      reached_.assign(owners_.size(), 0);
+      size_t largest = 0;
+      for (size_t start = 0; start < owners_.size(); ++start)
+      {
+        if (owners_[start] != seat || reached_[start]) { continue; }
+
+        size_t size = 0;
+        stack_.clear();
+        stack_.push_back(start);
+        reached_[start] = 1;
+        while (!stack_.empty())
+        {
+          size_t id = stack_.back();
+          stack_.pop_back();
+          ++size;
+
+          const Adjacency::tile_id_t* neighbors = adjacency.getNeighbors(id);
+          for (size_t i = 0; i < adjacency.getDegree(id); ++i)
+          {
+            if (owners_[neighbors[i]] == seat && !reached_[neighbors[i]]) {
+              reached_[neighbors[i]] = 1;
+              stack_.push_back(neighbors[i]);
+            }
+          }
+        }
+
+        largest = std::max(largest, size);
+      }
+
+      room_.clear();
+      for (size_t id = 0; id < owners_.size(); ++id)
+      {
+        if (owners_[id] == seat && dice_[id] < Rules::MAX_DICE_PER_TILE) {
+          room_.push_back(id);
+        }
+      }
+
+      size_t num_dice = banked_[seat] + largest;
+      size_t num_open = room_.size();
+      for (; num_dice > 0 && num_open > 0; --num_dice)
+      {
+        size_t i = std::uniform_int_distribution<size_t>(0, num_open - 1)(rng);
+        if (++dice_[room_[i]] == Rules::MAX_DICE_PER_TILE) {
+          std::swap(room_[i], room_[--num_open]);
+        }
+      }
+      banked_[seat] = std::min<size_t>(num_dice, Rules::MAX_BANKED_DICE);
+    }
+
+    /**
+     * Finds whose turn is next.
+     *
+     * @param {seat_mask_t} playing The seats still playing.
+     * @param {seat_t} seat The seat whose turn it was.
+     * @param {size_t} num_seats How many seats there are.
+     * @returns {seat_t} The next seat after it that is still playing, which
+     * may be itself.
+     */
+    static seat_t getNextSeat(
+      seat_mask_t playing
+      , seat_t seat
+      , size_t num_seats)
+    {
+      for (size_t i = 1; i <= num_seats; ++i)
+      {
+        seat_t next = static_cast<seat_t> ((seat + i) % num_seats);
+        if (playing & (seat_mask_t(1) << next)) { return next; }
+      }
+
+      return seat;
+    }
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    std::vector<seat_t> owners_;
+    std::vector<std::uint8_t> dice_;
+    std::vector<size_t> frontline_, enemies_, num_tiles_, stack_, room_;
+    std::vector<std::uint8_t> reached_;
+    std::array<size_t, Rules::MAX_NUM_PLAYERS> banked_;
+
+};
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+template <typename Rules>
+const typename Playout<Rules>::seat_t Playout<Rules>::NO_SEAT;
+
+#endif
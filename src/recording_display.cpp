@@ -0,0 +1,213 @@
+#include <cstdio>
+#include <ctime>
+#include <stdexcept>
+#include <string>
+#include "recording_display.h"
+#include "color.h"
+#include "screen.h"
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Adds a string to another as the inside of a JSON string literal.
+ *
+ * @param {std::string&} out Where to add the escaped string.
+ * @param {std::string} in The string to escape.
+ */
+void append_json_escaped(std::string& out, const std::string& in);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t RecordingDisplay::BUFFER_SIZE = 1 << 16;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+RecordingDisplay::RecordingDisplay(
+  const std::string& path
+  , size_t width
+  , size_t height
+  , size_t columns
+  , size_t rows)
+  : Display(width, height)
+  , columns_(columns)
+  , rows_(rows)
+  , buffer_(BUFFER_SIZE)
+  , shown_(columns, rows)
+  , next_(columns, rows)
+{
+  // The buffer has to be in place before the file is opened
+  out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+  out_.open(path, std::ios::out | std::ios::trunc);
+
+  if (!out_) {
+    throw std::runtime_error("Could not open recording file.");
+  }
+
+  out_ << "{\"version\": 2, \"width\": " << columns_
+    << ", \"height\": " << rows_
+    << ", \"timestamp\": " << std::time(nullptr)
+    << ", \"env\": {\"TERM\": \"xterm-256color\"}}\n";
+
+  // Start from a blank screen with no cursor, which is what shown_ holds
+  writeEvent("\x1b[0m\x1b[2J\x1b[?25l");
+}
+
+
+RecordingDisplay::~RecordingDisplay()
+{
+  writeEvent("\x1b[0m\x1b[?25h\r\n");
+}
+
+
+void RecordingDisplay::wait(int ms)
+{
+  clock_ms_ += ms;
+}
+
+
+void RecordingDisplay::present(const Frame& frame)
+{
+  next_.compose(frame, false);
+
+  escapes_.clear();
+  bool have_style = false;
+  ColorPair style = ColorPair::DEFAULT;
+  size_t cursor_row = rows_, cursor_col = columns_;
+
+  size_t first, last;
+  next_.getChangedRows(first, last);
+
+  for (size_t row = first; row < last; ++row)
+  {
+    for (size_t col = 0; col < columns_; ++col)
+    {
+      const ScreenCell& cell = next_.at(col, row);
+      if (cell == shown_.at(col, row)) { continue; }
+
+      // Only move the cursor when it is not already in the right place
+      if (row != cursor_row || col != cursor_col) {
+        escapes_ += "\x1b[";
+        escapes_ += std::to_string(row + 1);
+        escapes_ += ';';
+        escapes_ += std::to_string(col + 1);
+        escapes_ += 'H';
+      }
+
+      if (!have_style || cell.pair != style) {
+        appendStyle(cell.pair);
+        style = cell.pair;
+        have_style = true;
+      }
+
+      escapes_ += cell.character;
+      cursor_row = row;
+      cursor_col = col + 1;
+    }
+  }
+
+  shown_.copyRows(next_, first, last);
+
+  if (!escapes_.empty()) {
+    writeEvent(escapes_);
+  }
+}
+
+
+Display::InputEvent RecordingDisplay::waitForInput()
+{
+  // Nobody is there to press anything
+  InputEvent enter = { '\n', false, 0, 0 };
+  return enter;
+}
+
+
+void RecordingDisplay::getTerminalSize(size_t& width, size_t& height) const
+{
+  width = columns_;
+  height = rows_;
+}
+
+
+void RecordingDisplay::writeEvent(const std::string& data)
+{
+  char timestamp[32];
+  std::snprintf(timestamp, sizeof(timestamp), "%llu.%03llu"
+    , static_cast<unsigned long long> (clock_ms_ / 1000)
+    , static_cast<unsigned long long> (clock_ms_ % 1000));
+
+  line_.clear();
+  line_ += '[';
+  line_ += timestamp;
+  line_ += ", \"o\", \"";
+  append_json_escaped(line_, data);
+  line_ += "\"]\n";
+
+  out_.write(line_.data(), line_.size());
+}
+
+
+void RecordingDisplay::appendStyle(ColorPair pair)
+{
+  switch (pair)
+  {
+    case ColorPair::DEFAULT:
+      escapes_ += "\x1b[0m";
+      return;
+
+    case ColorPair::WHITE_BLACK:
+      escapes_ += "\x1b[0;37;40m";
+      return;
+
+    default:
+      break;
+  }
+
+  // Every other pair is white text on a player's color
+  short int r, g, b;
+  ColorHelpers::getRGB(static_cast<Color> (pair), r, g, b);
+
+  escapes_ += "\x1b[0;97;48;2;";
+  escapes_ += std::to_string(r * 255 / 1000);
+  escapes_ += ';';
+  escapes_ += std::to_string(g * 255 / 1000);
+  escapes_ += ';';
+  escapes_ += std::to_string(b * 255 / 1000);
+  escapes_ += 'm';
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+void append_json_escaped(std::string& out, const std::string& in)
+{
+  for (char c : in)
+  {
+    switch (c)
+    {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n"; break;
+      case '\r': out += "\\r"; break;
+
+      default:
+        if (static_cast<unsigned char> (c) < 0x20) {
+          char escaped[8];
+          std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+          out += escaped;
+        }
+        else {
+          out += c;
+        }
+    }
+  }
+}
@@ -0,0 +1,111 @@
+#ifndef RECORDING_DISPLAY_H
+#define RECORDING_DISPLAY_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "display.h"
+#include "frame.h"
+#include "screen.h"
+
+/**
+ * Records the game to an asciicast (version 2) file instead of showing it, so
+ * it can be replayed later in any terminal player. Each frame is written as the
+ * ANSI escape codes needed to change only the characters that differ from the
+ * previous frame, stamped with game time rather than wall-clock time, so
+ * recording costs barely more than running headless.
+ */
+class RecordingDisplay : public Display
+{
+
+  public:
+
+    /******************************
+     * CONSTRUCTORS & DESTRUCTORS *
+     ******************************/
+
+    /**
+     * @param {std::string} path The file to record to. Overwritten.
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {size_t} columns The width of the recorded terminal.
+     * @param {size_t} rows The height of the recorded terminal.
+     */
+    RecordingDisplay(
+      const std::string& path
+      , size_t width
+      , size_t height
+      , size_t columns = MINIMUM_WIDTH
+      , size_t rows = MINIMUM_HEIGHT);
+
+    virtual ~RecordingDisplay();
+
+
+  protected:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Moves the recording's clock forward instead of waiting.
+     *
+     * @param {int} ms How long to wait, in milliseconds.
+     */
+    virtual void wait(int ms) override;
+
+    virtual void present(const Frame& frame) override;
+
+    virtual InputEvent waitForInput() override;
+
+    virtual void getTerminalSize(size_t& width, size_t& height) const override;
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Writes one output event to the file at the current game time.
+     *
+     * @param {std::string} data The raw terminal output.
+     */
+    void writeEvent(const std::string& data);
+
+    /**
+     * Adds the escape code that switches to a color pair.
+     *
+     * @param {ColorPair} pair The color pair.
+     */
+    void appendStyle(ColorPair pair);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    /*** CLASS PROPERTIES ***/
+
+    // How much file output is collected before it is written
+    static const size_t BUFFER_SIZE;
+
+
+    /*** INSTANCE PROPERTIES ***/
+
+    size_t columns_, rows_;
+    std::vector<char> buffer_;
+    std::ofstream out_;
+    Screen shown_, next_;
+
+    // Reused between frames so that recording does not allocate
+    std::string escapes_, line_;
+
+    // Game time, in milliseconds since the recording started
+    std::uint64_t clock_ms_ = 0;
+
+};
+
+#endif
@@ -0,0 +1,483 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "board.h"
+#include "dicefeud.h"
+#include "frame.h"
+#include "headless_display.h"
+#include "map_generator.h"
+#include "perf_stats.h"
+#include "rules.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * One map to generate or game to play, always the same way.
+ */
+struct RegressionCase
+{
+  std::string name;
+  bool is_game;
+  Board::Generator generator;
+  size_t width, height;
+
+  // About how many tiles the board is divided into
+  size_t num_tiles;
+
+  std::uint64_t seed;
+
+  // Games only
+  size_t num_players, num_turns;
+};
+
+/**
+ * How a case ended and how long it took, as measured or as in the baseline.
+ */
+struct RegressionResult
+{
+  std::string name;
+
+  // Of the final position, which has to be the same on every run
+  std::uint64_t checksum;
+
+  // Maps generated or turns played per second, in the fastest run
+  double ops_per_second;
+
+  // The 99th percentile of how long a map or an AI turn took
+  std::uint64_t p99_ns;
+};
+
+/**
+ * How the results are compared with the baseline.
+ */
+struct RegressionSettings
+{
+  size_t num_repeats;
+
+  // How much slower, as a fraction, throughput and latency may get
+  double throughput_tolerance, latency_tolerance;
+
+  bool checksums_only;
+};
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Lists the maps and games that are checked. Changing these means making a
+ * new baseline.
+ *
+ * @returns {std::vector<RegressionCase>} The cases.
+ */
+std::vector<RegressionCase> get_corpus();
+
+/**
+ * Generates a map, or plays a game, several times.
+ *
+ * @param {RegressionCase} test The case.
+ * @param {size_t} num_repeats How many times to run it.
+ * @returns {RegressionResult} What came of it.
+ */
+RegressionResult run_case(const RegressionCase& test, size_t num_repeats);
+
+/**
+ * Adds who owns every tile, and with how many dice, to a hash.
+ *
+ * @param {std::uint64_t} hash The hash so far.
+ * @param {std::vector<TileState>} states The tiles.
+ * @returns {std::uint64_t} The new hash.
+ */
+std::uint64_t hash_states(
+  std::uint64_t hash
+  , const std::vector<TileState>& states);
+
+/**
+ * Adds a number to a hash.
+ *
+ * @param {std::uint64_t} hash The hash so far.
+ * @param {std::uint64_t} value The number.
+ * @returns {std::uint64_t} The new hash.
+ */
+std::uint64_t hash_value(std::uint64_t hash, std::uint64_t value);
+
+/**
+ * Reads a baseline made by write_baseline.
+ *
+ * @param {std::string} path The file.
+ * @returns {std::map<std::string, RegressionResult>} Every case in it, by
+ * name.
+ */
+std::map<std::string, RegressionResult> read_baseline(const std::string& path);
+
+/**
+ * Saves results as the baseline to compare later runs with.
+ *
+ * @param {std::string} path The file.
+ * @param {std::vector<RegressionResult>} results The results.
+ */
+void write_baseline(
+  const std::string& path
+  , const std::vector<RegressionResult>& results);
+
+/**
+ * Compares results with the baseline, printing how each case did.
+ *
+ * @param {std::vector<RegressionResult>} results The results.
+ * @param {std::map<std::string, RegressionResult>} baseline The baseline.
+ * @param {RegressionSettings} settings How close they have to be.
+ * @returns {bool} True if nothing changed its result or got too slow.
+ */
+bool compare(
+  const std::vector<RegressionResult>& results
+  , const std::map<std::string, RegressionResult>& baseline
+  , const RegressionSettings& settings);
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+/**
+ * Plays a fixed set of seeded maps and headless games, and checks that they
+ * end exactly as they did in the baseline and are not much slower.
+ */
+int main(int argc, char** argv)
+{
+  std::string baseline_path, update_path;
+  RegressionSettings settings = { 3, 0.5, 1.0, false };
+
+  try
+  {
+    for (int i = 1; i < argc; ++i)
+    {
+      bool has_value = i + 1 < argc;
+
+      if (std::string(argv[i]) == "--baseline" && has_value) {
+        baseline_path = argv[++i];
+      }
+      else if (std::string(argv[i]) == "--update" && has_value) {
+        update_path = argv[++i];
+      }
+      else if (std::string(argv[i]) == "--repeats" && has_value) {
+        settings.num_repeats = std::max<size_t>(std::stoul(argv[++i]), 1);
+      }
+      else if (std::string(argv[i]) == "--tolerance" && has_value) {
+        settings.throughput_tolerance = std::stod(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--latency-tolerance" && has_value) {
+        settings.latency_tolerance = std::stod(argv[++i]);
+      }
+      else if (std::string(argv[i]) == "--checksums-only") {
+        settings.checksums_only = true;
+      }
+      else {
+        throw std::invalid_argument("Unknown argument.");
+      }
+    }
+
+    if (baseline_path.empty() == update_path.empty()) {
+      throw std::invalid_argument("Need either a baseline or an update.");
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Usage: " << argv[0] << " --baseline FILE [--repeats N]"
+      << " [--tolerance F] [--latency-tolerance F] [--checksums-only]"
+      << std::endl
+      << "       " << argv[0] << " --update FILE [--repeats N]" << std::endl;
+    return 1;
+  }
+
+  try
+  {
+    std::map<std::string, RegressionResult> baseline;
+    if (!baseline_path.empty()) {
+      baseline = read_baseline(baseline_path);
+    }
+
+    std::vector<RegressionResult> results;
+    for (const RegressionCase& test : get_corpus())
+    {
+      results.push_back(run_case(test, settings.num_repeats));
+    }
+
+    if (!update_path.empty()) {
+      write_baseline(update_path, results);
+      std::cout << "Wrote " << results.size() << " cases to " << update_path
+        << std::endl;
+      return 0;
+    }
+
+    return compare(results, baseline, settings) ? 0 : 1;
+  }
+  catch (const std::exception& ex)
+  {
+    std::cout << "Error in program: " << ex.what() << std::endl;
+    return 1;
+  }
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+std::vector<RegressionCase> get_corpus()
+{
+  const Board::Generator WALK = Board::Generator::RANDOM_WALK;
+  const Board::Generator VORONOI = Board::Generator::VORONOI;
+  const size_t WIDTH = Display::MINIMUM_WIDTH;
+  const size_t HEIGHT = Display::MINIMUM_HEIGHT - 1;
+
+  // The usual number of tiles, and a few for each player in the largest games
+  const size_t FEW = Board::DEFAULT_NUM_TILES;
+  const size_t MANY = 3 * GameRules::MAX_NUM_PLAYERS;
+
+  return {
+    { "map/walk/80x23/1", false, WALK, WIDTH, HEIGHT, FEW, 1, 0, 0 }
+    , { "map/walk/80x23/2", false, WALK, WIDTH, HEIGHT, FEW, 2, 0, 0 }
+    , { "map/voronoi/80x23/3", false, VORONOI, WIDTH, HEIGHT, FEW, 3, 0, 0 }
+    , { "map/voronoi/400x200/4", false, VORONOI, 400, 200, FEW, 4, 0, 0 }
+    , { "game/walk/80x23/5", true, WALK, WIDTH, HEIGHT, FEW, 5, 8, 20000 }
+    , { "game/walk/80x23/6", true, WALK, WIDTH, HEIGHT, FEW, 6, 4, 20000 }
+    , { "game/voronoi/80x23/7", true, VORONOI, WIDTH, HEIGHT, FEW, 7, 8, 20000 }
+    , { "game/voronoi/200x60/8", true, VORONOI, 200, 60, FEW, 8, 8, 20000 }
+    , { "game/voronoi/400x200/9", true, VORONOI, 400, 200, MANY, 9, 64, 20000 }
+  };
+}
+
+
+RegressionResult run_case(const RegressionCase& test, size_t num_repeats)
+{
+  typedef std::chrono::steady_clock clock;
+
+  HeadlessDisplay d (test.width, test.height);
+  PerfStats& stats = PerfStats::get();
+
+  // Every run only ever gets slower from whatever else the machine is doing,
+  // so the best of them is the one compared
+  RegressionResult result = { test.name, 0, 0, UINT64_MAX };
+  for (size_t repeat = 0; repeat < num_repeats; ++repeat)
+  {
+    stats.clear();
+    std::mt19937 rng(static_cast<std::mt19937::result_type> (test.seed));
+    std::uint64_t checksum;
+    size_t num_ops = 1;
+
+    clock::time_point start = clock::now();
+    Board board (
+      rng
+      , d
+      , test.width
+      , test.height
+      , test.generator
+      , test.num_tiles);
+    std::chrono::duration<double> elapsed = clock::now() - start;
+
+    if (test.is_game) {
+      DiceFeud game (rng, d, std::move(board), test.num_players, false);
+      game.setTurnLimit(test.num_turns);
+
+      start = clock::now();
+      game.play(rng);
+      elapsed = clock::now() - start;
+      num_ops = std::max<size_t>(game.getTurn(), 1);
+
+      std::vector<TileState> states;
+      game.getBoard().getTileStates(states);
+      checksum = hash_states(
+        MapGenerator::hashLayout(game.getBoard().getGrid())
+        , states);
+      checksum = hash_value(checksum, game.getTurn());
+      checksum = hash_value(checksum, game.getNumPlayersLeft());
+      checksum = hash_value(checksum, rng());
+    }
+    else {
+      std::vector<TileState> states;
+      board.getTileStates(states);
+      checksum = hash_states(MapGenerator::hashLayout(board.getGrid()), states);
+    }
+
+    // A run that ends differently from the last one is not deterministic
+    if (repeat > 0 && checksum != result.checksum) {
+      throw std::runtime_error(test.name + " ended differently between runs.");
+    }
+    result.checksum = checksum;
+    result.ops_per_second =
+      std::max(result.ops_per_second, num_ops / elapsed.count());
+
+    // The slowest kind of AI, or the map
+    std::uint64_t p99_ns = 0;
+    const PerfStats::Metric TURNS[] = {
+      PerfStats::Metric::TURN_AI_EASY
+      , PerfStats::Metric::TURN_AI_MEDIUM
+      , PerfStats::Metric::TURN_AI_HARD
+    };
+    for (PerfStats::Metric metric : TURNS)
+    {
+      p99_ns = std::max(p99_ns, stats.getHistogram(metric).getPercentile(0.99));
+    }
+    if (!test.is_game) {
+      p99_ns = stats.getHistogram(PerfStats::Metric::BOARD_GENERATION)
+        .getPercentile(0.99);
+    }
+    result.p99_ns = std::min(result.p99_ns, p99_ns);
+  }
+
+  return result;
+}
+
+
+std::uint64_t hash_states(
+  std::uint64_t hash
+  , const std::vector<TileState>& states)
+{
+  for (const TileState& state : states)
+  {
+    hash = hash_value(hash, state.owner);
+    hash = hash_value(hash, state.num_dice);
+  }
+
+  return hash;
+}
+
+
+std::uint64_t hash_value(std::uint64_t hash, std::uint64_t value)
+{
+  // FNV-1a, a byte at a time
+  for (size_t byte = 0; byte < sizeof(value); ++byte)
+  {
+    hash = (hash ^ ((value >> (8 * byte)) & 0xFF)) * 0x100000001B3ull;
+  }
+
+  return hash;
+}
+
+
+std::map<std::string, RegressionResult> read_baseline(const std::string& path)
+{
+  std::ifstream in (path);
+  if (!in) { throw std::runtime_error("Could not open " + path + "."); }
+
+  std::map<std::string, RegressionResult> baseline;
+  std::string line;
+  while (std::getline(in, line))
+  {
+    if (line.empty() || line[0] == '#') { continue; }
+
+    RegressionResult result;
+    std::istringstream fields (line);
+    fields >> result.name >> std::hex >> result.checksum >> std::dec
+      >> result.ops_per_second >> result.p99_ns;
+    if (!fields) {
+      throw std::runtime_error("Bad line in " + path + ": " + line);
+    }
+
+    baseline[result.name] = result;
+  }
+
+  return baseline;
+}
+
+
+void write_baseline(
+  const std::string& path
+  , const std::vector<RegressionResult>& results)
+{
+  std::ofstream out (path);
+  out << "# Made by dicefeud_regress --update, in the default build. One case"
+    << std::endl
+    << "# per line: name, checksum, maps or turns per second, p99 in ns."
+    << std::endl;
+
+  for (const RegressionResult& result : results)
+  {
+    out << result.name << " "
+      << std::hex << std::setw(16) << std::setfill('0') << result.checksum
+      << std::dec << std::setfill(' ') << " "
+      << std::fixed << std::setprecision(1) << result.ops_per_second << " "
+      << result.p99_ns << std::endl;
+  }
+
+  if (!out) { throw std::runtime_error("Could not write " + path + "."); }
+}
+
+
+bool compare(
+  const std::vector<RegressionResult>& results
+  , const std::map<std::string, RegressionResult>& baseline
+  , const RegressionSettings& settings)
+{
+  bool passed = true;
+
+  std::cout << std::left << std::setw(26) << "case"
+    << std::setw(10) << "checksum"
+    << std::right << std::setw(14) << "ops/s"
+    << std::setw(10) << "vs base"
+    << std::setw(12) << "p99 us"
+    << std::setw(10) << "vs base" << std::endl
+    << std::fixed << std::setprecision(1);
+
+  for (const RegressionResult& result : results)
+  {
+    std::cout << std::left << std::setw(26) << result.name;
+
+    std::map<std::string, RegressionResult>::const_iterator expected =
+      baseline.find(result.name);
+    if (expected == std::end(baseline)) {
+      std::cout << "not in the baseline" << std::endl;
+      passed = false;
+      continue;
+    }
+
+    bool same = result.checksum == expected->second.checksum;
+    std::cout << std::setw(settings.checksums_only ? 0 : 10)
+      << (same ? "ok" : "CHANGED");
+    passed = passed && same;
+
+    if (settings.checksums_only) {
+      std::cout << std::endl;
+      continue;
+    }
+
+    // Relative to the baseline, so 100% is just as fast
+    double throughput =
+      100 * result.ops_per_second / expected->second.ops_per_second;
+    double latency = 100.0 * result.p99_ns
+      / std::max<std::uint64_t>(expected->second.p99_ns, 1);
+    bool fast_enough =
+      throughput >= 100 * (1 - settings.throughput_tolerance);
+    bool responsive_enough =
+      latency <= 100 * (1 + settings.latency_tolerance);
+    passed = passed && fast_enough && responsive_enough;
+
+    std::cout << std::right << std::setw(14) << result.ops_per_second
+      << std::setw(9) << throughput << (fast_enough ? "%" : "!")
+      << std::setw(12) << result.p99_ns / 1e3
+      << std::setw(9) << latency << (responsive_enough ? "%" : "!")
+      << std::endl;
+  }
+
+  std::cout << (passed ? "No regressions" : "Regressed") << std::endl;
+
+  return passed;
+}
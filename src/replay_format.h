@@ -0,0 +1,104 @@
+#ifndef REPLAY_FORMAT_H
+#define REPLAY_FORMAT_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+/*************
+ * FUNCTIONS *
+ *************/
+
+/**
+ * The layout of a replay file, shared by ReplayWriter and ReplayReader.
+ *
+ * A replay starts with a header:
+ *   "DFRP", a version byte, then the seed the board was generated from, the
+ *   generator that made it, the board's width and height, the number of
+ *   tiles it was asked to have, and the number of turns between keyframes.
+ *
+ * Then come records, each starting with its kind:
+ *   FIGHT     attacker id, defender id, attacker total, defender total
+ *   REINFORCE tile id, number of dice it was given
+ *   END_TURN  (nothing)
+ *   KEYFRAME  turn, number of tiles, then the owner and dice of every tile
+ *
+ * A keyframe comes before the first record of every turn that is a multiple
+ * of the keyframe interval, starting with the state the game began in.
+ *
+ * A finished replay ends with an index:
+ *   END, number of turns, number of keyframes, then the turn and file offset
+ *   of each keyframe, each as the difference from the one before it
+ * followed by the offset of the index as 8 little-endian bytes and "DFRI".
+ *
+ * Every number is an unsigned LEB128 varint, so almost every field fits in a
+ * single byte.
+ */
+namespace ReplayFormat
+{
+  const char MAGIC[] = { 'D', 'F', 'R', 'P' };
+  const char INDEX_MAGIC[] = { 'D', 'F', 'R', 'I' };
+  // Version 2 boards are generated differently from the same seed, version 3
+  // added the generator, version 4 numbers the tiles differently, and
+  // version 5 stores who owns a tile rather than its color, version 6 added
+  // reinforcements, and version 7 the number of tiles asked for
+  const std::uint8_t VERSION = 7;
+
+  // The index offset and INDEX_MAGIC
+  const size_t TRAILER_SIZE = 12;
+
+  enum class Record : std::uint8_t
+  {
+    END_TURN = 0
+    , FIGHT
+    , KEYFRAME
+    , END
+    , REINFORCE
+  };
+
+  /**
+   * Adds a number to the end of a buffer as a varint.
+   *
+   * @param {std::vector<std::uint8_t>&} out The buffer.
+   * @param {std::uint64_t} value The number.
+   */
+  inline void appendVarint(std::vector<std::uint8_t>& out, std::uint64_t value)
+  {
+    while (value >= 0x80)
+    {
+      out.push_back(static_cast<std::uint8_t> (value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<std::uint8_t> (value));
+  }
+
+  /**
+   * Reads a varint and moves past it.
+   *
+   * @param {const std::uint8_t*&} pos Where the varint starts.
+   * @param {const std::uint8_t*} end The end of the readable data.
+   * @param {std::uint64_t&} value Where the number is stored.
+   * @returns {bool} False if the data ended in the middle of the varint.
+   */
+  inline bool readVarint(
+    const std::uint8_t*& pos
+    , const std::uint8_t* end
+    , std::uint64_t& value)
+  {
+    value = 0;
+    for (unsigned shift = 0; pos != end && shift < 64; shift += 7)
+    {
+      std::uint8_t byte = *pos++;
+      value |= static_cast<std::uint64_t> (byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0) { return true; }
+    }
+    return false;
+  }
+}
+
+#endif
@@ -0,0 +1,328 @@
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include "replay_reader.h"
+#include "replay_format.h"
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+ReplayReader::ReplayReader(const std::string& path)
+  : file_(path)
+  , data_(file_.getData())
+  , size_(file_.getSize())
+{
+  const std::uint8_t* pos = data_;
+  const std::uint8_t* end = pos + size_;
+  records_end_ = end;
+
+  // Header
+  std::uint64_t generator, width, height, target_num_tiles, keyframe_interval;
+  bool valid = size_ > sizeof(ReplayFormat::MAGIC)
+    && std::memcmp(pos, ReplayFormat::MAGIC, sizeof(ReplayFormat::MAGIC)) == 0
+    && pos[sizeof(ReplayFormat::MAGIC)] == ReplayFormat::VERSION;
+  if (valid) {
+    pos += sizeof(ReplayFormat::MAGIC) + 1;
+    valid = ReplayFormat::readVarint(pos, end, seed_)
+      && ReplayFormat::readVarint(pos, end, generator)
+      && generator <= static_cast<std::uint64_t> (Board::Generator::VORONOI)
+      && ReplayFormat::readVarint(pos, end, width)
+      && ReplayFormat::readVarint(pos, end, height)
+      && ReplayFormat::readVarint(pos, end, target_num_tiles)
+      && ReplayFormat::readVarint(pos, end, keyframe_interval);
+  }
+  if (!valid) {
+    throw std::runtime_error("Not a replay file.");
+  }
+
+  generator_ = static_cast<Board::Generator> (generator);
+  width_ = width;
+  height_ = height;
+  target_num_tiles_ = target_num_tiles;
+  keyframe_interval_ = keyframe_interval;
+  pos_ = pos;
+
+  if (!readIndex()) { scan(); }
+
+  if (keyframes_.empty()) {
+    throw std::runtime_error("Replay does not contain any turns.");
+  }
+
+  // Every keyframe has every tile, so the first one tells us how many there are
+  const std::uint8_t* first = data_ + keyframes_.front().second + 1;
+  std::uint64_t ignored, num_tiles;
+  ReplayFormat::readVarint(first, records_end_, ignored);
+  ReplayFormat::readVarint(first, records_end_, num_tiles);
+  num_tiles_ = num_tiles;
+}
+
+
+void ReplayReader::seek(size_t turn, std::vector<TileState>& tiles)
+{
+  if (turn > num_turns_) {
+    throw std::out_of_range("Replay does not have that many turns.");
+  }
+
+  // Find the last keyframe at or before the turn
+  std::vector<std::pair<size_t, std::uint64_t>>::const_iterator keyframe =
+    std::upper_bound(
+      std::begin(keyframes_)
+      , std::end(keyframes_)
+      , turn
+      , [](size_t t, const std::pair<size_t, std::uint64_t>& k) {
+        return t < k.first;
+      });
+  --keyframe;
+
+  pos_ = data_ + keyframe->second + 1;
+  if (!readKeyframe(pos_, turn_, &tiles)) {
+    throw std::runtime_error("Replay keyframe is damaged.");
+  }
+
+  // Play forward to the turn
+  Event event;
+  while (turn_ < turn && next(event))
+  {
+    if (event.type == Event::Type::FIGHT) { applyFight(event, tiles); }
+    if (event.type == Event::Type::REINFORCE) {
+      applyReinforcement(event, tiles);
+    }
+  }
+}
+
+
+bool ReplayReader::next(Event& event)
+{
+  while (pos_ < records_end_)
+  {
+    std::uint8_t kind = *pos_++;
+
+    if (kind == static_cast<std::uint8_t> (ReplayFormat::Record::KEYFRAME)) {
+      size_t ignored;
+      if (!readKeyframe(pos_, ignored, nullptr)) { return false; }
+      continue;
+    }
+
+    if (!readEvent(kind, pos_, event)) { return false; }
+    if (event.type == Event::Type::END_TURN) { ++turn_; }
+    return true;
+  }
+
+  return false;
+}
+
+
+void ReplayReader::applyFight(const Event& fight, std::vector<TileState>& tiles)
+{
+  if (fight.attacker_id >= tiles.size() || fight.defender_id >= tiles.size()) {
+    throw std::out_of_range("Replay refers to a tile that does not exist.");
+  }
+
+  // This has to match Board::resolveFight
+  TileState& attacker = tiles[fight.attacker_id];
+  TileState& defender = tiles[fight.defender_id];
+
+  if (fight.attacker_total > fight.defender_total) {
+    defender.num_dice = attacker.num_dice - 1;
+    defender.owner = attacker.owner;
+  }
+
+  attacker.num_dice = 1;
+}
+
+
+void ReplayReader::applyReinforcement(
+  const Event& reinforcement
+  , std::vector<TileState>& tiles)
+{
+  if (reinforcement.tile_id >= tiles.size()) {
+    throw std::out_of_range("Replay refers to a tile that does not exist.");
+  }
+
+  // This has to match Board::addDice
+  TileState& tile = tiles[reinforcement.tile_id];
+  tile.num_dice = static_cast<std::uint8_t> (std::min<size_t>(
+    tile.num_dice + reinforcement.num_dice
+    , Tile::MAX_DICE_PER_TILE));
+}
+
+
+bool ReplayReader::readIndex()
+{
+  const std::uint8_t* end = data_ + size_;
+  if (static_cast<size_t> (end - pos_) < ReplayFormat::TRAILER_SIZE) {
+    return false;
+  }
+
+  const std::uint8_t* trailer = end - ReplayFormat::TRAILER_SIZE;
+  if (std::memcmp(trailer + 8, ReplayFormat::INDEX_MAGIC, 4) != 0) {
+    return false;
+  }
+
+  std::uint64_t index_offset = 0;
+  for (size_t byte = 0; byte < 8; ++byte)
+  {
+    index_offset |= static_cast<std::uint64_t> (trailer[byte]) << (byte * 8);
+  }
+
+  size_t records_offset = pos_ - data_;
+  if (index_offset < records_offset || index_offset >= size_) {
+    return false;
+  }
+
+  const std::uint8_t* pos = data_ + index_offset;
+  if (*pos++ != static_cast<std::uint8_t> (ReplayFormat::Record::END)) {
+    return false;
+  }
+
+  std::uint64_t num_turns, num_keyframes;
+  if (!ReplayFormat::readVarint(pos, trailer, num_turns)
+      || !ReplayFormat::readVarint(pos, trailer, num_keyframes)) {
+    return false;
+  }
+
+  std::uint64_t turn = 0, offset = 0;
+  for (std::uint64_t i = 0; i < num_keyframes; ++i)
+  {
+    std::uint64_t turn_delta, offset_delta;
+    if (!ReplayFormat::readVarint(pos, trailer, turn_delta)
+        || !ReplayFormat::readVarint(pos, trailer, offset_delta)) {
+      keyframes_.clear();
+      return false;
+    }
+
+    turn += turn_delta;
+    offset += offset_delta;
+    if (offset < records_offset || offset >= index_offset) {
+      keyframes_.clear();
+      return false;
+    }
+
+    keyframes_.push_back(std::make_pair(turn, offset));
+  }
+
+  num_turns_ = num_turns;
+  records_end_ = data_ + index_offset;
+  return true;
+}
+
+
+void ReplayReader::scan()
+{
+  const std::uint8_t* pos = pos_;
+
+  // Only count what was written before the last complete turn or keyframe
+  const std::uint8_t* complete = pos;
+  size_t turn = 0;
+
+  Event event;
+  while (pos < records_end_)
+  {
+    const std::uint8_t* start = pos;
+    std::uint8_t kind = *pos++;
+
+    if (kind == static_cast<std::uint8_t> (ReplayFormat::Record::KEYFRAME)) {
+      size_t keyframe_turn;
+      if (!readKeyframe(pos, keyframe_turn, nullptr)) { break; }
+
+      keyframes_.push_back(std::make_pair(turn, start - data_));
+      complete = pos;
+      continue;
+    }
+
+    if (!readEvent(kind, pos, event)) { break; }
+    if (event.type == Event::Type::END_TURN) {
+      ++turn;
+      complete = pos;
+    }
+  }
+
+  num_turns_ = turn;
+  records_end_ = complete;
+}
+
+
+bool ReplayReader::readKeyframe(
+  const std::uint8_t*& pos
+  , size_t& turn
+  , std::vector<TileState>* tiles)
+{
+  std::uint64_t keyframe_turn, num_tiles;
+  if (!ReplayFormat::readVarint(pos, records_end_, keyframe_turn)
+      || !ReplayFormat::readVarint(pos, records_end_, num_tiles)) {
+    return false;
+  }
+
+  // Each tile is an owner byte and a dice byte
+  if (static_cast<std::uint64_t> (records_end_ - pos) < num_tiles * 2) {
+    return false;
+  }
+
+  if (tiles) {
+    tiles->resize(num_tiles);
+    for (TileState& tile : *tiles)
+    {
+      tile.owner = pos[0];
+      tile.num_dice = pos[1];
+      pos += 2;
+    }
+  }
+  else {
+    pos += num_tiles * 2;
+  }
+
+  turn = keyframe_turn;
+  return true;
+}
+
+
+bool ReplayReader::readEvent(
+  std::uint8_t kind
+  , const std::uint8_t*& pos
+  , Event& event)
+{
+  switch (static_cast<ReplayFormat::Record> (kind))
+  {
+    case ReplayFormat::Record::END_TURN:
+      event.type = Event::Type::END_TURN;
+      return true;
+
+    case ReplayFormat::Record::FIGHT:
+      {
+        std::uint64_t fields[4];
+        for (std::uint64_t& field : fields)
+        {
+          if (!ReplayFormat::readVarint(pos, records_end_, field)) {
+            return false;
+          }
+        }
+
+        event.type = Event::Type::FIGHT;
+        event.attacker_id = fields[0];
+        event.defender_id = fields[1];
+        event.attacker_total = fields[2];
+        event.defender_total = fields[3];
+        return true;
+      }
+
+    case ReplayFormat::Record::REINFORCE:
+      {
+        std::uint64_t tile_id, num_dice;
+        if (!ReplayFormat::readVarint(pos, records_end_, tile_id)
+            || !ReplayFormat::readVarint(pos, records_end_, num_dice)) {
+          return false;
+        }
+
+        event.type = Event::Type::REINFORCE;
+        event.tile_id = tile_id;
+        event.num_dice = num_dice;
+        return true;
+      }
+
+    default:
+      return false;
+  }
+}
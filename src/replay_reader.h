@@ -0,0 +1,204 @@
+#ifndef REPLAY_READER_H
+#define REPLAY_READER_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "board.h"
+#include "frame.h"
+#include "mapped_file.h"
+
+/**
+ * Reads a replay written by ReplayWriter (see replay_format.h). Any turn can
+ * be reached by jumping to the keyframe before it and playing forward from
+ * there, so seeking never looks at more than one keyframe interval of moves.
+ * Replays that were never finished, such as when the game crashed, are read
+ * up to their last complete turn. The file is mapped rather than read, so
+ * only the pages a seek touches are ever loaded, however long the game was.
+ */
+class ReplayReader
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * One thing that happened during a game.
+     */
+    struct Event
+    {
+      enum class Type { FIGHT, REINFORCE, END_TURN } type;
+
+      // Only set for fights
+      size_t attacker_id, defender_id;
+      size_t attacker_total, defender_total;
+
+      // Only set for reinforcements
+      size_t tile_id, num_dice;
+    };
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {std::string} path The replay file.
+     */
+    explicit ReplayReader(const std::string& path);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    std::uint64_t getSeed() const { return seed_; }
+    Board::Generator getGenerator() const { return generator_; }
+    size_t getWidth() const { return width_; }
+    size_t getHeight() const { return height_; }
+    size_t getNumTiles() const { return num_tiles_; }
+
+    /**
+     * Returns how many tiles the board was asked to have, which it has to be
+     * generated with again to come out the same.
+     *
+     * @returns {size_t} The number of tiles asked for.
+     */
+    size_t getTargetNumTiles() const { return target_num_tiles_; }
+
+    /**
+     * Returns how many turns the replay holds.
+     *
+     * @returns {size_t} The number of complete turns.
+     */
+    size_t getNumTurns() const { return num_turns_; }
+
+    /**
+     * Returns the turn the next event belongs to.
+     *
+     * @returns {size_t} The current turn.
+     */
+    size_t getTurn() const { return turn_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Moves to the start of a turn.
+     *
+     * @param {size_t} turn The turn, no later than getNumTurns().
+     * @param {std::vector<TileState>&} tiles Where the state of every tile at
+     * the start of the turn is stored, indexed by id.
+     */
+    void seek(size_t turn, std::vector<TileState>& tiles);
+
+    /**
+     * Reads the next event.
+     *
+     * @param {Event&} event Where the event is stored.
+     * @returns {bool} False if there are no events left.
+     */
+    bool next(Event& event);
+
+    /**
+     * Changes the state of the tiles the same way a fight on the board would.
+     *
+     * @param {Event} fight The fight.
+     * @param {std::vector<TileState>&} tiles Every tile, indexed by id.
+     */
+    static void applyFight(const Event& fight, std::vector<TileState>& tiles);
+
+    /**
+     * Changes the state of the tiles the same way reinforcing the board
+     * would.
+     *
+     * @param {Event} reinforcement The dice given to a tile.
+     * @param {std::vector<TileState>&} tiles Every tile, indexed by id.
+     */
+    static void applyReinforcement(
+      const Event& reinforcement
+      , std::vector<TileState>& tiles);
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Builds the list of keyframes from the index at the end of the file.
+     *
+     * @returns {bool} False if the file has no usable index.
+     */
+    bool readIndex();
+
+    /**
+     * Builds the list of keyframes by going through every record, for
+     * replays without an index.
+     */
+    void scan();
+
+    /**
+     * Reads a keyframe record, starting after its kind.
+     *
+     * @param {const std::uint8_t*&} pos Where the record's fields start. Moved
+     * past the record.
+     * @param {size_t&} turn Where the keyframe's turn is stored.
+     * @param {std::vector<TileState>*} tiles Where the tiles are stored, or
+     * nullptr to skip them.
+     * @returns {bool} False if the record is incomplete.
+     */
+    bool readKeyframe(
+      const std::uint8_t*& pos
+      , size_t& turn
+      , std::vector<TileState>* tiles);
+
+    /**
+     * Reads a record of any kind other than a keyframe, starting after its
+     * kind.
+     *
+     * @param {std::uint8_t} kind The kind of record.
+     * @param {const std::uint8_t*&} pos Where the record's fields start. Moved
+     * past the record.
+     * @param {Event&} event Where the event is stored.
+     * @returns {bool} False if the record is incomplete or the end of the
+     * records.
+     */
+    bool readEvent(std::uint8_t kind, const std::uint8_t*& pos, Event& event);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    MappedFile file_;
+    const std::uint8_t* data_;
+    size_t size_;
+
+    // Where the records stop
+    const std::uint8_t* records_end_;
+
+    std::uint64_t seed_;
+    Board::Generator generator_;
+    size_t width_, height_;
+    size_t target_num_tiles_;
+    size_t keyframe_interval_;
+    size_t num_tiles_ = 0;
+    size_t num_turns_ = 0;
+
+    // The turn and file offset of each keyframe
+    std::vector<std::pair<size_t, std::uint64_t>> keyframes_;
+
+    const std::uint8_t* pos_;
+    size_t turn_ = 0;
+
+};
+
+#endif
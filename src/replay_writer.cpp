@@ -0,0 +1,146 @@
+#include <stdexcept>
+#include <string>
+#include "replay_writer.h"
+#include "replay_format.h"
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t ReplayWriter::DEFAULT_KEYFRAME_INTERVAL = 64;
+const size_t ReplayWriter::FLUSH_SIZE = 1 << 16;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+ReplayWriter::ReplayWriter(
+  const std::string& path
+  , std::uint64_t seed
+  , Board::Generator generator
+  , size_t width
+  , size_t height
+  , size_t num_tiles
+  , size_t keyframe_interval)
+  : out_(path, std::ios::out | std::ios::binary | std::ios::trunc)
+  , keyframe_interval_(keyframe_interval)
+{
+  if (!out_) {
+    throw std::runtime_error("Could not open replay file.");
+  }
+  if (keyframe_interval == 0) {
+    throw std::invalid_argument("Keyframes need at least one turn between.");
+  }
+
+  // Leave room for a keyframe of any sensible board to go in before flushing
+  buffer_.reserve(FLUSH_SIZE * 2);
+
+  buffer_.insert(
+    std::end(buffer_)
+    , std::begin(ReplayFormat::MAGIC)
+    , std::end(ReplayFormat::MAGIC));
+  buffer_.push_back(ReplayFormat::VERSION);
+  ReplayFormat::appendVarint(buffer_, seed);
+  ReplayFormat::appendVarint(buffer_, static_cast<std::uint64_t> (generator));
+  ReplayFormat::appendVarint(buffer_, width);
+  ReplayFormat::appendVarint(buffer_, height);
+  ReplayFormat::appendVarint(buffer_, num_tiles);
+  ReplayFormat::appendVarint(buffer_, keyframe_interval);
+}
+
+
+ReplayWriter::~ReplayWriter()
+{
+  std::uint64_t index_offset = flushed_ + buffer_.size();
+
+  buffer_.push_back(static_cast<std::uint8_t> (ReplayFormat::Record::END));
+  ReplayFormat::appendVarint(buffer_, turn_);
+  ReplayFormat::appendVarint(buffer_, keyframes_.size());
+
+  size_t last_turn = 0;
+  std::uint64_t last_offset = 0;
+  for (const std::pair<size_t, std::uint64_t>& keyframe : keyframes_)
+  {
+    ReplayFormat::appendVarint(buffer_, keyframe.first - last_turn);
+    ReplayFormat::appendVarint(buffer_, keyframe.second - last_offset);
+    last_turn = keyframe.first;
+    last_offset = keyframe.second;
+  }
+
+  for (size_t byte = 0; byte < 8; ++byte)
+  {
+    buffer_.push_back(static_cast<std::uint8_t> (index_offset >> (byte * 8)));
+  }
+  buffer_.insert(
+    std::end(buffer_)
+    , std::begin(ReplayFormat::INDEX_MAGIC)
+    , std::end(ReplayFormat::INDEX_MAGIC));
+
+  flush();
+}
+
+
+void ReplayWriter::recordKeyframe(const std::vector<TileState>& tiles)
+{
+  keyframes_.push_back(std::make_pair(turn_, flushed_ + buffer_.size()));
+  keyframe_written_ = true;
+
+  buffer_.push_back(static_cast<std::uint8_t> (ReplayFormat::Record::KEYFRAME));
+  ReplayFormat::appendVarint(buffer_, turn_);
+  ReplayFormat::appendVarint(buffer_, tiles.size());
+  for (const TileState& tile : tiles)
+  {
+    buffer_.push_back(tile.owner);
+    buffer_.push_back(tile.num_dice);
+  }
+
+  flushIfFull();
+}
+
+
+void ReplayWriter::recordFight(
+  size_t attacker_id
+  , size_t defender_id
+  , size_t attacker_total
+  , size_t defender_total)
+{
+  buffer_.push_back(static_cast<std::uint8_t> (ReplayFormat::Record::FIGHT));
+  ReplayFormat::appendVarint(buffer_, attacker_id);
+  ReplayFormat::appendVarint(buffer_, defender_id);
+  ReplayFormat::appendVarint(buffer_, attacker_total);
+  ReplayFormat::appendVarint(buffer_, defender_total);
+
+  flushIfFull();
+}
+
+
+void ReplayWriter::recordReinforcement(size_t tile_id, size_t num_dice)
+{
+  buffer_.push_back(
+    static_cast<std::uint8_t> (ReplayFormat::Record::REINFORCE));
+  ReplayFormat::appendVarint(buffer_, tile_id);
+  ReplayFormat::appendVarint(buffer_, num_dice);
+
+  flushIfFull();
+}
+
+
+void ReplayWriter::endTurn()
+{
+  buffer_.push_back(static_cast<std::uint8_t> (ReplayFormat::Record::END_TURN));
+  ++turn_;
+  keyframe_written_ = false;
+
+  flushIfFull();
+}
+
+
+void ReplayWriter::flush()
+{
+  out_.write(
+    reinterpret_cast<const char*> (buffer_.data())
+    , static_cast<std::streamsize> (buffer_.size()));
+  flushed_ += buffer_.size();
+  buffer_.clear();
+}
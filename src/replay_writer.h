@@ -0,0 +1,146 @@
+#ifndef REPLAY_WRITER_H
+#define REPLAY_WRITER_H
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "board.h"
+#include "frame.h"
+
+/**
+ * Writes a game to a compact replay file as it is played (see
+ * replay_format.h). Records are appended to a memory buffer and only written
+ * out in large blocks, so recording a move costs a handful of byte stores.
+ * The index that lets readers seek is written when the writer is destroyed.
+ */
+class ReplayWriter
+{
+
+  public:
+
+    /******************************
+     * CONSTRUCTORS & DESTRUCTORS *
+     ******************************/
+
+    /**
+     * @param {std::string} path The file to write to. Overwritten.
+     * @param {std::uint64_t} seed The seed the board was generated from.
+     * @param {Board::Generator} generator What generated the board.
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {size_t} num_tiles How many tiles the board was asked to have.
+     * @param {size_t} keyframe_interval How many turns go between keyframes.
+     */
+    ReplayWriter(
+      const std::string& path
+      , std::uint64_t seed
+      , Board::Generator generator
+      , size_t width
+      , size_t height
+      , size_t num_tiles
+      , size_t keyframe_interval = DEFAULT_KEYFRAME_INTERVAL);
+
+    ~ReplayWriter();
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Returns whether the turn about to start needs a keyframe. If so,
+     * recordKeyframe should be called before anything else is recorded.
+     *
+     * @returns {bool} True if a keyframe is due.
+     */
+    bool needsKeyframe() const
+    {
+      return turn_ % keyframe_interval_ == 0 && !keyframe_written_;
+    }
+
+    /**
+     * Records the state of every tile at the start of the current turn.
+     *
+     * @param {std::vector<TileState>} tiles Every tile, indexed by id.
+     */
+    void recordKeyframe(const std::vector<TileState>& tiles);
+
+    /**
+     * Records a fight in the current turn.
+     *
+     * @param {size_t} attacker_id The attacking tile's id.
+     * @param {size_t} defender_id The defending tile's id.
+     * @param {size_t} attacker_total The sum of the attacker's dice.
+     * @param {size_t} defender_total The sum of the defender's dice.
+     */
+    void recordFight(
+      size_t attacker_id
+      , size_t defender_id
+      , size_t attacker_total
+      , size_t defender_total);
+
+    /**
+     * Records dice given to a tile at the end of the current turn.
+     *
+     * @param {size_t} tile_id The tile's id.
+     * @param {size_t} num_dice How many dice it was given.
+     */
+    void recordReinforcement(size_t tile_id, size_t num_dice);
+
+    /**
+     * Records that the current player's turn is over.
+     */
+    void endTurn();
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const size_t DEFAULT_KEYFRAME_INTERVAL;
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Writes the buffer out to the file once it is nearly full.
+     */
+    void flushIfFull()
+    {
+      if (buffer_.size() >= FLUSH_SIZE) { flush(); }
+    }
+
+    /**
+     * Writes out and empties the buffer.
+     */
+    void flush();
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const size_t FLUSH_SIZE;
+
+    std::ofstream out_;
+    std::vector<std::uint8_t> buffer_;
+
+    // How much was written out before the start of the buffer
+    std::uint64_t flushed_ = 0;
+
+    size_t keyframe_interval_;
+    size_t turn_ = 0;
+    bool keyframe_written_ = false;
+
+    // The turn and file offset of each keyframe
+    std::vector<std::pair<size_t, std::uint64_t>> keyframes_;
+
+};
+
+#endif
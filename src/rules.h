@@ -0,0 +1,125 @@
+#ifndef RULES_H
+#define RULES_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * The numbers a variant of the game is played with. Code that depends on
+ * them takes the variant as a template parameter, so each variant gets its
+ * own copy with the numbers as constants: dice rolls divide by a constant,
+ * tables have a fixed size, and a set of players fits in the smallest word
+ * that holds it.
+ *
+ * @param {unsigned} SIDES How many sides each die has.
+ * @param {unsigned} MAX_DICE The most dice a tile can hold.
+ * @param {unsigned} MAX_PLAYERS The most players in a game.
+ */
+template <unsigned SIDES, unsigned MAX_DICE, unsigned MAX_PLAYERS>
+struct Rules
+{
+  static_assert(SIDES >= 2, "A die needs at least two sides.");
+  static_assert(MAX_DICE >= 2, "A tile has to be able to attack.");
+  static_assert(
+    MAX_PLAYERS >= 2 && MAX_PLAYERS <= 64
+    , "There have to be between 2 and 64 players.");
+
+  /*********
+   * TYPES *
+   *********/
+
+  /**
+   * Has a bit for each player, such as for who is still in the game.
+   */
+  using player_mask_t =
+    typename std::conditional<MAX_PLAYERS <= 8, std::uint8_t,
+    typename std::conditional<MAX_PLAYERS <= 16, std::uint16_t,
+    typename std::conditional<MAX_PLAYERS <= 32, std::uint32_t,
+    std::uint64_t>::type>::type>::type;
+
+
+  /**************
+   * PROPERTIES *
+   **************/
+
+  static constexpr unsigned NUM_SIDES = SIDES;
+  static constexpr unsigned MAX_DICE_PER_TILE = MAX_DICE;
+  static constexpr unsigned MAX_NUM_PLAYERS = MAX_PLAYERS;
+
+  // The highest a tile can roll
+  static constexpr unsigned MAX_TOTAL = SIDES * MAX_DICE;
+
+  // The most dice a player can bank when their tiles have no room for them,
+  // as many as eight full tiles hold
+  static constexpr unsigned MAX_BANKED_DICE = 8 * MAX_DICE;
+
+
+  /***********
+   * METHODS *
+   ***********/
+
+  /**
+   * Rolls some dice.
+   *
+   * @param {Generator&} rng Rolls the dice. One number is drawn per die.
+   * @param {size_t} num_dice How many dice to roll.
+   * @returns {size_t} Their total.
+   */
+  template <typename Generator>
+  static size_t roll(Generator& rng, size_t num_dice)
+  {
+    size_t total = 0;
+    for (size_t i = 0; i < num_dice; ++i)
+    {
+      total += (rng() % SIDES) + 1;
+    }
+
+    return total;
+  }
+
+};
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+template <unsigned SIDES, unsigned MAX_DICE, unsigned MAX_PLAYERS>
+constexpr unsigned Rules<SIDES, MAX_DICE, MAX_PLAYERS>::NUM_SIDES;
+template <unsigned SIDES, unsigned MAX_DICE, unsigned MAX_PLAYERS>
+constexpr unsigned Rules<SIDES, MAX_DICE, MAX_PLAYERS>::MAX_DICE_PER_TILE;
+template <unsigned SIDES, unsigned MAX_DICE, unsigned MAX_PLAYERS>
+constexpr unsigned Rules<SIDES, MAX_DICE, MAX_PLAYERS>::MAX_NUM_PLAYERS;
+template <unsigned SIDES, unsigned MAX_DICE, unsigned MAX_PLAYERS>
+constexpr unsigned Rules<SIDES, MAX_DICE, MAX_PLAYERS>::MAX_TOTAL;
+template <unsigned SIDES, unsigned MAX_DICE, unsigned MAX_PLAYERS>
+constexpr unsigned Rules<SIDES, MAX_DICE, MAX_PLAYERS>::MAX_BANKED_DICE;
+
+
+/************
+ * VARIANTS *
+ ************/
+
+// Six-sided dice, up to eight on a tile, up to eight players
+using ClassicRules = Rules<6, 8, 8>;
+
+// Six-sided dice, up to sixteen on a tile, up to sixteen players
+using LargeRules = Rules<6, 16, 16>;
+
+// The classic dice, for battles of up to 64 players on large maps
+using BattleRoyaleRules = Rules<6, 8, 64>;
+
+// The variant the game itself is played with
+using GameRules = BattleRoyaleRules;
+
+#endif
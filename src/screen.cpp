@@ -0,0 +1,194 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include "screen.h"
+#include "display.h"
+#include "tile_grid.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const ScreenCell Screen::BLANK = { ' ', ColorPair::DEFAULT };
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Screen::Screen(size_t width, size_t height)
+  : width_(width)
+  , height_(height)
+  , cells_(width * height, BLANK)
+{ }
+
+
+void Screen::resize(size_t width, size_t height)
+{
+  width_ = width;
+  height_ = height;
+  cells_.assign(width * height, BLANK);
+  composed_ = false;
+}
+
+
+void Screen::compose(const Frame& frame, bool blink_on)
+{
+  changed_first_ = changed_last_ = 0;
+  if (height_ == 0) { return; }
+
+  size_t left, top;
+
+  // Nothing but the message changed, so leave the board alone
+  if (composed_ && frame.board_version == composed_version_
+      && blink_on == composed_blink_on_) {
+    getViewportOrigin(view_, width_, height_, left, top);
+
+    size_t msg_row = top + view_.getHeight();
+    if (msg_row < height_) {
+      composeMessage(frame.message, msg_row);
+      changed_first_ = msg_row;
+      changed_last_ = msg_row + 1;
+    }
+    return;
+  }
+
+  composed_ = true;
+  composed_version_ = frame.board_version;
+  composed_blink_on_ = blink_on;
+  changed_first_ = 0;
+  changed_last_ = height_;
+
+  std::fill(std::begin(cells_), std::end(cells_), BLANK);
+
+  view_ = frame.viewport;
+  view_.resize(width_, height_ - 1);
+  getViewportOrigin(view_, width_, height_, left, top);
+
+  size_t view_width = view_.getWidth();
+  size_t view_height = view_.getHeight();
+
+  // Draw each visible space one by one
+  if (frame.grid) {
+    const TileGrid& grid = *frame.grid;
+    size_t zoom = view_.getZoom();
+
+    // Columns past the right edge of the map show nothing
+    size_t map_cols = view_.getMapWidth() - view_.getX();
+    view_width = std::min(view_width, (map_cols + zoom - 1) / zoom);
+
+    for (size_t row = 0; row < view_height; ++row)
+    {
+      Tile::coord_t row_start;
+      if (!view_.screenToMap(0, row, row_start)) { continue; }
+
+      ScreenCell* cell = &cells_[(top + row) * width_ + left];
+      for (size_t col = 0; col < view_width; ++col, ++cell)
+      {
+        Tile::coord_t coord = row_start + col * zoom;
+        TileGrid::tile_id_t id =
+          (zoom == 1) ? grid.at(coord) : grid.sampleBlock(coord, zoom);
+        if (id == TileGrid::NO_TILE || id >= frame.tiles.size()) { continue; }
+
+        // This is okay because we will never have double-digits numbers
+        const TileState& state = frame.tiles[id];
+        cell->character = static_cast<char> ('0' + state.num_dice);
+        cell->pair = (blink_on && id == frame.blinking)
+          ? ColorPair::WHITE_BLACK
+          : Display::getOwnerColorPair(state.owner);
+      }
+    }
+  }
+
+  // Message bar goes directly below the board
+  size_t msg_row = top + view_height;
+  if (msg_row < height_) {
+    composeMessage(frame.message, msg_row);
+  }
+}
+
+
+void Screen::composeOverlay(const std::vector<std::string>& lines)
+{
+  size_t box_width = 0;
+  for (const std::string& line : lines)
+  {
+    box_width = std::max(box_width, line.length() + 2);
+  }
+  box_width = std::min(box_width, width_);
+
+  size_t num_rows = std::min(lines.size(), height_);
+  for (size_t row = 0; row < num_rows; ++row)
+  {
+    ScreenCell* start = &cells_[row * width_];
+    for (size_t col = 0; col < box_width; ++col)
+    {
+      start[col].character = (col > 0 && col <= lines[row].length())
+        ? lines[row][col - 1]
+        : ' ';
+      start[col].pair = ColorPair::WHITE_BLACK;
+    }
+  }
+
+  // The box starts at the top, so everything down to its bottom may differ
+  if (num_rows > 0) {
+    changed_first_ = 0;
+    changed_last_ = std::max(changed_last_, num_rows);
+  }
+}
+
+
+void Screen::copyRows(const Screen& other, size_t first, size_t last)
+{
+  std::copy(
+    std::begin(other.cells_) + first * width_
+    , std::begin(other.cells_) + last * width_
+    , std::begin(cells_) + first * width_);
+}
+
+
+bool Screen::screenToBoard(size_t x, size_t y, Tile::coord_t& coord) const
+{
+  size_t left, top;
+  getViewportOrigin(view_, width_, height_, left, top);
+
+  if (x < left || y < top) { return false; }
+  if (x - left >= view_.getWidth() || y - top >= view_.getHeight()) {
+    return false;
+  }
+
+  return view_.screenToMap(x - left, y - top, coord);
+}
+
+
+void Screen::getViewportOrigin(
+  const Viewport& view
+  , size_t width
+  , size_t height
+  , size_t& left
+  , size_t& top)
+{
+  size_t board_height = height > 0 ? height - 1 : 0;
+
+  // Leave a row below the board for the message bar
+  left = (width - std::min(width, view.getWidth())) / 2;
+  top = (board_height - std::min(board_height, view.getHeight())) / 2;
+}
+
+
+void Screen::composeMessage(const std::string& message, size_t row)
+{
+  ScreenCell* start = &cells_[row * width_];
+  std::fill(start, start + width_, BLANK);
+
+  size_t msg_len = std::min(message.length(), width_);
+  size_t msg_col = (width_ - msg_len) / 2;
+  for (size_t i = 0; i < msg_len; ++i)
+  {
+    start[msg_col + i].character = message[i];
+  }
+}
@@ -0,0 +1,206 @@
+#ifndef SCREEN_H
+#define SCREEN_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "color.h"
+#include "frame.h"
+#include "viewport.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * One character on the screen.
+ */
+struct ScreenCell
+{
+  char character;
+  ColorPair pair;
+
+  bool operator==(const ScreenCell& other) const
+  {
+    return character == other.character && pair == other.pair;
+  }
+
+  bool operator!=(const ScreenCell& other) const { return !(*this == other); }
+};
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * What a terminal should show for a frame, independent of how it gets there.
+ * Backends compare two screens and only output the cells that differ.
+ */
+class Screen
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    Screen(size_t width = 0, size_t height = 0);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    size_t getWidth() const { return width_; }
+    size_t getHeight() const { return height_; }
+
+    /**
+     * Returns what is at a position on the screen.
+     *
+     * @param {size_t} col The column.
+     * @param {size_t} row The row.
+     * @returns {const ScreenCell&} The character there.
+     */
+    const ScreenCell& at(size_t col, size_t row) const
+    {
+      return cells_[row * width_ + col];
+    }
+
+    /**
+     * Returns the viewport used for the last composed frame, fit to this
+     * screen.
+     *
+     * @returns {const Viewport&} The viewport.
+     */
+    const Viewport& getView() const { return view_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Changes the size of the screen and blanks it.
+     *
+     * @param {size_t} width The new width in characters.
+     * @param {size_t} height The new height in characters.
+     */
+    void resize(size_t width, size_t height);
+
+    /**
+     * Fills the screen with the visible part of a frame. Only spaces inside the
+     * viewport are looked at, so the cost depends on the size of the screen
+     * rather than the size of the board. If only the message changed since the
+     * last frame, only the message bar is redrawn.
+     *
+     * @param {Frame} frame The frame to draw.
+     * @param {bool} blink_on Whether the blinking tile is highlighted.
+     */
+    void compose(const Frame& frame, bool blink_on);
+
+    /**
+     * Draws lines of text in a box in the upper left-hand corner, over
+     * whatever was composed, and counts their rows as changed.
+     *
+     * @param {std::vector<std::string>} lines The text.
+     */
+    void composeOverlay(const std::vector<std::string>& lines);
+
+    /**
+     * Returns the rows the last call to compose may have changed. Rows outside
+     * of these are the same as they were before it.
+     *
+     * @param {size_t&} first Where the first changed row is stored.
+     * @param {size_t&} last Where the row after the last changed one is stored.
+     */
+    void getChangedRows(size_t& first, size_t& last) const
+    {
+      first = changed_first_;
+      last = changed_last_;
+    }
+
+    /**
+     * Copies the given rows from another screen of the same size.
+     *
+     * @param {Screen} other The screen to copy from.
+     * @param {size_t} first The first row to copy.
+     * @param {size_t} last The row after the last one to copy.
+     */
+    void copyRows(const Screen& other, size_t first, size_t last);
+
+    /**
+     * Turns a position on the screen into a position on the board, as of the
+     * last composed frame.
+     *
+     * @param {size_t} x The screen column.
+     * @param {size_t} y The screen row.
+     * @param {Tile::coord_t&} coord Where the board coordinate is stored.
+     * @returns {bool} False if the position is not on the board.
+     */
+    bool screenToBoard(size_t x, size_t y, Tile::coord_t& coord) const;
+
+    /**
+     * Finds where the upper left-hand corner of a viewport goes, centered on a
+     * screen of the given size with a row left below it for the message bar.
+     *
+     * @param {Viewport} view The viewport, fit to the screen.
+     * @param {size_t} width The width of the screen.
+     * @param {size_t} height The height of the screen.
+     * @param {size_t&} left Where the column is stored.
+     * @param {size_t&} top Where the row is stored.
+     */
+    static void getViewportOrigin(
+      const Viewport& view
+      , size_t width
+      , size_t height
+      , size_t& left
+      , size_t& top);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const ScreenCell BLANK;
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Draws the message bar on the given row, blanking the rest of it.
+     *
+     * @param {std::string} message The message.
+     * @param {size_t} row The row of the message bar.
+     */
+    void composeMessage(const std::string& message, size_t row);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    size_t width_, height_;
+    std::vector<ScreenCell> cells_;
+    Viewport view_;
+
+    // What the board part of the screen currently shows
+    bool composed_ = false;
+    std::uint64_t composed_version_ = 0;
+    bool composed_blink_on_ = false;
+
+    size_t changed_first_ = 0, changed_last_ = 0;
+
+};
+
+#endif
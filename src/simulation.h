@@ -0,0 +1,209 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+#include "board.h"
+#include "tile.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Plays a game between AIs for batch work, such as measuring how strong they
+ * are, the same way DiceFeud::play does: players take turns in order until
+ * only one is left, each turn ends with the board reinforcing the player, and
+ * a player is out once they have nowhere to attack from.
+ *
+ * The kinds of AI it can hold are fixed when it is compiled, such as the
+ * Policy of each Player class, and each kind is kept in an array of its own.
+ * Turns are taken from one flat array of seats, and each is dispatched on its
+ * kind with a comparison rather than a virtual call, so every kind's turn can
+ * be inlined.
+ *
+ * @param {AIs...} AIs The kinds of AI, each with a constructor taking a
+ * Tile::owner_t and bool takeTurn(std::mt19937&, Board&).
+ */
+template <typename... AIs>
+class Simulation
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {Board&} board The board, dealt out already. It must outlive the
+     * simulation.
+     */
+    explicit Simulation(Board& board) : board_(board) { }
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    size_t getTurn() const { return turn_; }
+    size_t getNumPlayersLeft() const { return seats_.size(); }
+
+    /**
+     * Returns who won, once only one player is left.
+     *
+     * @returns {int} The winner's id, or -1 if the game is not over.
+     */
+    int getWinner() const
+    {
+      if (seats_.size() != 1) { return -1; }
+
+      return seats_.front().id;
+    }
+
+
+    /*** SETTERS ***/
+
+    /**
+     * Adds a player to the end of the turn order.
+     *
+     * @param {size_t} KIND Which of the AIs plays, as its index.
+     * @param {Tile::owner_t} id The id of the player it plays for.
+     */
+    template <size_t KIND>
+    void addPlayer(Tile::owner_t id)
+    {
+      static_assert(KIND < sizeof...(AIs), "There is no AI of that kind.");
+
+      auto& players = std::get<KIND>(players_);
+      Seat seat = { static_cast<std::uint8_t> (KIND), id, players.size() };
+      players.emplace_back(id);
+      seats_.push_back(seat);
+
+      // So that the end of the game is played out in the same order
+      std::vector<Tile::owner_t> ids;
+      for (const Seat& other : seats_)
+      {
+        ids.push_back(other.id);
+      }
+      board_.setTurnOrder(ids);
+    }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Plays one turn.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @returns {bool} False if the game was already over.
+     */
+    bool step(std::mt19937& rng)
+    {
+      if (seats_.size() < 2) { return false; }
+
+      if (takeTurn(rng, seats_[next_], Kind<0>())) {
+        board_.reinforce(rng, seats_[next_].id);
+        next_ = (next_ + 1) % seats_.size();
+      }
+      else {
+        // Out of the game, so whoever was after them goes next
+        seats_.erase(std::begin(seats_) + next_);
+        if (next_ == seats_.size()) { next_ = 0; }
+      }
+      ++turn_;
+
+      return true;
+    }
+
+    /**
+     * Plays until one player is left or the turn limit is reached.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {size_t} turn_limit The most turns the game may have had in
+     * all, or 0 for no limit.
+     * @returns {int} The winner's id, or -1 if nobody won.
+     */
+    int play(std::mt19937& rng, size_t turn_limit)
+    {
+      while ((turn_limit == 0 || turn_ < turn_limit) && step(rng)) { }
+
+      return getWinner();
+    }
+
+
+  private:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * A place in the turn order.
+     */
+    struct Seat
+    {
+      std::uint8_t kind;
+      Tile::owner_t id;
+
+      // Where the player is in the array of their kind
+      size_t index;
+    };
+
+    template <size_t KIND>
+    using Kind = std::integral_constant<size_t, KIND>;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Lets a player take their turn, trying each kind from KIND on.
+     *
+     * @param {std::mt19937&} rng Used for randomness.
+     * @param {Seat} seat The player.
+     * @returns {bool} False if the player has lost the game.
+     */
+    template <size_t KIND>
+    bool takeTurn(std::mt19937& rng, const Seat& seat, Kind<KIND>)
+    {
+      if (seat.kind == KIND) {
+        return std::get<KIND>(players_)[seat.index].takeTurn(rng, board_);
+      }
+
+      return takeTurn(rng, seat, Kind<KIND + 1>());
+    }
+
+    bool takeTurn(std::mt19937&, const Seat&, Kind<sizeof...(AIs)>)
+    {
+      throw std::logic_error("Seat has no kind of AI.");
+    }
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    Board& board_;
+    std::tuple<std::vector<AIs>...> players_;
+
+    // Everybody still playing, in turn order
+    std::vector<Seat> seats_;
+    size_t next_ = 0;
+    size_t turn_ = 0;
+
+};
+
+#endif
@@ -0,0 +1,262 @@
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "snapshot.h"
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Rounds a file offset up to the next 8-byte boundary.
+ *
+ * @param {std::uint64_t} offset The offset.
+ * @returns {std::uint64_t} The aligned offset.
+ */
+inline std::uint64_t align_offset(std::uint64_t offset);
+
+/**
+ * Checks that a section lies entirely inside a file.
+ *
+ * @param {std::uint64_t} offset Where the section starts.
+ * @param {std::uint64_t} size How long the section is.
+ * @param {std::uint64_t} file_size How long the file is.
+ * @returns {bool} True if the section fits.
+ */
+inline bool section_fits(
+  std::uint64_t offset
+  , std::uint64_t size
+  , std::uint64_t file_size);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const char Snapshot::MAGIC[8] = { 'D', 'F', 'S', 'N', 'A', 'P', 0, 0 };
+const std::uint32_t Snapshot::VERSION = 3;
+const std::uint32_t Snapshot::BYTE_ORDER_MARK = 0x01020304;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Snapshot::Snapshot(const std::string& path)
+  : file_(std::make_shared<MappedFile>(path))
+{
+  const unsigned char* data = file_->getData();
+  std::uint64_t size = file_->getSize();
+
+  if (size < sizeof(SnapshotHeader)
+      || std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0) {
+    throw std::runtime_error("Not a saved game.");
+  }
+
+  header_ = reinterpret_cast<const SnapshotHeader*> (data);
+
+  if (header_->version != VERSION) {
+    throw std::runtime_error("Saved game is from another version.");
+  }
+  if (header_->byte_order != BYTE_ORDER_MARK) {
+    throw std::runtime_error("Saved game is from an incompatible machine.");
+  }
+
+  std::uint64_t num_spaces =
+    static_cast<std::uint64_t> (header_->width) * header_->height;
+
+  bool valid = header_->file_size == size
+    && header_->num_tiles > 0
+    && header_->num_tiles < TileGrid::NO_TILE
+    && header_->grid_offset % alignof(TileGrid::tile_id_t) == 0
+    && section_fits(
+      header_->grid_offset
+      , num_spaces * sizeof(TileGrid::tile_id_t)
+      , size)
+    && section_fits(header_->tiles_offset, header_->num_tiles * 2, size)
+    && section_fits(header_->players_offset, header_->num_players * 3, size)
+    && section_fits(header_->rng_offset, header_->rng_size, size);
+
+  if (!valid) {
+    throw std::runtime_error("Saved game is damaged.");
+  }
+}
+
+
+std::shared_ptr<const TileGrid> Snapshot::getGrid() const
+{
+  const TileGrid::tile_id_t* cells =
+    reinterpret_cast<const TileGrid::tile_id_t*> (
+      file_->getData() + header_->grid_offset);
+
+  return std::make_shared<TileGrid>(
+    header_->width
+    , header_->height
+    , cells
+    , file_);
+}
+
+
+std::vector<TileState> Snapshot::getTileStates() const
+{
+  const unsigned char* tiles = file_->getData() + header_->tiles_offset;
+
+  std::vector<TileState> states (header_->num_tiles);
+  for (TileState& state : states)
+  {
+    state.owner = tiles[0];
+    state.num_dice = tiles[1];
+    tiles += 2;
+  }
+
+  return states;
+}
+
+
+void Snapshot::getPlayers(std::vector<PlayerEntry>& players) const
+{
+  const unsigned char* entries = file_->getData() + header_->players_offset;
+
+  players.resize(header_->num_players);
+  for (PlayerEntry& player : players)
+  {
+    player.id = entries[0];
+    player.kind = static_cast<PlayerKind> (entries[1]);
+    player.banked_dice = entries[2];
+    entries += 3;
+  }
+}
+
+
+void Snapshot::loadRng(std::mt19937& rng) const
+{
+  const char* text =
+    reinterpret_cast<const char*> (file_->getData() + header_->rng_offset);
+
+  std::istringstream in(std::string(text, header_->rng_size));
+  in >> rng;
+
+  if (!in) {
+    throw std::runtime_error("Saved game is damaged.");
+  }
+}
+
+
+void Snapshot::write(
+  const std::string& path
+  , const TileGrid& grid
+  , const std::vector<TileState>& states
+  , const std::vector<PlayerEntry>& players
+  , size_t turn
+  , size_t turn_limit
+  , const std::mt19937& rng)
+{
+  std::ostringstream rng_text;
+  rng_text << rng;
+  std::string rng_state = rng_text.str();
+
+  size_t num_spaces = grid.getWidth() * grid.getHeight();
+
+  SnapshotHeader header;
+  std::memset(&header, 0, sizeof(header));
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = VERSION;
+  header.byte_order = BYTE_ORDER_MARK;
+  header.width = static_cast<std::uint32_t> (grid.getWidth());
+  header.height = static_cast<std::uint32_t> (grid.getHeight());
+  header.num_tiles = static_cast<std::uint32_t> (states.size());
+  header.num_players = static_cast<std::uint32_t> (players.size());
+  header.turn = turn;
+  header.turn_limit = turn_limit;
+
+  header.grid_offset = align_offset(sizeof(header));
+  header.tiles_offset = align_offset(
+    header.grid_offset + num_spaces * sizeof(TileGrid::tile_id_t));
+  header.players_offset =
+    align_offset(header.tiles_offset + states.size() * 2);
+  header.rng_offset =
+    align_offset(header.players_offset + players.size() * 3);
+  header.rng_size = rng_state.size();
+  header.file_size = header.rng_offset + header.rng_size;
+
+  // Build the whole file in memory so it goes out in one write
+  std::vector<char> out (header.file_size, 0);
+  std::memcpy(out.data(), &header, sizeof(header));
+  std::memcpy(
+    out.data() + header.grid_offset
+    , grid.getCells()
+    , num_spaces * sizeof(TileGrid::tile_id_t));
+
+  char* tiles = out.data() + header.tiles_offset;
+  for (const TileState& state : states)
+  {
+    *tiles++ = static_cast<char> (state.owner);
+    *tiles++ = static_cast<char> (state.num_dice);
+  }
+
+  char* entries = out.data() + header.players_offset;
+  for (const PlayerEntry& player : players)
+  {
+    *entries++ = static_cast<char> (player.id);
+    *entries++ = static_cast<char> (player.kind);
+    *entries++ = static_cast<char> (player.banked_dice);
+  }
+
+  std::memcpy(
+    out.data() + header.rng_offset
+    , rng_state.data()
+    , rng_state.size());
+
+  // A resumed game's grid is mapped from the file being replaced, so the new
+  // save goes to a file of its own and is renamed over the old one only once
+  // it is on disk. The mapping keeps the old file, and a crash while saving
+  // leaves the last save as it was.
+  std::string temp_path = path + ".tmp";
+  int fd = open(temp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0) {
+    throw std::runtime_error("Could not save the game.");
+  }
+
+  const char* pos = out.data();
+  size_t left = out.size();
+  while (left > 0)
+  {
+    ssize_t written = ::write(fd, pos, left);
+    if (written < 0 && errno == EINTR) { continue; }
+    if (written <= 0) { break; }
+
+    pos += written;
+    left -= static_cast<size_t> (written);
+  }
+
+  bool saved = left == 0 && fsync(fd) == 0;
+  saved = close(fd) == 0 && saved;
+  if (!saved || std::rename(temp_path.c_str(), path.c_str()) != 0) {
+    std::remove(temp_path.c_str());
+    throw std::runtime_error("Could not save the game.");
+  }
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+inline std::uint64_t align_offset(std::uint64_t offset)
+{
+  return (offset + 7) & ~static_cast<std::uint64_t> (7);
+}
+
+
+inline bool section_fits(
+  std::uint64_t offset
+  , std::uint64_t size
+  , std::uint64_t file_size)
+{
+  return offset <= file_size && size <= file_size - offset;
+}
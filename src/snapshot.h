@@ -0,0 +1,190 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include "frame.h"
+#include "mapped_file.h"
+#include "tile.h"
+#include "tile_grid.h"
+
+
+/*********
+ * TYPES *
+ *********/
+
+/**
+ * The start of a snapshot file. Every other section is found through the
+ * offsets in here and starts on an 8-byte boundary:
+ *   grid     width * height tile ids, row by row
+ *   tiles    the owner and dice of every tile, a byte each
+ *   players  the id, kind and banked dice of every player in turn order, a
+ *            byte each
+ *   rng      the state of the game's random number generator, as text
+ * Numbers are stored the way the machine that wrote them stores them; files
+ * from a machine with a different byte order are refused.
+ */
+struct SnapshotHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t byte_order;
+  std::uint64_t file_size;
+
+  std::uint32_t width, height;
+  std::uint32_t num_tiles, num_players;
+  std::uint64_t turn, turn_limit;
+
+  std::uint64_t grid_offset;
+  std::uint64_t tiles_offset;
+  std::uint64_t players_offset;
+  std::uint64_t rng_offset, rng_size;
+};
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * A saved game. Snapshots have a fixed layout that is used exactly as it sits
+ * in the file, which is mapped into memory rather than read, so loading one
+ * takes the same time no matter how big the board is. The same files work in
+ * the game and in batch tools.
+ */
+class Snapshot
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    enum class PlayerKind : std::uint8_t
+    {
+      HUMAN = 0
+      , AI_EASY
+      , AI_MEDIUM
+      , AI_HARD
+    };
+
+    /**
+     * One player, as stored in a snapshot.
+     */
+    struct PlayerEntry
+    {
+      Tile::owner_t id;
+      PlayerKind kind;
+
+      // Dice they won that none of their tiles had room for yet
+      std::uint8_t banked_dice;
+    };
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * Opens a snapshot.
+     *
+     * @param {std::string} path The snapshot file.
+     */
+    explicit Snapshot(const std::string& path);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    size_t getWidth() const { return header_->width; }
+    size_t getHeight() const { return header_->height; }
+    size_t getTurn() const { return header_->turn; }
+    size_t getTurnLimit() const { return header_->turn_limit; }
+
+    /**
+     * Returns which tile is where. The grid uses the file directly.
+     *
+     * @returns {std::shared_ptr<const TileGrid>} The grid.
+     */
+    std::shared_ptr<const TileGrid> getGrid() const;
+
+    /**
+     * Copies out the owner and dice of every tile.
+     *
+     * @returns {std::vector<TileState>} The states, indexed by tile id.
+     */
+    std::vector<TileState> getTileStates() const;
+
+    /**
+     * Copies out every player, in turn order.
+     *
+     * @param {std::vector<PlayerEntry>&} players Where the players are stored.
+     */
+    void getPlayers(std::vector<PlayerEntry>& players) const;
+
+    /**
+     * Puts a random number generator back into the state it was saved in.
+     *
+     * @param {std::mt19937&} rng The generator.
+     */
+    void loadRng(std::mt19937& rng) const;
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Saves a game.
+     *
+     * @param {std::string} path The file to save to. Replaced only once the
+     * new save is complete, so it may be mapped by a resumed game.
+     * @param {TileGrid} grid Which tile is where.
+     * @param {std::vector<TileState>} states The color and dice of every tile.
+     * @param {std::vector<PlayerEntry>} players Every player, in turn order.
+     * @param {size_t} turn How many turns have been played.
+     * @param {size_t} turn_limit The most turns the game may last, or 0.
+     * @param {std::mt19937} rng The game's random number generator.
+     */
+    static void write(
+      const std::string& path
+      , const TileGrid& grid
+      , const std::vector<TileState>& states
+      , const std::vector<PlayerEntry>& players
+      , size_t turn
+      , size_t turn_limit
+      , const std::mt19937& rng);
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const char MAGIC[8];
+    static const std::uint32_t VERSION;
+
+    // Written as a number, so it reads back differently in the wrong byte order
+    static const std::uint32_t BYTE_ORDER_MARK;
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    std::shared_ptr<const MappedFile> file_;
+    const SnapshotHeader* header_;
+
+};
+
+#endif
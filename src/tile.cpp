@@ -10,7 +10,8 @@
  * STATIC PROPERTY DEFINITIONS *
  *******************************/
 
-const size_t Tile::MAX_DICE_PER_TILE = 8;
+const size_t Tile::MAX_DICE_PER_TILE;
+const Tile::owner_t Tile::NO_OWNER;
 
 
 /*******************
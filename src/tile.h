@@ -13,8 +13,9 @@ class Tile;
  ************/
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
-#include "color.h"
+#include "rules.h"
 
 
 /*********
@@ -32,6 +33,10 @@ class Tile
 
     using coord_t = size_t;
 
+    // Compact player id, used wherever a tile's owner is stored. How owners
+    // look is up to the display.
+    using owner_t = std::uint8_t;
+
 
     /***********
      * METHODS *
@@ -40,11 +45,11 @@ class Tile
     /*** GETTERS ***/
 
     /**
-     * Gets the color of this tile
+     * Gets the player who owns this tile.
      *
-     * @returns {Color} The color of this tile.
+     * @returns {owner_t} The owner's id, or NO_OWNER.
      */
-    Color getColor() const { return color_; }
+    owner_t getOwner() const { return owner_; }
 
     /**
      * Gets the id of this tile.
@@ -71,14 +76,15 @@ class Tile
 
     /*** MUTATORS ***/
 
-    // Color
+    // Owner
 
     /**
-     * Sets the color of this tile to the specified color.
+     * Gives this tile to a player. Boards keep track of who owns what, so
+     * tiles on a board are given away through it.
      *
-     * @param {Color} c The color to set this tile to.
+     * @param {owner_t} owner The new owner's id, or NO_OWNER.
      */
-    void setColor(Color c) { color_ = c; }
+    void setOwner(owner_t owner) { owner_ = owner; }
 
     // Coordinates
 
@@ -103,7 +109,7 @@ class Tile
      * already at the max.
      */
     void incNumDice() {
-      num_dice_ = std::max(num_dice_ + 1, MAX_DICE_PER_TILE); }
+      num_dice_ = std::min(num_dice_ + 1, MAX_DICE_PER_TILE); }
 
     /**
      * Decrements the number of dice on the tile. Will do nothing if the tile is
@@ -123,7 +129,14 @@ class Tile
 
     /*** CONSTANTS ***/
 
-    static const size_t MAX_DICE_PER_TILE;
+    static const size_t MAX_DICE_PER_TILE = GameRules::MAX_DICE_PER_TILE;
+
+    // The owner of tiles that have not been dealt to anybody
+    static const owner_t NO_OWNER = 0xFF;
+
+    static_assert(
+      GameRules::MAX_NUM_PLAYERS < NO_OWNER
+      , "Every player and no player at all have to fit in an owner_t.");
 
 
   private:
@@ -134,7 +147,7 @@ class Tile
 
     /*** VARIABLES ***/
 
-    Color color_ = Color::BLUE;
+    owner_t owner_ = NO_OWNER;
     size_t id_ = 0;
     size_t num_dice_ = 0;
     std::vector<coord_t> coordinates_;
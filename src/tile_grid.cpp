@@ -0,0 +1,92 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include "tile_grid.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const TileGrid::tile_id_t TileGrid::NO_TILE = UINT16_MAX;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+TileGrid::TileGrid(size_t width, size_t height, std::vector<tile_id_t> cells)
+  : width_(width)
+  , height_(height)
+{
+  if (cells.size() != width * height) {
+    throw std::invalid_argument("Grid does not match its dimensions.");
+  }
+
+  std::shared_ptr<std::vector<tile_id_t>> owned =
+    std::make_shared<std::vector<tile_id_t>>(std::move(cells));
+  cells_ = owned->data();
+  owner_ = std::move(owned);
+}
+
+
+TileGrid::TileGrid(
+  size_t width
+  , size_t height
+  , const tile_id_t* cells
+  , std::shared_ptr<const void> owner)
+  : width_(width)
+  , height_(height)
+  , cells_(cells)
+  , owner_(std::move(owner))
+{ }
+
+
+TileGrid::tile_id_t TileGrid::sampleBlock(Tile::coord_t corner, size_t size)
+  const
+{
+  size_t corner_x = corner % width_;
+  size_t corner_y = corner / width_;
+  size_t samples = size < BLOCK_SAMPLES ? size : BLOCK_SAMPLES;
+
+  // Small enough to keep on the stack; ties go to the first one sampled.
+  std::array<tile_id_t, BLOCK_SAMPLES * BLOCK_SAMPLES> seen;
+  std::array<size_t, BLOCK_SAMPLES * BLOCK_SAMPLES> counts;
+  size_t num_seen = 0;
+  tile_id_t best = NO_TILE;
+  size_t best_count = 0;
+
+  for (size_t i = 0; i < samples; ++i)
+  {
+    size_t y = corner_y + (size * (2 * i + 1)) / (2 * samples);
+    if (y >= height_) { break; }
+
+    for (size_t j = 0; j < samples; ++j)
+    {
+      size_t x = corner_x + (size * (2 * j + 1)) / (2 * samples);
+      if (x >= width_) { break; }
+
+      tile_id_t tile = cells_[y * width_ + x];
+
+      size_t k = 0;
+      while (k < num_seen && seen[k] != tile) { ++k; }
+      if (k == num_seen) {
+        seen[num_seen] = tile;
+        counts[num_seen++] = 0;
+      }
+
+      if (++counts[k] > best_count) {
+        best_count = counts[k];
+        best = tile;
+      }
+    }
+  }
+
+  return best;
+}
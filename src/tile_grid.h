@@ -0,0 +1,129 @@
+#ifndef TILE_GRID_H
+#define TILE_GRID_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "tile.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Records which tile occupies each space of a board. It never changes once a
+ * board has been generated, so it can be shared freely between the board and
+ * anything drawing it.
+ */
+class TileGrid
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    // Compact tile id, used wherever ids are stored per space
+    using tile_id_t = std::uint16_t;
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {std::vector<tile_id_t>} cells The tile in each space, row by row,
+     * or NO_TILE for empty spaces.
+     */
+    TileGrid(size_t width, size_t height, std::vector<tile_id_t> cells);
+
+    /**
+     * Uses spaces that live somewhere else, such as in a mapped file, without
+     * copying them.
+     *
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {const tile_id_t*} cells The tile in each space, row by row.
+     * @param {std::shared_ptr<const void>} owner Keeps the spaces alive for as
+     * long as the grid is.
+     */
+    TileGrid(
+      size_t width
+      , size_t height
+      , const tile_id_t* cells
+      , std::shared_ptr<const void> owner);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    size_t getWidth() const { return width_; }
+    size_t getHeight() const { return height_; }
+
+    /**
+     * Returns the tile occupying a space.
+     *
+     * @param {Tile::coord_t} coord The space. Must be on the board.
+     * @returns {tile_id_t} The id of the tile, or NO_TILE.
+     */
+    tile_id_t at(Tile::coord_t coord) const { return cells_[coord]; }
+
+    /**
+     * Returns the raw space-to-tile mapping, row by row.
+     *
+     * @returns {const tile_id_t*} The tile in each space.
+     */
+    const tile_id_t* getCells() const { return cells_; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Picks the tile that best represents a square block of spaces, for when
+     * the viewport is zoomed out. Only a fixed number of spaces in the block
+     * are sampled.
+     *
+     * @param {Tile::coord_t} corner The upper left-hand space of the block.
+     * @param {size_t} size The length of each side of the block.
+     * @returns {tile_id_t} The most common tile among the samples, or NO_TILE
+     * if the block is mostly empty.
+     */
+    tile_id_t sampleBlock(Tile::coord_t corner, size_t size) const;
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const tile_id_t NO_TILE;
+
+    // Number of spaces sampled along each side of a block when zoomed out
+    static const size_t BLOCK_SAMPLES = 3;
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    size_t width_, height_;
+    const tile_id_t* cells_;
+
+    // Whatever the spaces are stored in
+    std::shared_ptr<const void> owner_;
+
+};
+
+#endif
@@ -0,0 +1,142 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <iomanip>
+#include "trace.h"
+
+
+/******************************
+ * HELPER FUNCTION PROTOTYPES *
+ ******************************/
+
+/**
+ * Writes a time in the microseconds that the trace format uses.
+ *
+ * @param {std::ostream&} out Where to write.
+ * @param {std::uint64_t} ns The time, in nanoseconds.
+ */
+void write_microseconds(std::ostream& out, std::uint64_t ns);
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const size_t Trace::ThreadBuffer::CAPACITY;
+thread_local Trace::ThreadBuffer* Trace::thread_buffer_ = nullptr;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Trace& Trace::get()
+{
+  static Trace trace;
+
+  return trace;
+}
+
+
+std::uint64_t Trace::now()
+{
+  static const std::chrono::steady_clock::time_point EPOCH =
+    std::chrono::steady_clock::now();
+
+  std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - EPOCH;
+
+  return static_cast<std::uint64_t> (elapsed.count());
+}
+
+
+void Trace::nameThread(const char* name)
+{
+  getThreadBuffer().name = name;
+}
+
+
+void Trace::record(const char* name, std::uint64_t start, std::uint64_t end)
+{
+  ThreadBuffer& buffer = getThreadBuffer();
+
+  size_t size = buffer.size.load(std::memory_order_relaxed);
+  if (size == ThreadBuffer::CAPACITY) {
+    buffer.num_dropped.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  buffer.events[size] = { name, start, end - start };
+  buffer.size.store(size + 1, std::memory_order_release);
+}
+
+
+void Trace::writeJson(std::ostream& out) const
+{
+  std::lock_guard<std::mutex> lock (buffers_mutex_);
+
+  std::uint64_t num_dropped = 0;
+  bool first = true;
+  out << "{\"traceEvents\": [";
+
+  for (const std::unique_ptr<ThreadBuffer>& buffer : buffers_)
+  {
+    const char* thread_name = buffer->name.load();
+    if (thread_name) {
+      out << (first ? "" : ",") << std::endl
+        << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1"
+        << ", \"tid\": " << buffer->thread
+        << ", \"args\": {\"name\": \"" << thread_name << "\"}}";
+      first = false;
+    }
+
+    size_t size = buffer->size.load(std::memory_order_acquire);
+    for (size_t i = 0; i < size; ++i)
+    {
+      const Event& event = buffer->events[i];
+      out << (first ? "" : ",") << std::endl
+        << "  {\"name\": \"" << event.name << "\", \"ph\": \"X\""
+        << ", \"pid\": 1, \"tid\": " << buffer->thread << ", \"ts\": ";
+      write_microseconds(out, event.start);
+      out << ", \"dur\": ";
+      write_microseconds(out, event.duration);
+      out << "}";
+      first = false;
+    }
+
+    num_dropped += buffer->num_dropped.load();
+  }
+
+  out << std::endl << "], \"displayTimeUnit\": \"ns\""
+    << ", \"otherData\": {\"dropped_spans\": " << num_dropped << "}}"
+    << std::endl;
+}
+
+
+Trace::ThreadBuffer& Trace::getThreadBuffer()
+{
+  if (thread_buffer_) { return *thread_buffer_; }
+
+  std::lock_guard<std::mutex> lock (buffers_mutex_);
+  buffers_.emplace_back(new ThreadBuffer());
+
+  thread_buffer_ = buffers_.back().get();
+  thread_buffer_->size = 0;
+  thread_buffer_->num_dropped = 0;
+  thread_buffer_->name = nullptr;
+  thread_buffer_->thread = buffers_.size();
+
+  return *thread_buffer_;
+}
+
+
+/***********************************
+ * HELPER FUNCTION IMPLEMENTATIONS *
+ ***********************************/
+
+void write_microseconds(std::ostream& out, std::uint64_t ns)
+{
+  out << ns / 1000 << "." << std::setfill('0') << std::setw(3) << ns % 1000
+    << std::setfill(' ');
+}
@@ -0,0 +1,217 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <vector>
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * A timeline of what every thread was doing, kept as spans that can be saved
+ * in the Chrome trace format and opened in a trace viewer. Each thread keeps
+ * its own buffer, so adding a span never locks, and only the first span on a
+ * thread allocates.
+ *
+ * Spans are only compiled in when DICEFEUD_TRACING is defined; otherwise they
+ * are empty and cost nothing. Even then, nothing is kept until the trace is
+ * enabled.
+ */
+class Trace
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    /**
+     * Adds a span from when it is made to when it goes out of scope.
+     */
+    class Span
+    {
+
+      public:
+
+#ifdef DICEFEUD_TRACING
+        /**
+         * @param {const char*} name What the span is called. It must outlive
+         * the trace, such as a string literal.
+         */
+        Span(const char* name)
+          : name_(name)
+          , recording_(Trace::get().isEnabled())
+          , start_(recording_ ? Trace::now() : 0)
+        { }
+
+        ~Span()
+        {
+          if (recording_) { Trace::get().record(name_, start_, Trace::now()); }
+        }
+
+      private:
+
+        const char* name_;
+        bool recording_;
+        std::uint64_t start_;
+#else
+        Span(const char*) { }
+#endif
+
+    };
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    /**
+     * Returns the trace for the whole program.
+     *
+     * @returns {Trace&} The trace.
+     */
+    static Trace& get();
+
+    /**
+     * Returns whether spans were compiled in, so there can be a trace at all.
+     *
+     * @returns {bool} True if DICEFEUD_TRACING was defined.
+     */
+    static bool isCompiledIn()
+    {
+#ifdef DICEFEUD_TRACING
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    bool isEnabled() const
+    {
+      return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Returns how long it has been since the trace started.
+     *
+     * @returns {std::uint64_t} The time, in nanoseconds.
+     */
+    static std::uint64_t now();
+
+
+    /*** SETTERS ***/
+
+    /**
+     * Starts keeping spans.
+     */
+    void enable() { enabled_ = true; }
+
+    /**
+     * Names the calling thread in the trace.
+     *
+     * @param {const char*} name What the thread is called. It must outlive the
+     * trace, such as a string literal.
+     */
+    void nameThread(const char* name);
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Adds a span on the calling thread. Spans past what the thread's buffer
+     * holds are dropped, and counted.
+     *
+     * @param {const char*} name What the span is called.
+     * @param {std::uint64_t} start When it started, in nanoseconds.
+     * @param {std::uint64_t} end When it ended, in nanoseconds.
+     */
+    void record(const char* name, std::uint64_t start, std::uint64_t end);
+
+    /**
+     * Writes every span in the Chrome trace format. Threads may keep adding
+     * spans in the meantime; those are left out.
+     *
+     * @param {std::ostream&} out Where to write.
+     */
+    void writeJson(std::ostream& out) const;
+
+
+  private:
+
+    /*********
+     * TYPES *
+     *********/
+
+    struct Event
+    {
+      const char* name;
+      std::uint64_t start, duration;
+    };
+
+    /**
+     * The spans of one thread. Only that thread adds to it, and it publishes
+     * how many there are after writing each one, so others can read them.
+     */
+    struct ThreadBuffer
+    {
+      static const size_t CAPACITY = 1 << 18;
+
+      std::array<Event, CAPACITY> events;
+      std::atomic<size_t> size;
+      std::atomic<std::uint64_t> num_dropped;
+      std::atomic<const char*> name;
+      size_t thread;
+    };
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    Trace() = default;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Returns the calling thread's buffer, making it on the thread's first
+     * span.
+     *
+     * @returns {ThreadBuffer&} The buffer.
+     */
+    ThreadBuffer& getThreadBuffer();
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    std::atomic<bool> enabled_ { false };
+
+    // Every thread's buffer, kept until the program ends since the trace is
+    // written after most threads are gone
+    mutable std::mutex buffers_mutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers_;
+
+    static thread_local ThreadBuffer* thread_buffer_;
+
+};
+
+#endif
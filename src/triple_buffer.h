@@ -0,0 +1,115 @@
+#ifndef TRIPLE_BUFFER_H
+#define TRIPLE_BUFFER_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <array>
+#include <atomic>
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Hands the latest version of a value from exactly one writer thread to
+ * exactly one reader thread without either of them ever waiting on the other.
+ *
+ * The writer fills in the back buffer and publishes it, which swaps it with the
+ * middle buffer. The reader swaps the middle buffer with its front buffer
+ * whenever something new was published. Values published while the reader is
+ * busy are simply replaced by newer ones.
+ */
+template <typename T>
+class TripleBuffer
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    TripleBuffer() : middle_(2) { }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** WRITER ***/
+
+    /**
+     * Returns the buffer the writer may fill in. Its contents are whatever was
+     * last swapped out by the reader, so it has to be completely overwritten.
+     *
+     * @returns {T&} The back buffer.
+     */
+    T& getWriteBuffer() { return buffers_[back_]; }
+
+    /**
+     * Makes the back buffer available to the reader.
+     */
+    void publish()
+    {
+      unsigned previous =
+        middle_.exchange(back_ | FRESH, std::memory_order_acq_rel);
+      back_ = previous & INDEX;
+    }
+
+
+    /*** READER ***/
+
+    /**
+     * Takes the most recently published buffer, if there is one.
+     *
+     * @returns {bool} True if the front buffer changed.
+     */
+    bool update()
+    {
+      if ((middle_.load(std::memory_order_relaxed) & FRESH) == 0) {
+        return false;
+      }
+
+      unsigned previous = middle_.exchange(front_, std::memory_order_acq_rel);
+      front_ = previous & INDEX;
+
+      return true;
+    }
+
+    /**
+     * Returns the buffer the reader may look at until its next update.
+     *
+     * @returns {const T&} The front buffer.
+     */
+    const T& getReadBuffer() const { return buffers_[front_]; }
+
+
+  private:
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const unsigned INDEX = 3;
+    static const unsigned FRESH = 4;
+
+    std::array<T, 3> buffers_;
+
+    // Only touched by the writer
+    unsigned back_ = 0;
+
+    // Only touched by the reader
+    unsigned front_ = 1;
+
+    // The buffer waiting in between, and whether the reader has seen it yet
+    std::atomic<unsigned> middle_;
+
+};
+
+#endif
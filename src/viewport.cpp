@@ -0,0 +1,164 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include "viewport.h"
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+Viewport::Viewport(size_t map_width, size_t map_height)
+  : map_width_(map_width)
+  , map_height_(map_height)
+{ }
+
+
+size_t Viewport::getWidth() const
+{
+  size_t zoomed_width = (map_width_ + zoom_ - 1) / zoom_;
+
+  return std::min(screen_width_, zoomed_width);
+}
+
+
+size_t Viewport::getHeight() const
+{
+  size_t zoomed_height = (map_height_ + zoom_ - 1) / zoom_;
+
+  return std::min(screen_height_, zoomed_height);
+}
+
+
+void Viewport::resize(size_t screen_width, size_t screen_height)
+{
+  screen_width_ = screen_width;
+  screen_height_ = screen_height;
+
+  clamp();
+}
+
+
+bool Viewport::pan(long dx, long dy)
+{
+  size_t old_x = x_, old_y = y_;
+
+  // Panning is done in screen characters, so scale it to map cells.
+  long new_x = static_cast<long> (x_) + dx * static_cast<long> (zoom_);
+  long new_y = static_cast<long> (y_) + dy * static_cast<long> (zoom_);
+
+  x_ = static_cast<size_t> (std::max(new_x, 0L));
+  y_ = static_cast<size_t> (std::max(new_y, 0L));
+  clamp();
+
+  return x_ != old_x || y_ != old_y;
+}
+
+
+bool Viewport::zoomIn()
+{
+  if (zoom_ == 1) { return false; }
+
+  // Keep the middle of the screen where it is
+  size_t mid_x = x_ + getWidth() * zoom_ / 2;
+  size_t mid_y = y_ + getHeight() * zoom_ / 2;
+
+  --zoom_;
+
+  x_ = mid_x - std::min(mid_x, getWidth() * zoom_ / 2);
+  y_ = mid_y - std::min(mid_y, getHeight() * zoom_ / 2);
+  clamp();
+
+  return true;
+}
+
+
+bool Viewport::zoomOut()
+{
+  if (zoom_ == MAX_ZOOM) { return false; }
+
+  // Zooming out further than it takes to fit the whole map does nothing
+  if (getWidth() * zoom_ >= map_width_ && getHeight() * zoom_ >= map_height_) {
+    return false;
+  }
+
+  size_t mid_x = x_ + getWidth() * zoom_ / 2;
+  size_t mid_y = y_ + getHeight() * zoom_ / 2;
+
+  ++zoom_;
+
+  x_ = mid_x - std::min(mid_x, getWidth() * zoom_ / 2);
+  y_ = mid_y - std::min(mid_y, getHeight() * zoom_ / 2);
+  clamp();
+
+  return true;
+}
+
+
+bool Viewport::centerOn(Tile::coord_t coord)
+{
+  size_t col, row;
+  if (mapToScreen(coord, col, row)) { return false; }
+
+  size_t map_x = coord % map_width_;
+  size_t map_y = coord / map_width_;
+  size_t half_width = getWidth() * zoom_ / 2;
+  size_t half_height = getHeight() * zoom_ / 2;
+
+  x_ = map_x - std::min(map_x, half_width);
+  y_ = map_y - std::min(map_y, half_height);
+  clamp();
+
+  return true;
+}
+
+
+bool Viewport::mapToScreen(
+  Tile::coord_t coord
+  , size_t& col
+  , size_t& row)
+  const
+{
+  size_t map_x = coord % map_width_;
+  size_t map_y = coord / map_width_;
+
+  if (map_x < x_ || map_y < y_) { return false; }
+
+  col = (map_x - x_) / zoom_;
+  row = (map_y - y_) / zoom_;
+
+  return col < getWidth() && row < getHeight();
+}
+
+
+bool Viewport::screenToMap(
+  size_t col
+  , size_t row
+  , Tile::coord_t& coord)
+  const
+{
+  size_t map_x = x_ + col * zoom_;
+  size_t map_y = y_ + row * zoom_;
+
+  if (map_x >= map_width_ || map_y >= map_height_) { return false; }
+
+  coord = map_y * map_width_ + map_x;
+
+  return true;
+}
+
+
+void Viewport::clamp()
+{
+  size_t shown_width = getWidth() * zoom_;
+  size_t shown_height = getHeight() * zoom_;
+
+  size_t max_x = map_width_ - std::min(map_width_, shown_width);
+  size_t max_y = map_height_ - std::min(map_height_, shown_height);
+
+  x_ = std::min(x_, max_x);
+  y_ = std::min(y_, max_y);
+}
@@ -0,0 +1,177 @@
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstddef>
+#include "tile.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * A camera over the game board. The board is measured in map cells, the screen
+ * in character cells. At a zoom of 1 every character is exactly one map cell;
+ * at a zoom of n every character summarizes an n-by-n block of map cells.
+ */
+class Viewport
+{
+
+  public:
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    Viewport(size_t map_width = 0, size_t map_height = 0);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** GETTERS ***/
+
+    /**
+     * Returns the map column shown in the leftmost screen column.
+     *
+     * @returns {size_t} The map x-value of the upper left-hand corner.
+     */
+    size_t getX() const { return x_; }
+
+    /**
+     * Returns the map row shown in the topmost screen row.
+     *
+     * @returns {size_t} The map y-value of the upper left-hand corner.
+     */
+    size_t getY() const { return y_; }
+
+    /**
+     * Returns how many screen columns the visible part of the map takes up.
+     *
+     * @returns {size_t} The width of the viewport in characters.
+     */
+    size_t getWidth() const;
+
+    /**
+     * Returns how many screen rows the visible part of the map takes up.
+     *
+     * @returns {size_t} The height of the viewport in characters.
+     */
+    size_t getHeight() const;
+
+    /**
+     * Returns the number of map cells along each side of a screen character.
+     *
+     * @returns {size_t} The current zoom level.
+     */
+    size_t getZoom() const { return zoom_; }
+
+    size_t getMapWidth() const { return map_width_; }
+    size_t getMapHeight() const { return map_height_; }
+
+
+    /*** MUTATORS ***/
+
+    /**
+     * Sets the amount of screen space available to the viewport. The camera is
+     * moved back onto the map if the new size would show past its edges.
+     *
+     * @param {size_t} screen_width The available width in characters.
+     * @param {size_t} screen_height The available height in characters.
+     */
+    void resize(size_t screen_width, size_t screen_height);
+
+    /**
+     * Moves the camera by the given number of screen characters.
+     *
+     * @param {long} dx Characters to move right (negative for left).
+     * @param {long} dy Characters to move down (negative for up).
+     * @returns {bool} True if the camera actually moved.
+     */
+    bool pan(long dx, long dy);
+
+    /**
+     * Shows more detail, down to one map cell per character.
+     *
+     * @returns {bool} True if the zoom level changed.
+     */
+    bool zoomIn();
+
+    /**
+     * Summarizes more of the map per character, up to MAX_ZOOM.
+     *
+     * @returns {bool} True if the zoom level changed.
+     */
+    bool zoomOut();
+
+    /**
+     * Moves the camera so that the given coordinate is in the middle of the
+     * screen, unless it is already visible.
+     *
+     * @param {Tile::coord_t} coord The map coordinate to show.
+     * @returns {bool} True if the camera moved.
+     */
+    bool centerOn(Tile::coord_t coord);
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Finds where on the viewport a map coordinate is drawn.
+     *
+     * @param {Tile::coord_t} coord The map coordinate.
+     * @param {size_t&} col Where the viewport column is stored.
+     * @param {size_t&} row Where the viewport row is stored.
+     * @returns {bool} False if the coordinate is not visible.
+     */
+    bool mapToScreen(Tile::coord_t coord, size_t& col, size_t& row) const;
+
+    /**
+     * Finds the map coordinate drawn at the upper left-hand corner of a
+     * viewport character.
+     *
+     * @param {size_t} col The viewport column.
+     * @param {size_t} row The viewport row.
+     * @param {Tile::coord_t&} coord Where the map coordinate is stored.
+     * @returns {bool} False if the character does not show any of the map.
+     */
+    bool screenToMap(size_t col, size_t row, Tile::coord_t& coord) const;
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const size_t MAX_ZOOM = 8;
+
+
+  private:
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Keeps the camera from showing anything past the right or bottom edges of
+     * the map.
+     */
+    void clamp();
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    size_t map_width_, map_height_;
+    size_t screen_width_ = 0, screen_height_ = 0;
+    size_t x_ = 0, y_ = 0;
+    size_t zoom_ = 1;
+
+};
+
+#endif
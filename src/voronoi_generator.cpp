@@ -0,0 +1,399 @@
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include "voronoi_generator.h"
+
+
+/*******************************
+ * STATIC PROPERTY DEFINITIONS *
+ *******************************/
+
+const VoronoiGenerator::region_t VoronoiGenerator::NO_REGION =
+  std::numeric_limits<VoronoiGenerator::region_t>::max();
+
+// Sizes stop evening out much after a few rounds
+const size_t VoronoiGenerator::DEFAULT_RELAXATIONS = 5;
+
+
+/*******************
+ * IMPLEMENTATIONS *
+ *******************/
+
+VoronoiGenerator::VoronoiGenerator(
+  size_t width
+  , size_t height
+  , size_t min_tile_size
+  , size_t max_tile_size)
+  : width_(width)
+  , height_(height)
+  , min_tile_size_(std::max<size_t>(min_tile_size, 1))
+  , max_tile_size_(std::max(max_tile_size, min_tile_size_))
+  , relaxations_(DEFAULT_RELAXATIONS)
+{ }
+
+
+size_t VoronoiGenerator::generate(
+  std::mt19937& rng
+  , std::vector<tile_id_t>& cells
+  , std::vector<border_t>& borders) const
+{
+  size_t num_spaces = width_ * height_;
+
+  // As many sites as fit at the largest size, since regions that grow too
+  // large are cut short and regions that stay too small are thrown away
+  size_t num_sites = std::max<size_t>(num_spaces / max_tile_size_, 1);
+
+  // Pick the sites from a partial shuffle of every space
+  std::vector<size_t> spaces (num_spaces);
+  for (size_t space = 0; space < num_spaces; ++space)
+  {
+    spaces[space] = space;
+  }
+  for (size_t i = 0; i < num_sites; ++i)
+  {
+    std::uniform_int_distribution<size_t> pick (i, num_spaces - 1);
+    std::swap(spaces[i], spaces[pick(rng)]);
+  }
+  std::vector<size_t> sites (
+    std::begin(spaces)
+    , std::begin(spaces) + num_sites);
+
+  std::vector<region_t> regions;
+  std::vector<std::vector<size_t>> members;
+
+  // Regions are only held to the largest size once the sites have settled
+  for (size_t i = 0; ; ++i)
+  {
+    bool last = i == relaxations_;
+    assign(
+      sites
+      , last ? max_tile_size_ : std::numeric_limits<size_t>::max()
+      , regions
+      , members);
+
+    if (last) { break; }
+    relax(members, sites);
+  }
+
+  merge(regions, members);
+
+  // Merging loses tiles, and the empty spaces left where regions were cut
+  // short or thrown away have room for some more
+  size_t num_regions = 0;
+  for (const std::vector<size_t>& spaces : members)
+  {
+    if (!spaces.empty()) { ++num_regions; }
+  }
+  reseed(num_regions, num_sites, regions, members);
+
+  connect(regions, members);
+
+  // Number the tiles in the order they are first seen, finding the borders in
+  // the same pass
+  std::vector<region_t> ids (members.size(), NO_REGION);
+  size_t num_tiles = 0;
+  cells.assign(num_spaces, TileGrid::NO_TILE);
+  borders.clear();
+
+  for (size_t space = 0; space < num_spaces; ++space)
+  {
+    region_t region = regions[space];
+    if (region == NO_REGION) { continue; }
+
+    if (ids[region] == NO_REGION) {
+      if (num_tiles == TileGrid::NO_TILE) {
+        throw std::length_error("Board has too many tiles to number.");
+      }
+      ids[region] = static_cast<region_t> (num_tiles++);
+    }
+    cells[space] = static_cast<tile_id_t> (ids[region]);
+
+    // Spaces up and to the left have already been numbered
+    if (space % width_ > 0 && cells[space - 1] != TileGrid::NO_TILE
+        && cells[space - 1] != cells[space]) {
+      borders.push_back(std::make_pair(cells[space - 1], cells[space]));
+    }
+    if (space >= width_ && cells[space - width_] != TileGrid::NO_TILE
+        && cells[space - width_] != cells[space]) {
+      borders.push_back(std::make_pair(cells[space - width_], cells[space]));
+    }
+  }
+
+  return num_tiles;
+}
+
+
+void VoronoiGenerator::assign(
+  const std::vector<size_t>& sites
+  , size_t capacity
+  , std::vector<region_t>& regions
+  , std::vector<std::vector<size_t>>& members) const
+{
+  std::vector<size_t> claimed (sites.size(), 1);
+  regions.assign(width_ * height_, NO_REGION);
+  members.assign(sites.size(), std::vector<size_t>());
+
+  // Every space is reached from the site that reaches it first, so the order
+  // of the queue is also the order of distance from each space's own site
+  std::vector<size_t> queue;
+  queue.reserve(width_ * height_);
+  for (region_t region = 0; region < sites.size(); ++region)
+  {
+    regions[sites[region]] = region;
+    queue.push_back(sites[region]);
+  }
+
+  for (size_t next = 0; next < queue.size(); ++next)
+  {
+    size_t space = queue[next];
+    region_t region = regions[space];
+    members[region].push_back(space);
+
+    forEachNeighbor(space, [&](size_t neighbor)
+    {
+      if (regions[neighbor] == NO_REGION && claimed[region] < capacity) {
+        regions[neighbor] = region;
+        ++claimed[region];
+        queue.push_back(neighbor);
+      }
+    });
+  }
+}
+
+
+void VoronoiGenerator::merge(
+  std::vector<region_t>& regions
+  , std::vector<std::vector<size_t>>& members) const
+{
+  // Smallest first, so the smallest neighbor has the most room left
+  std::vector<region_t> small;
+  for (region_t region = 0; region < members.size(); ++region)
+  {
+    if (members[region].size() < min_tile_size_) { small.push_back(region); }
+  }
+  std::sort(
+    std::begin(small)
+    , std::end(small)
+    , [&](region_t a, region_t b)
+    {
+      return members[a].size() > members[b].size();
+    });
+
+  while (!small.empty())
+  {
+    region_t region = small.back();
+    small.pop_back();
+    if (members[region].empty()
+        || members[region].size() >= min_tile_size_) {
+      continue;
+    }
+
+    region_t into = NO_REGION;
+    for (size_t space : members[region])
+    {
+      forEachNeighbor(space, [&](size_t neighbor)
+      {
+        region_t other = regions[neighbor];
+        if (other == NO_REGION || other == region) { return; }
+        if (members[other].size() + members[region].size() > max_tile_size_) {
+          return;
+        }
+        if (into == NO_REGION
+            || members[other].size() < members[into].size()) {
+          into = other;
+        }
+      });
+    }
+
+    for (size_t space : members[region])
+    {
+      regions[space] = into;
+    }
+    if (into != NO_REGION) {
+      members[into].insert(
+        std::end(members[into])
+        , std::begin(members[region])
+        , std::end(members[region]));
+
+      // It may still be too small, in which case it gets another go
+      if (members[into].size() < min_tile_size_) { small.push_back(into); }
+    }
+    members[region].clear();
+  }
+}
+
+
+void VoronoiGenerator::connect(
+  std::vector<region_t>& regions
+  , std::vector<std::vector<size_t>>& members) const
+{
+  size_t num_spaces = width_ * height_;
+  std::vector<std::uint8_t> seen;
+  std::vector<size_t> open;
+  open.reserve(num_spaces);
+  std::vector<std::pair<size_t, region_t>> layer;
+
+  for (;;)
+  {
+    // Every region is in one piece, so the tiles are connected if the spaces
+    // that have one are
+    seen.assign(num_spaces, 0);
+    size_t num_claimed = 0, num_reached = 0;
+    for (size_t space = 0; space < num_spaces; ++space)
+    {
+      if (regions[space] == NO_REGION) { continue; }
+
+      if (num_claimed++ == 0) {
+        seen[space] = 1;
+        open.push_back(space);
+      }
+    }
+    while (!open.empty())
+    {
+      size_t space = open.back();
+      open.pop_back();
+      ++num_reached;
+
+      forEachNeighbor(space, [&](size_t neighbor)
+      {
+        if (!seen[neighbor] && regions[neighbor] != NO_REGION) {
+          seen[neighbor] = 1;
+          open.push_back(neighbor);
+        }
+      });
+    }
+    if (num_reached == num_claimed) { return; }
+
+    // Otherwise every region grows by a space all round, into the smallest
+    // region next to each empty space, which closes the narrow gaps first
+    layer.clear();
+    for (size_t space = 0; space < num_spaces; ++space)
+    {
+      if (regions[space] != NO_REGION) { continue; }
+
+      region_t into = NO_REGION;
+      forEachNeighbor(space, [&](size_t neighbor)
+      {
+        region_t other = regions[neighbor];
+        if (other != NO_REGION
+            && (into == NO_REGION
+              || members[other].size() < members[into].size())) {
+          into = other;
+        }
+      });
+      if (into != NO_REGION) { layer.push_back(std::make_pair(space, into)); }
+    }
+    for (const std::pair<size_t, region_t>& grown : layer)
+    {
+      regions[grown.first] = grown.second;
+      members[grown.second].push_back(grown.first);
+    }
+  }
+}
+
+
+void VoronoiGenerator::reseed(
+  size_t num_regions
+  , size_t num_sites
+  , std::vector<region_t>& regions
+  , std::vector<std::vector<size_t>>& members) const
+{
+  // Empty spaces in order of how far they are from every region
+  std::vector<size_t> queue;
+  queue.reserve(regions.size());
+  std::vector<std::uint8_t> seen (regions.size(), 0);
+  for (size_t space = 0; space < regions.size(); ++space)
+  {
+    if (regions[space] != NO_REGION) {
+      seen[space] = 1;
+      queue.push_back(space);
+    }
+  }
+  size_t num_claimed = queue.size();
+  for (size_t next = 0; next < queue.size(); ++next)
+  {
+    forEachNeighbor(queue[next], [&](size_t neighbor)
+    {
+      if (!seen[neighbor]) {
+        seen[neighbor] = 1;
+        queue.push_back(neighbor);
+      }
+    });
+  }
+
+  // New sites go farthest out first, each growing into the empty spaces
+  // nearest it as far as a region may. One that stays too small had no room,
+  // so none of the spaces it reached are tried again.
+  const region_t tried = static_cast<region_t> (NO_REGION - 1);
+  std::vector<size_t> spaces;
+  for (size_t i = queue.size(); i > num_claimed && num_regions < num_sites
+      ; --i)
+  {
+    size_t site = queue[i - 1];
+    if (regions[site] != NO_REGION) { continue; }
+
+    region_t region = static_cast<region_t> (members.size());
+    spaces.assign(1, site);
+    regions[site] = region;
+    for (size_t next = 0; next < spaces.size(); ++next)
+    {
+      forEachNeighbor(spaces[next], [&](size_t neighbor)
+      {
+        if (regions[neighbor] == NO_REGION
+            && spaces.size() < max_tile_size_) {
+          regions[neighbor] = region;
+          spaces.push_back(neighbor);
+        }
+      });
+    }
+
+    if (spaces.size() < min_tile_size_) {
+      for (size_t space : spaces)
+      {
+        regions[space] = tried;
+      }
+      continue;
+    }
+
+    members.push_back(spaces);
+    ++num_regions;
+  }
+
+  for (region_t& region : regions)
+  {
+    if (region == tried) { region = NO_REGION; }
+  }
+}
+
+
+void VoronoiGenerator::relax(
+  const std::vector<std::vector<size_t>>& members
+  , std::vector<size_t>& sites) const
+{
+  for (size_t region = 0; region < members.size(); ++region)
+  {
+    double sum_x = 0, sum_y = 0;
+    for (size_t space : members[region])
+    {
+      sum_x += space % width_;
+      sum_y += space / width_;
+    }
+    double x = sum_x / members[region].size();
+    double y = sum_y / members[region].size();
+
+    double best = std::numeric_limits<double>::max();
+    for (size_t space : members[region])
+    {
+      double dx = space % width_ - x, dy = space / width_ - y;
+      if (dx * dx + dy * dy < best) {
+        best = dx * dx + dy * dy;
+        sites[region] = space;
+      }
+    }
+  }
+}
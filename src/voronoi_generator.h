@@ -0,0 +1,200 @@
+#ifndef VORONOI_GENERATOR_H
+#define VORONOI_GENERATOR_H
+
+/************
+ * INCLUDES *
+ ************/
+
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+#include "tile_grid.h"
+
+
+/*********
+ * CLASS *
+ *********/
+
+/**
+ * Divides a board into tiles by scattering sites over it and giving every
+ * space to the nearest site, found with one breadth-first search from all the
+ * sites at once. A few rounds of Lloyd relaxation move each site to the middle
+ * of its region to even out their sizes. The last search stops regions from
+ * growing past the largest size, and regions left too small are merged into a
+ * neighbor with room or left empty. New regions are started in the empty
+ * spaces to make up for the ones lost, and if the regions have still come
+ * apart, they grow into the gaps between them until they meet, so every tile
+ * can reach every other. Each step costs about as much as there are spaces,
+ * so unlike the random walk, how long a board takes never depends on luck.
+ */
+class VoronoiGenerator
+{
+
+  public:
+
+    /*********
+     * TYPES *
+     *********/
+
+    using tile_id_t = TileGrid::tile_id_t;
+    using border_t = std::pair<tile_id_t, tile_id_t>;
+
+
+    /****************
+     * CONSTRUCTORS *
+     ****************/
+
+    /**
+     * @param {size_t} width The width of the board.
+     * @param {size_t} height The height of the board.
+     * @param {size_t} min_tile_size The fewest spaces a tile may have.
+     * @param {size_t} max_tile_size The most spaces a tile may have.
+     */
+    VoronoiGenerator(
+      size_t width
+      , size_t height
+      , size_t min_tile_size
+      , size_t max_tile_size);
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /*** SETTERS ***/
+
+    void setRelaxations(size_t relaxations) { relaxations_ = relaxations; }
+
+
+    /*** UTILITY ***/
+
+    /**
+     * Generates the tiles of a board.
+     *
+     * @param {std::mt19937&} rng Places the sites.
+     * @param {std::vector<tile_id_t>&} cells Where the tile of every space is
+     * stored, or TileGrid::NO_TILE for spaces without one.
+     * @param {std::vector<border_t>&} borders Where every pair of tiles that
+     * touch is stored, once each, found while numbering the tiles.
+     * @returns {size_t} How many tiles there are.
+     */
+    size_t generate(
+      std::mt19937& rng
+      , std::vector<tile_id_t>& cells
+      , std::vector<border_t>& borders) const;
+
+
+  private:
+
+    /*********
+     * TYPES *
+     *********/
+
+    using region_t = std::uint32_t;
+
+
+    /***********
+     * METHODS *
+     ***********/
+
+    /**
+     * Gives every space to its nearest site that still has room.
+     *
+     * @param {std::vector<size_t>} sites Where each region starts.
+     * @param {size_t} capacity The most spaces a region may take. Spaces
+     * that every nearby region is too full for are left empty.
+     * @param {std::vector<region_t>&} regions Where the region of every space
+     * is stored.
+     * @param {std::vector<std::vector<size_t>>&} members Where the spaces of
+     * every region are stored, nearest to the site first.
+     */
+    void assign(
+      const std::vector<size_t>& sites
+      , size_t capacity
+      , std::vector<region_t>& regions
+      , std::vector<std::vector<size_t>>& members) const;
+
+    /**
+     * Merges regions that are too small into their smallest neighbor that
+     * has room, smallest first, or leaves their spaces empty.
+     *
+     * @param {std::vector<region_t>&} regions The region of every space.
+     * @param {std::vector<std::vector<size_t>>&} members The spaces of every
+     * region. Regions merged away are left empty.
+     */
+    void merge(
+      std::vector<region_t>& regions
+      , std::vector<std::vector<size_t>>& members) const;
+
+    /**
+     * Grows every region into the empty spaces around it, a space at a time,
+     * until the regions all reach each other. Most empty spaces are kept,
+     * since regions are only ever cut off by narrow gaps.
+     *
+     * @param {std::vector<region_t>&} regions The region of every space.
+     * @param {std::vector<std::vector<size_t>>&} members The spaces of every
+     * region.
+     */
+    void connect(
+      std::vector<region_t>& regions
+      , std::vector<std::vector<size_t>>& members) const;
+
+    /**
+     * Starts new regions in the empty spaces, farthest from every region
+     * first, each growing as far as a region may, until there are enough.
+     *
+     * @param {size_t} num_regions How many regions there are.
+     * @param {size_t} num_sites How many regions there should be.
+     * @param {std::vector<region_t>&} regions The region of every space.
+     * @param {std::vector<std::vector<size_t>>&} members The spaces of every
+     * region. New regions are added to the end.
+     */
+    void reseed(
+      size_t num_regions
+      , size_t num_sites
+      , std::vector<region_t>& regions
+      , std::vector<std::vector<size_t>>& members) const;
+
+    /**
+     * Moves every site to the space of its region closest to its centroid.
+     *
+     * @param {std::vector<std::vector<size_t>>} members The spaces of every
+     * region.
+     * @param {std::vector<size_t>&} sites The sites, updated.
+     */
+    void relax(
+      const std::vector<std::vector<size_t>>& members
+      , std::vector<size_t>& sites) const;
+
+    /**
+     * Calls a function with every space next to a space.
+     *
+     * @param {size_t} space The space.
+     * @param {Function} f Called with each neighboring space.
+     */
+    template <typename Function>
+    void forEachNeighbor(size_t space, Function f) const
+    {
+      size_t x = space % width_;
+      if (x > 0) { f(space - 1); }
+      if (x + 1 < width_) { f(space + 1); }
+      if (space >= width_) { f(space - width_); }
+      if (space + width_ < width_ * height_) { f(space + width_); }
+    }
+
+
+    /**************
+     * PROPERTIES *
+     **************/
+
+    static const region_t NO_REGION;
+    static const size_t DEFAULT_RELAXATIONS;
+
+    size_t width_, height_;
+    size_t min_tile_size_, max_tile_size_;
+    size_t relaxations_;
+
+};
+
+#endif